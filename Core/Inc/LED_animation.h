@@ -0,0 +1,52 @@
+/**
+ *******************************************************************************
+ * @file LED_animation.h
+ * @brief Declarations for LED_animation.c
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#ifndef LED_ANIMATION_H
+#define LED_ANIMATION_H
+
+#include <stdint.h>
+
+#define ANIMATION_QUEUE_LENGTH 8			///< Sequences that can be pending.
+#define ANIMATION_LEVEL_SHIFT 15			///< Fraction bits of a level.
+#define ANIMATION_LEVEL_OFF 0				///< Colour fully off.
+#define ANIMATION_LEVEL_FULL (1 << ANIMATION_LEVEL_SHIFT)	///< Fully on.
+#define ANIMATION_LEVEL_LIVE 0xFFFF			///< Colour keeps its live value.
+
+/**
+ * @brief One step of an animation.
+ */
+typedef struct {
+	uint16_t levels[3];		///< On-time per colour (R, G, B), Q15 or LIVE.
+	uint16_t duration;		///< Time the step is shown for in ms.
+} AnimationKeyframe;
+
+/**
+ * @brief A fixed sequence of keyframes.
+ */
+typedef struct {
+	const AnimationKeyframe *keyframes;		///< The steps in order.
+	uint8_t length;							///< Number of steps.
+} AnimationSequence;
+
+extern const AnimationSequence single_pulse_animation;
+extern const AnimationSequence double_pulse_animation;
+extern const AnimationSequence long_pulse_animation;
+extern const AnimationSequence red_single_pulse_animation;
+extern const AnimationSequence red_double_pulse_animation;
+extern const AnimationSequence red_long_pulse_animation;
+extern const AnimationSequence notification_pause_animation;
+
+uint8_t play_animation(const AnimationSequence *sequence);
+uint8_t advance_animation(uint32_t now, uint32_t pulse_values[3]);
+uint8_t animation_running(void);
+void service_animation(void);
+void wait_for_animation(void);
+
+#endif /* LED_ANIMATION_H */
@@ -0,0 +1,59 @@
+/**
+ *******************************************************************************
+ * @file LED_bcm.h
+ * @brief Declarations for LED_bcm.c
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#ifndef LED_BCM_H
+#define LED_BCM_H
+
+#include <stdint.h>
+#include "globals.h"
+#include "LED_pwm.h"
+
+#define BCM_BITS 5						///< Bit-planes per cycle (4 to 6).
+#define BCM_MAX_LEVEL ((1 << BCM_BITS) - 1)	///< Maximum per-LED intensity.
+#define BCM_MIN_CYCLE_RATE 100			///< Slowest allowed cycle in Hz.
+#define BCM_PWM_PROFILE PWM_PROFILE_FAST	///< Profile to run BCM under.
+
+/**
+ * @brief BLANK PWM periods spent on the least significant bit-plane.
+ *
+ * Every plane lasts a whole number of PWM periods, so each one sees the same
+ * BLANK duty whatever its phase. At BCM_PWM_PROFILE (16 kHz) one period gives
+ * a 516 Hz cycle at 5 bits.
+ */
+#define BCM_BASE_PERIODS 1
+
+/**
+ * @brief Represents the outcome of starting the BCM engine.
+ */
+typedef enum {
+	BCM_OK,					///< The bit-planes are being cycled.
+	BCM_PROFILE_UNSUPPORTED	///< The PWM profile is too slow for BCM.
+} BcmStatus;
+
+extern TIM_HandleTypeDef htim6;
+
+void build_bcm_planes(uint8_t levels[3][NUM_LEDS],
+		uint16_t planes[BCM_BITS][3]);
+void bcm_levels_from_dot_correction(uint8_t dot_correction[3][NUM_LEDS],
+		uint8_t chains, uint8_t levels[3][NUM_LEDS]);
+uint32_t get_bcm_plane_length(uint8_t plane, const PwmProfile *profile);
+uint8_t bcm_profile_supported(const PwmProfile *profile);
+void initialise_bcm(void);
+void set_bcm_levels(uint8_t levels[3][NUM_LEDS]);
+BcmStatus start_bcm(void);
+void stop_bcm(void);
+uint8_t bcm_running(void);
+void hold_bcm(void);
+uint8_t get_bcm_held_masks(uint16_t masks[3]);
+void release_bcm(void);
+uint32_t get_bcm_missed_planes(void);
+void advance_bcm_plane(void);
+
+#endif /* LED_BCM_H */
@@ -12,6 +12,17 @@
 #define LED_DRIVER_CONFIG_H
 
 #include <stdint.h>
+#include "globals.h"
+
+#define LED_MASK_NONE 0x0000	///< Chain word with all 16 LEDs off.
+#define LED_MASK_ALL 0xFFFF		///< Chain word with all 16 LEDs on.
+
+#define DOT_CORRECTION_BITS 7	///< Bits of dot correction per output.
+#define DOT_CORRECTION_MAX ((1 << DOT_CORRECTION_BITS) - 1)
+
+#define LED_CHAIN_RED (1 << 0)		///< Red chain bit in a failed chain set.
+#define LED_CHAIN_GREEN (1 << 1)	///< Green chain bit in a failed chain set.
+#define LED_CHAIN_BLUE (1 << 2)		///< Blue chain bit in a failed chain set.
 
 /**
  * @brief Represents the states of the LED drivers.
@@ -25,5 +36,14 @@ typedef enum {
 } LED_Driver_Status;
 
 LED_Driver_Status initialise_LED_drivers(uint8_t *led_init_config);
+LED_Driver_Status set_LED_masks(uint16_t red_mask, uint16_t green_mask,
+		uint16_t blue_mask);
+void invalidate_LED_masks(void);
+uint8_t get_latched_LED_masks(uint16_t masks[3]);
+void calculate_dot_correction(uint16_t calibration[NUM_LEDS][3],
+		uint8_t dot_correction[3][NUM_LEDS]);
+LED_Driver_Status configure_dot_correction(
+		uint8_t dot_correction[3][NUM_LEDS]);
+uint8_t get_failed_LED_chains(void);
 
 #endif /* LED_DRIVER_CONFIG_H */
@@ -0,0 +1,49 @@
+/**
+ *******************************************************************************
+ * @file LED_fade.h
+ * @brief Declarations for LED_fade.c
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#ifndef LED_FADE_H
+#define LED_FADE_H
+
+#include <stdint.h>
+
+#define FADE_PROGRESS_BITS 24			///< Fractional bits of fade progress.
+#define FADE_PROGRESS_ONE (1UL << FADE_PROGRESS_BITS)	///< A finished fade.
+#define FADE_CURVE_BITS 6				///< log2 of the curve segments.
+#define FADE_CURVE_POINTS ((1 << FADE_CURVE_BITS) + 1)	///< Points per curve.
+#define FADE_CURVE_SHIFT 16				///< Fractional bits of curve points.
+
+/**
+ * @brief Shapes of the progress of a fade over time.
+ */
+typedef enum {
+	FADE_LINEAR,			///< Constant rate.
+	FADE_EASE_IN,			///< Starts slowly (cubic).
+	FADE_EASE_OUT,			///< Ends slowly (cubic).
+	FADE_EASE_IN_OUT,		///< Starts and ends slowly (smoothstep).
+	NUM_FADE_CURVES
+} FadeCurve;
+
+/**
+ * @brief A fade of three Q8 pulse values towards their targets.
+ */
+typedef struct {
+	uint32_t start[3];		///< Q8 pulse values (R, G, B) the fade began at.
+	uint32_t progress;		///< Time through the fade, FADE_PROGRESS_ONE at end.
+	uint32_t step;			///< Progress made per PWM period.
+	FadeCurve curve;		///< Easing applied to the progress.
+	uint8_t running;		///< 1 until the fade reaches its targets.
+} FadeState;
+
+void start_fade(FadeState *fade, const uint32_t start[3], uint32_t steps,
+		FadeCurve curve);
+void advance_fade(FadeState *fade, const uint32_t targets[3], uint32_t limit,
+		uint32_t outputs[3]);
+
+#endif /* LED_FADE_H */
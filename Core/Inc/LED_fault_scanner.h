@@ -0,0 +1,45 @@
+/**
+ *******************************************************************************
+ * @file LED_fault_scanner.h
+ * @brief Declarations for LED_fault_scanner.c
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#ifndef LED_FAULT_SCANNER_H
+#define LED_FAULT_SCANNER_H
+
+#include <stdint.h>
+
+#define FAULT_SCAN_PERIOD 1000			///< Time between scans in ms.
+#define FAULT_SCAN_BITS_PER_SLICE 4		///< Bits clocked per main loop slice.
+#define FAULT_SCAN_WINDOW_TIMEOUT 5		///< Time to find a BLANK window in ms.
+#define FAULT_SCAN_WINDOW_MARGIN 4		///< Time kept clear of an edge in us.
+#define FAULT_HISTORY_LENGTH 8			///< Fault set changes remembered.
+
+/**
+ * @brief Represents whether the LED fault set has changed.
+ */
+typedef enum {
+	FAULTS_UNCHANGED,		///< No change since the last report.
+	FAULTS_CHANGED			///< A scan found a different fault set.
+} LEDFaultFlag;
+
+/**
+ * @brief A change of the LED fault set.
+ */
+typedef struct {
+	uint32_t time;			///< HAL_GetTick() when the change was found.
+	uint16_t lod[3];		///< Open LED words (R, G, B) after the change.
+	uint8_t thermal;		///< LED_CHAIN_x bits with a thermal error.
+} LEDFaultRecord;
+
+void request_led_fault_scan(void);
+void service_led_fault_scan(void);
+uint16_t get_led_fault_count(uint8_t chain, uint8_t led);
+uint8_t get_led_fault_history(LEDFaultRecord history[FAULT_HISTORY_LENGTH]);
+void report_led_faults(void);
+
+#endif /* LED_FAULT_SCANNER_H */
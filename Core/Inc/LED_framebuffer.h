@@ -0,0 +1,44 @@
+/**
+ *******************************************************************************
+ * @file LED_framebuffer.h
+ * @brief Declarations for LED_framebuffer.c
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#ifndef LED_FRAMEBUFFER_H
+#define LED_FRAMEBUFFER_H
+
+#include <stdint.h>
+#include "LED_driver_config.h"
+#include "LED_pwm.h"
+
+#define FRAMEBUFFER_DIRTY_MASKS (1 << 0)	///< On/off words need shifting.
+#define FRAMEBUFFER_DIRTY_PULSES (1 << 1)	///< Pulse values need writing.
+#define FRAMEBUFFER_DIRTY_ALL (FRAMEBUFFER_DIRTY_MASKS | FRAMEBUFFER_DIRTY_PULSES)
+#define FRAMEBUFFER_NO_OVERLAY UINT32_MAX	///< Colour shows its own pulse.
+
+/**
+ * @brief The desired state of every LED.
+ */
+typedef struct {
+	uint16_t masks[3];		///< On/off word per chain (R, G, B).
+	uint8_t levels[3][NUM_LEDS];	///< BCM level of each LED that is on.
+	uint8_t use_levels;		///< 1 to show the levels with BCM.
+	uint32_t pulses[3];		///< Q8 BLANK pulse value per colour (R, G, B).
+	uint32_t overlay[3];	///< Q8 pulse values shown instead (animations).
+	uint8_t dirty;			///< FRAMEBUFFER_DIRTY_x bits not yet flushed.
+} LEDFramebuffer;
+
+void framebuffer_set_masks(uint16_t red_mask, uint16_t green_mask,
+		uint16_t blue_mask);
+void framebuffer_set_levels(uint8_t levels[3][NUM_LEDS]);
+void framebuffer_set_pulses(uint16_t *pulse_values);
+void framebuffer_set_pulses_q8(uint32_t *pulse_values);
+void framebuffer_set_overlay(uint32_t *pulse_values);
+void framebuffer_set_pwm_profile(PwmProfileId profile);
+LED_Driver_Status flush_framebuffer(void);
+
+#endif /* LED_FRAMEBUFFER_H */
@@ -0,0 +1,127 @@
+/**
+ *******************************************************************************
+ * @file LED_pwm.h
+ * @brief Declarations for LED_pwm.c
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#ifndef LED_PWM_H
+#define LED_PWM_H
+
+#include <stdint.h>
+#include "stm32f3xx_hal.h"
+#include "LED_fade.h"
+
+/**
+ * @brief Number of TIM3 registers written per burst (CCR1 to CCR3).
+ *
+ * CCR2 is not connected to a BLANK line but sits between CCR1 (blue) and
+ * CCR3 (red). It sets the green phase (see PWM_GREEN_PHASE), so the burst
+ * writes it with that value.
+ */
+#define PWM_BURST_LENGTH 3
+
+/* Comment out to write whole pulse values with DMA bursts (no dithering). */
+#define PWM_DITHER
+
+#define PWM_FRACTION_BITS 8		///< Fractional bits of Q8 pulse values.
+#define PWM_DITHER_BITS 4		///< Fractional bits resolved by dithering.
+
+#define PULSE_TO_Q8(pulse) ((uint32_t) (pulse) << PWM_FRACTION_BITS)
+
+/* Comment out to start the blue on-time with red's instead of ending it. */
+#define PWM_BLUE_TRAILING
+
+/**
+ * @brief Delay of the green period behind red and blue, Q16 of a period.
+ *
+ * TIM15 is reset from TIM3 CH2 (OC2REF on TRGO) at this point in each TIM3
+ * period. 0 resets it on the TIM3 update instead, in phase with red.
+ */
+#define PWM_GREEN_PHASE 21845
+
+#define PWM_SYNC_SAMPLES 16				///< Counter pairs read by the self-test.
+#define PWM_SYNC_TOLERANCE 4			///< Allowed counter misalignment.
+#define PWM_SYNC_SETTLE_TIME 10			///< Time for TIM15 to lock in ms.
+
+/**
+ * @brief Pulse value above any profile's period, so BLANK is held high.
+ */
+#define PWM_PULSE_OFF UINT16_MAX
+
+/**
+ * @brief Longest period a profile may use.
+ *
+ * PWM_PULSE_OFF must stay above every period: a compare value equal to the
+ * period still leaves BLANK low for one count.
+ */
+#define PWM_MAX_PERIOD (PWM_PULSE_OFF - 1)
+
+/**
+ * @brief Timebase of the BLANK PWM (TIM3 and TIM15).
+ *
+ * Pulse values run from 0 (fully on) to period (off), so the period sets the
+ * resolution and, with the prescaler, the PWM frequency of
+ * 16 MHz / ((prescaler + 1) * (period + 1)).
+ */
+typedef struct {
+	uint16_t prescaler;		///< TIM3/TIM15 prescaler.
+	uint16_t period;		///< Counter period (full scale pulse value).
+} PwmProfile;
+
+/**
+ * @brief Represents the available PWM profiles.
+ */
+typedef enum {
+	PWM_PROFILE_STANDARD,	///< ~10 bits at 2 kHz (the original timebase).
+	PWM_PROFILE_FAST,		///< ~10 bits at 16 kHz.
+	PWM_PROFILE_12_BIT,		///< 12 bits at 4 kHz.
+	PWM_PROFILE_16_BIT,		///< ~16 bits at 244 Hz.
+	NUM_PWM_PROFILES
+} PwmProfileId;
+
+/* Build-time profile selection (can be overridden with -D). */
+#ifndef PWM_DEFAULT_PROFILE
+#define PWM_DEFAULT_PROFILE PWM_PROFILE_STANDARD
+#endif /* PWM_DEFAULT_PROFILE */
+
+/**
+ * @brief Represents the outcome of the timer synchronisation self-test.
+ */
+typedef enum {
+	PWM_SYNC_OK,			///< TIM15 is locked to TIM3 at the set phase.
+	PWM_SYNC_DRIFT			///< TIM15 is out of step with TIM3.
+} PwmSyncStatus;
+
+/**
+ * @brief Counter alignment measured by the synchronisation self-test.
+ */
+typedef struct {
+	uint16_t expected_lag;	///< TIM3 counts TIM15 should be behind by.
+	int16_t min_error;		///< Smallest measured lag minus the expected one.
+	int16_t max_error;		///< Largest measured lag minus the expected one.
+} PwmSyncReport;
+
+extern const PwmProfile pwm_profiles[NUM_PWM_PROFILES];
+extern const PwmProfile *volatile active_pwm_profile;
+
+extern DMA_HandleTypeDef hdma_tim3_up;
+
+void initialise_pwm_commit(void);
+void commit_pulse_values(uint16_t *pulse_values);
+void commit_pulse_values_q8(uint32_t *pulse_values);
+void advance_pwm_dither(uint32_t targets[3], uint8_t accumulators[3],
+		uint16_t outputs[3]);
+void pwm_period_elapsed(void);
+uint32_t rescale_pulse_value(uint32_t pulse_value, uint16_t old_period,
+		uint16_t new_period);
+void set_pwm_profile(PwmProfileId profile);
+void start_pwm_fade(uint32_t duration, FadeCurve curve);
+uint32_t get_blank_time_left(uint8_t colour, GPIO_PinState level);
+PwmSyncStatus check_pwm_sync(PwmSyncReport *report);
+uint8_t pwm_fade_running(void);
+
+#endif /* LED_PWM_H */
@@ -0,0 +1,96 @@
+/**
+ *******************************************************************************
+ * @file LED_shift_engine.h
+ * @brief Declarations for LED_shift_engine.c
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#ifndef LED_SHIFT_ENGINE_H
+#define LED_SHIFT_ENGINE_H
+
+#include <stdint.h>
+#include "stm32f3xx_hal.h"
+#include "globals.h"
+#include "LED_driver_config.h"
+
+/* Comment out to clock the frames out from the CPU instead of with DMA. */
+#define LED_SHIFT_DMA
+
+#define SHIFT_BITS_PER_CHAIN 16		///< Bits of an on/off word per chain.
+#define SHIFT_STEPS_PER_BIT 2		///< Steps per bit (data/SCLK low, SCLK high).
+
+/**
+ * @brief Number of steps in a frame that shifts the given bits per chain.
+ *
+ * One step to set MODE and idle XLAT/SCLK, two steps per bit, then XLAT high
+ * and low.
+ */
+#define SHIFT_FRAME_STEPS(bits) (1 + SHIFT_STEPS_PER_BIT * (bits) + 2)
+
+/* Dot correction shifts every output's value, OUT15 first, MSB first. */
+#define SHIFT_DOT_CORRECTION_BITS (NUM_LEDS * DOT_CORRECTION_BITS)
+
+#define SHIFT_FRAME_LENGTH SHIFT_FRAME_STEPS(SHIFT_BITS_PER_CHAIN)
+#define SHIFT_MAX_FRAME_LENGTH SHIFT_FRAME_STEPS(SHIFT_DOT_CORRECTION_BITS)
+
+#define SHIFT_TIMER_PRESCALER 0		///< TIM4 prescaler (16 MHz timer clock).
+#define SHIFT_TIMER_PERIOD 15		///< TIM4 period (1 MHz step rate).
+#define SHIFT_CAPTURE_PULSE 8		///< TIM4 count at which SOUT is sampled.
+
+/**
+ * @brief A frame of GPIO BSRR words, one word per port per step.
+ *
+ * SIN_B sits on GPIOA while every other driver line sits on GPIOB, so each
+ * step needs a write to both ports.
+ */
+typedef struct {
+	uint32_t port_a[SHIFT_MAX_FRAME_LENGTH];	///< GPIOA BSRR words (SIN_B).
+	uint32_t port_b[SHIFT_MAX_FRAME_LENGTH];	///< GPIOB BSRR words (the rest).
+	uint16_t bits;								///< Bits shifted into each chain.
+} ShiftFrame;
+
+/**
+ * @brief GPIO input samples taken during a frame, one per port per step.
+ *
+ * Sample n is taken during step n, after the GPIOB word of step n - 1 has
+ * been written, so SOUT bit b of the old shift register contents is found
+ * in the sample after the data step of bit b.
+ */
+typedef struct {
+	uint16_t port_a[SHIFT_MAX_FRAME_LENGTH];	///< GPIOA IDR samples (SOUT_R).
+	uint16_t port_b[SHIFT_MAX_FRAME_LENGTH];	///< GPIOB IDR samples (SOUT_G/B).
+} ShiftCapture;
+
+/**
+ * @brief Represents the states of the shift engine.
+ */
+typedef enum {
+	SHIFT_ENGINE_OK,			///< Frame queued (or shifted) successfully.
+	SHIFT_ENGINE_BUSY,			///< A frame is already being shifted out.
+	SHIFT_ENGINE_ERROR			///< The timer or DMA could not be started.
+} ShiftEngineStatus;
+
+typedef void (*ShiftCompleteCallback)(void);
+
+void encode_shift_frame(uint16_t red_mask, uint16_t green_mask,
+		uint16_t blue_mask, ShiftFrame *frame);
+void encode_dot_correction_frame(uint8_t dot_correction[3][NUM_LEDS],
+		ShiftFrame *frame);
+void decode_shift_capture(const ShiftCapture *capture, uint16_t words[3]);
+void decode_dot_correction_capture(const ShiftCapture *capture,
+		uint8_t dot_correction[3][NUM_LEDS]);
+void initialise_shift_engine(void);
+ShiftEngineStatus queue_shift_frame(uint16_t red_mask, uint16_t green_mask,
+		uint16_t blue_mask, ShiftCompleteCallback callback);
+ShiftEngineStatus queue_dot_correction_frame(
+		uint8_t dot_correction[3][NUM_LEDS], ShiftCompleteCallback callback);
+uint8_t shift_engine_busy(void);
+uint32_t get_shift_frame_count(void);
+void get_shift_readback(uint16_t words[3]);
+void get_dot_correction_readback(uint8_t dot_correction[3][NUM_LEDS]);
+void wait_for_shift_engine(void);
+
+#endif /* LED_SHIFT_ENGINE_H */
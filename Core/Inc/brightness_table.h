@@ -0,0 +1,21 @@
+/**
+ *******************************************************************************
+ * @file brightness_table.h
+ * @brief Declarations for brightness_table.c
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#ifndef BRIGHTNESS_TABLE_H
+#define BRIGHTNESS_TABLE_H
+
+#include <stdint.h>
+#include "globals.h"
+
+#define BRIGHTNESS_TABLE_SHIFT 16	///< Entries are Q16 luminance fractions.
+
+extern const uint16_t brightness_table[ADC_RES];
+
+#endif /* BRIGHTNESS_TABLE_H */
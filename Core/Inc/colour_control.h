@@ -1,9 +1,29 @@
-uint16_t clamp(uint16_t value, uint16_t min, uint16_t max);
-void calculate_pulse_values(uint16_t *pulse_values);
-void set_pulse_values(uint16_t *pulse_values);
-void single_pulse(void);
-void double_pulse(void);
-void long_pulse(void);
-void red_single_pulse(void);
-void red_double_pulse(void);
-void red_long_pulse(void);
+#define COLOUR_SHIFT 16					///< Fractional bits of a colour.
+#define COLOUR_ONE (1UL << COLOUR_SHIFT)	///< A colour channel fully on.
+#define WHITE_TABLE_BITS 8				///< log2 of the white table intervals.
+#define WHITE_TABLE_LENGTH ((1 << WHITE_TABLE_BITS) + 1)	///< Entries.
+
+/*
+ * Scale each white and hue down towards a common luminance, so pot 1 mostly
+ * sets the brightness on its own. Comment out to drive colours at full scale.
+ */
+#define CONSTANT_LUMINANCE
+
+/*
+ * Smallest luminance gain, Q16. The common luminance is the larger of the
+ * dimmest entry and this fraction of the brightest, so no colour is dimmed
+ * further than this for the sake of a much dimmer one (such as pure blue).
+ * Entries below it are left at full scale instead of matching.
+ */
+#define CONSTANT_LUMINANCE_MIN_GAIN 32768
+
+#define HUE_SATURATION COLOUR_ONE		///< RGB_LIGHT saturation, Q16.
+
+
+void generate_white_table(void);
+void generate_gain_tables(void);
+uint32_t brightness_gain(uint16_t pot_value);
+void hue_colour(uint32_t position, uint32_t saturation, uint32_t *colour);
+uint32_t clamp(uint32_t value, uint32_t min, uint32_t max);
+void calculate_pulse_values(uint32_t *pulse_values);
+void set_pulse_values(uint32_t *pulse_values);
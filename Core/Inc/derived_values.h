@@ -0,0 +1,34 @@
+/**
+ *******************************************************************************
+ * @file derived_values.h
+ * @brief Declarations for derived_values.c
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#ifndef DERIVED_VALUES_H
+#define DERIVED_VALUES_H
+
+#include <stdint.h>
+
+#define POT1_DEADBAND 2		///< Pot 1 counts ignored either side of last use.
+#define POT2_DEADBAND 2		///< Pot 2 counts ignored either side of last use.
+#define POT3_DEADBAND 2		///< Pot 3 counts ignored either side of last use.
+
+/**
+ * @brief How often each derived value was recomputed or skipped.
+ */
+typedef struct {
+	uint32_t colour_executed;		///< Pulse values recomputed.
+	uint32_t colour_skipped;		///< Pulse values left as they were.
+	uint32_t threshold_executed;	///< Hysteresis thresholds recomputed.
+	uint32_t threshold_skipped;		///< Hysteresis thresholds left as they were.
+} DerivedValueCounts;
+
+void update_derived_values(uint32_t *hysteresis_thresholds);
+void invalidate_derived_values(void);
+void get_derived_value_counts(DerivedValueCounts *counts);
+
+#endif /* DERIVED_VALUES_H */
@@ -41,7 +41,6 @@ typedef enum {
 void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
 void handle_button(ButtonInfo *button, uint32_t current_time);
 void initialise_button_states(void);
-void determine_led_errors(void);
 ReadStatus read_light_sensor_data(void);
 InitStatus initialise_light_sensor(void);
 void print_binary(uint16_t value);
@@ -16,14 +16,18 @@
 #include "state_machine.h"
 #include "timers.h"
 #include "external_interrupts.h"
+#include "LED_fault_scanner.h"
+#include "LED_pwm.h"
 
 #define MOVING_AVERAGE_SIZE 5	///< Number of potentiometer values averaged.
-#define COUNTER_PERIOD 1000		///< Period of PWM timer counters.
+#define COUNTER_PERIOD (active_pwm_profile->period) ///< PWM full scale.
 #define NUM_DMA_CHANNELS 2		///< Number of ADC channels read with DMA.
-#define ADC_RES 4096 			///< Number of distinct possible ADC values.
+#define ADC_RES_BITS 12			///< Resolution of the ADC readings.
+#define ADC_RES (1 << ADC_RES_BITS)	///< Number of distinct possible ADC values.
 #define NUM_LEDS 16				///< Number of LEDs.
+#define STANDBY_FADE_TIME 3000	///< Fade in/out of STANDBY in ms.
+#define COLOUR_FADE_TIME 500	///< Crossfade between colour modes in ms.
 
-/* Make NUM_CAL_INCS a multiple of six for even colour sampling. */
 #define NUM_CAL_INCS 24			///< Number of increments in calibration.
 #define NUM_CAL_SAMPLES 10		///< Number of samples in calibration.
 
@@ -70,6 +74,7 @@ extern uint8_t blue_thermal_error_flag;
 extern uint16_t red_lod_flag;
 extern uint16_t green_lod_flag;
 extern uint16_t blue_lod_flag;
+volatile extern LEDFaultFlag led_fault_flag;
 
 extern volatile uint32_t mlux_reading;
 extern volatile SensorFlag light_sensor_flag;
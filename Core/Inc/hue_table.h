@@ -0,0 +1,22 @@
+/**
+ *******************************************************************************
+ * @file hue_table.h
+ * @brief Declarations for hue_table.c
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#ifndef HUE_TABLE_H
+#define HUE_TABLE_H
+
+#include <stdint.h>
+
+#define HUE_TABLE_BITS 8		///< log2 of the hue table intervals.
+#define HUE_TABLE_LENGTH ((1 << HUE_TABLE_BITS) + 1)	///< Entries.
+#define HUE_TABLE_SHIFT 16		///< Entries are Q16 on-times.
+
+extern const uint16_t hue_table[HUE_TABLE_LENGTH][3];
+
+#endif /* HUE_TABLE_H */
@@ -11,6 +11,9 @@
 #ifndef HYSTERESIS_H
 #define HYSTERESIS_H
 
+#include <stdint.h>
+
+void check_for_on_off(uint32_t *hysteresis_thresholds);
 void update_hysteresis_thresholds(uint32_t *hysteresis_thresholds);
 
 #endif /* HYSTERESIS_H */
@@ -12,6 +12,11 @@
 #define KELVIN_TO_RGB_H
 
 #define KELVIN_TABLE_LENGTH 71	///< Number of entries in kelvin_table.
+/* Uniform entry spacing in K, 0 if uneven (can be overridden with -D). */
+#ifndef KELVIN_TABLE_STEP
+#define KELVIN_TABLE_STEP 100
+#endif /* KELVIN_TABLE_STEP */
+#define KELVIN_WEIGHT_SHIFT 15	///< Fractional bits of a lookup weight.
 
 #include <stdint.h>
 
@@ -24,9 +29,11 @@ typedef struct {
 
 extern KelvinToRGB kelvin_table[];
 
-void search_rgb_to_kelvin(uint32_t kelvin, KelvinToRGB *lower,
+uint16_t search_rgb_to_kelvin(uint32_t kelvin, KelvinToRGB *lower,
 		KelvinToRGB *higher);
-void pulse_for_kelvin(uint32_t kelvin, KelvinToRGB *lower, KelvinToRGB *higher,
+void rgb_for_kelvin(uint16_t weight, KelvinToRGB *lower, KelvinToRGB *higher,
+		uint32_t *rgb_values);
+void pulse_for_kelvin(uint16_t weight, KelvinToRGB *lower, KelvinToRGB *higher,
 		uint16_t *pulse_values);
 
 #endif /* KELVIN_TO_RGB_H */
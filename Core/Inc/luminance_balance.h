@@ -0,0 +1,41 @@
+/**
+ *******************************************************************************
+ * @file luminance_balance.h
+ * @brief Declarations for luminance_balance.c
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#ifndef LUMINANCE_BALANCE_H
+#define LUMINANCE_BALANCE_H
+
+#include <stdint.h>
+
+#define LUMINANCE_GAIN_SHIFT 14			///< Fractional bits of a gain.
+#define LUMINANCE_GAIN_ONE (1 << LUMINANCE_GAIN_SHIFT)	///< Gain of 1.
+#define LUMINANCE_WEIGHT_SHIFT 16		///< Fractional bits of a weight.
+
+/* Rec. 709 luminance of each primary, used until a calibration is fitted. */
+#define LUMINANCE_WEIGHT_RED 13933		///< 0.2126 in Q16.
+#define LUMINANCE_WEIGHT_GREEN 46871	///< 0.7152 in Q16.
+#define LUMINANCE_WEIGHT_BLUE 4732		///< 0.0722 in Q16.
+
+/**
+ * @brief Represents the outcome of fitting the luminance balance.
+ */
+typedef enum {
+	BALANCE_OK,				///< The gains and weights were updated.
+	BALANCE_NO_SIGNAL,		///< A colour gave no light above the baseline.
+	BALANCE_SINGULAR		///< The sweeps could not separate the colours.
+} BalanceStatus;
+
+extern uint16_t luminance_gains[3];
+extern uint16_t luminance_weights[3];
+extern uint8_t luminance_balance_fitted;
+
+BalanceStatus fit_luminance_balance(void);
+void apply_luminance_balance(uint32_t *colour);
+
+#endif /* LUMINANCE_BALANCE_H */
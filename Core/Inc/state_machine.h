@@ -94,6 +94,7 @@ void handle_white_light(EventType event);
 void handle_RGB_light(EventType event);
 void update_pot_cal_substate(EventType event);
 void update_led_cal_substate(EventType event);
+void update_standby_masks(void);
 
 int sensor_calibration_process(void);
 int collect_calibration_data(uint32_t buffer[][2], int array_index);
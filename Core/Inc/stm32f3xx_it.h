@@ -62,6 +62,10 @@ void I2C2_ER_IRQHandler(void);
 void EXTI15_10_IRQHandler(void);
 void DMA2_Channel1_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void DMA1_Channel7_IRQHandler(void);
+void TIM6_DAC_IRQHandler(void);
+void DMA1_Channel3_IRQHandler(void);
+void TIM3_IRQHandler(void);
 
 /* USER CODE END EFP */
 
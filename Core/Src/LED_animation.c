@@ -0,0 +1,208 @@
+/**
+ *******************************************************************************
+ * @file LED_animation.c
+ * @brief Non-blocking keyframe animations for user notifications.
+ *
+ * A notification is a const sequence of keyframes, each holding an on-time
+ * per colour and how long to show it. play_animation() queues a sequence and
+ * returns straight away. service_animation() is called every main loop tick,
+ * works out the keyframe for the current HAL tick and lays its pulse values
+ * over the live output in the framebuffer until the queue is empty.
+ *
+ * Keyframe boundaries are advanced by their durations rather than by the
+ * time they were noticed, so a late tick does not stretch the sequence.
+ * advance_animation() takes the time as a parameter and so can be run
+ * against a virtual clock.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include "stm32f3xx_hal.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "globals.h"
+#include "LED_animation.h"
+#include "LED_framebuffer.h"
+#include "LED_pwm.h"
+
+#define NOTIFICATION_GAP 150		///< Off time around a pulse in ms.
+#define NOTIFICATION_SHORT 150		///< On time of a short pulse in ms.
+#define NOTIFICATION_LONG 1000		///< On time of a long pulse in ms.
+#define NOTIFICATION_PAUSE 1000		///< Time before closing pulses in ms.
+
+#define WHITE_OFF { ANIMATION_LEVEL_OFF, ANIMATION_LEVEL_OFF, ANIMATION_LEVEL_OFF }
+#define WHITE_ON { ANIMATION_LEVEL_FULL, ANIMATION_LEVEL_FULL, ANIMATION_LEVEL_FULL }
+#define RED_ON { ANIMATION_LEVEL_FULL, ANIMATION_LEVEL_OFF, ANIMATION_LEVEL_OFF }
+#define LIVE { ANIMATION_LEVEL_LIVE, ANIMATION_LEVEL_LIVE, ANIMATION_LEVEL_LIVE }
+
+static const AnimationKeyframe single_pulse_keyframes[] = {
+		{ WHITE_OFF, NOTIFICATION_GAP }, { WHITE_ON, NOTIFICATION_SHORT }, {
+		WHITE_OFF, NOTIFICATION_GAP } };
+static const AnimationKeyframe double_pulse_keyframes[] = {
+		{ WHITE_OFF, NOTIFICATION_GAP }, { WHITE_ON, NOTIFICATION_SHORT }, {
+		WHITE_OFF, NOTIFICATION_GAP }, { WHITE_ON, NOTIFICATION_SHORT }, {
+		WHITE_OFF, NOTIFICATION_GAP } };
+static const AnimationKeyframe long_pulse_keyframes[] = {
+		{ WHITE_OFF, NOTIFICATION_GAP }, { WHITE_ON, NOTIFICATION_LONG }, {
+		WHITE_OFF, NOTIFICATION_GAP } };
+static const AnimationKeyframe red_single_pulse_keyframes[] = {
+		{ WHITE_OFF, NOTIFICATION_GAP }, { RED_ON, NOTIFICATION_SHORT }, {
+		WHITE_OFF, NOTIFICATION_GAP } };
+static const AnimationKeyframe red_double_pulse_keyframes[] = {
+		{ WHITE_OFF, NOTIFICATION_GAP }, { RED_ON, NOTIFICATION_SHORT }, {
+		WHITE_OFF, NOTIFICATION_GAP }, { RED_ON, NOTIFICATION_SHORT }, {
+		WHITE_OFF, NOTIFICATION_GAP } };
+static const AnimationKeyframe red_long_pulse_keyframes[] = {
+		{ WHITE_OFF, NOTIFICATION_GAP }, { RED_ON, NOTIFICATION_LONG }, {
+		WHITE_OFF, NOTIFICATION_GAP } };
+static const AnimationKeyframe notification_pause_keyframes[] = {
+		{ LIVE, NOTIFICATION_PAUSE } };
+
+#define SEQUENCE(keyframes) { keyframes, sizeof(keyframes) / sizeof(keyframes[0]) }
+
+const AnimationSequence single_pulse_animation = SEQUENCE(
+		single_pulse_keyframes);
+const AnimationSequence double_pulse_animation = SEQUENCE(
+		double_pulse_keyframes);
+const AnimationSequence long_pulse_animation = SEQUENCE(long_pulse_keyframes);
+const AnimationSequence red_single_pulse_animation = SEQUENCE(
+		red_single_pulse_keyframes);
+const AnimationSequence red_double_pulse_animation = SEQUENCE(
+		red_double_pulse_keyframes);
+const AnimationSequence red_long_pulse_animation = SEQUENCE(
+		red_long_pulse_keyframes);
+const AnimationSequence notification_pause_animation = SEQUENCE(
+		notification_pause_keyframes);
+
+static const AnimationSequence *queue[ANIMATION_QUEUE_LENGTH];
+static volatile uint8_t queue_head = 0;		///< Next sequence to play.
+static volatile uint8_t queue_tail = 0;		///< Next free queue slot.
+static const AnimationSequence *current = NULL;	///< Sequence being shown.
+static uint8_t keyframe_index = 0;			///< Keyframe being shown.
+static uint32_t keyframe_start = 0;			///< Time the keyframe began.
+
+/**
+ * @brief Queues a sequence to play after any already queued.
+ *
+ * @param sequence: The sequence to play.
+ *
+ * @return 1 if the sequence was queued, 0 if the queue is full.
+ */
+uint8_t play_animation(const AnimationSequence *sequence) {
+	uint8_t next_tail = (queue_tail + 1) % ANIMATION_QUEUE_LENGTH;
+	if (next_tail == queue_head) {
+		return 0;
+	}
+	queue[queue_tail] = sequence;
+	queue_tail = next_tail;
+	return 1;
+}
+
+/**
+ * @brief Starts the next queued sequence with a non-empty keyframe list.
+ *
+ * @param start: The time the first keyframe begins.
+ *
+ * @return 1 if a sequence was started, 0 if the queue is empty.
+ */
+static uint8_t start_next_sequence(uint32_t start) {
+	while (queue_head != queue_tail) {
+		current = queue[queue_head];
+		queue_head = (queue_head + 1) % ANIMATION_QUEUE_LENGTH;
+		if (current->length > 0) {
+			keyframe_index = 0;
+			keyframe_start = start;
+			return 1;
+		}
+	}
+	current = NULL;
+	return 0;
+}
+
+/**
+ * @brief Converts a keyframe level to a Q8 pulse value.
+ *
+ * @param level: Q15 on-time, or ANIMATION_LEVEL_LIVE.
+ *
+ * @return The Q8 pulse value, or FRAMEBUFFER_NO_OVERLAY for a live level.
+ */
+static uint32_t level_to_pulse(uint16_t level) {
+	if (level == ANIMATION_LEVEL_LIVE) {
+		return FRAMEBUFFER_NO_OVERLAY;
+	}
+	uint32_t period = COUNTER_PERIOD;
+	return PULSE_TO_Q8(period)
+			- ((period * level) >> (ANIMATION_LEVEL_SHIFT - PWM_FRACTION_BITS));
+}
+
+/**
+ * @brief Moves the animation on to a given time.
+ *
+ * @param now: The current time in ms.
+ * @param pulse_values: Array to fill with the Q8 pulse values (R, G, B) to
+ * show, FRAMEBUFFER_NO_OVERLAY for colours that keep their live value.
+ *
+ * @return 1 while an animation is showing, 0 once the queue is empty.
+ */
+uint8_t advance_animation(uint32_t now, uint32_t pulse_values[3]) {
+	if ((current == NULL) && !start_next_sequence(now)) {
+		return 0;
+	}
+
+	/* Step over every keyframe that has finished by now. */
+	while ((now - keyframe_start)
+			>= current->keyframes[keyframe_index].duration) {
+		keyframe_start += current->keyframes[keyframe_index].duration;
+		keyframe_index++;
+		if ((keyframe_index >= current->length)
+				&& !start_next_sequence(keyframe_start)) {
+			return 0;
+		}
+	}
+
+	const uint16_t *levels = current->keyframes[keyframe_index].levels;
+	pulse_values[0] = level_to_pulse(levels[0]);
+	pulse_values[1] = level_to_pulse(levels[1]);
+	pulse_values[2] = level_to_pulse(levels[2]);
+	return 1;
+}
+
+/**
+ * @brief Checks whether an animation is showing or queued.
+ *
+ * @return 1 if an animation is running, 0 otherwise.
+ */
+uint8_t animation_running(void) {
+	return (current != NULL) || (queue_head != queue_tail);
+}
+
+/**
+ * @brief Lays the current keyframe over the live output (once per tick).
+ *
+ * @return None.
+ */
+void service_animation(void) {
+	uint32_t pulse_values[3];
+	if (advance_animation(HAL_GetTick(), pulse_values)) {
+		framebuffer_set_overlay(pulse_values);
+	} else {
+		framebuffer_set_overlay(NULL);
+	}
+}
+
+/**
+ * @brief Plays out every queued animation before returning.
+ *
+ * For blocking flows (calibration measurements) that must not see a
+ * notification while they run.
+ *
+ * @return None.
+ */
+void wait_for_animation(void) {
+	while (animation_running()) {
+		service_animation();
+		flush_framebuffer();
+	}
+}
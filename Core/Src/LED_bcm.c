@@ -0,0 +1,352 @@
+/**
+ *******************************************************************************
+ * @file LED_bcm.c
+ * @brief Binary code modulation of per-LED intensity on the on/off drivers.
+ *
+ * Each LED's intensity (0 to BCM_MAX_LEVEL per colour) is split into
+ * BCM_BITS bit-planes. Plane k holds bit k of every LED and is latched for
+ * BCM_BASE_PERIODS << k periods of the BLANK PWM, so the time-integrated
+ * on-time of an LED is level / BCM_MAX_LEVEL of what the BLANK PWM gives. The
+ * global brightness still comes from the BLANK PWM on TIM3/TIM15.
+ *
+ * TIM6 times the planes. It runs from the same clock and prescaler as TIM3,
+ * so a plane of whole PWM periods cannot drift against BLANK. The plane
+ * boundaries land at a fixed point in the PWM period (one shift frame after
+ * the TIM6 update), and every plane then covers each BLANK phase equally.
+ *
+ * The engine owns the driver lines while it runs, so the fault scanner asks
+ * for a hold: at the end of the cycle every LED with a non-zero level is
+ * latched and TIM6 stops until the hold is released.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include "stm32f3xx_hal.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+#include "globals.h"
+#include "LED_bcm.h"
+#include "LED_shift_engine.h"
+#include "LED_driver_config.h"
+#include "debug_flags.h"
+
+TIM_HandleTypeDef htim6;
+
+static uint16_t bcm_planes[2][BCM_BITS][3];		///< Front and back planes.
+static volatile uint8_t front_planes = 0;		///< Index of planes in use.
+static volatile uint8_t swap_pending = 0;		///< Back planes are ready.
+static volatile uint8_t current_plane = 0;		///< Plane being displayed.
+static volatile uint8_t running = 0;
+static const PwmProfile *bcm_profile;			///< Profile the planes fit.
+static volatile uint32_t missed_planes = 0;		///< Planes shown late.
+static volatile uint8_t hold_requested = 0;		///< Hold at the cycle end.
+static volatile uint8_t held = 0;				///< Stopped between cycles.
+static uint16_t held_masks[3];					///< Words latched for a hold.
+
+/**
+ * @brief Splits per-LED intensity levels into BCM bit-planes.
+ *
+ * @param levels: Intensity of each LED per colour (0 to BCM_MAX_LEVEL).
+ * @param planes: Array to fill with one on/off word per chain per plane.
+ *
+ * @return None.
+ */
+void build_bcm_planes(uint8_t levels[3][NUM_LEDS],
+		uint16_t planes[BCM_BITS][3]) {
+	for (int plane = 0; plane < BCM_BITS; plane++) {
+		for (int chain = 0; chain < 3; chain++) {
+			uint16_t mask = LED_MASK_NONE;
+			for (int led = 0; led < NUM_LEDS; led++) {
+				if ((levels[chain][led] >> plane) & 1) {
+					mask |= (1 << led);
+				}
+			}
+			planes[plane][chain] = mask;
+		}
+	}
+}
+
+/**
+ * @brief Turns dot correction values into BCM levels.
+ *
+ * Used to even out the LEDs with BCM on chains whose drivers could not take
+ * the dot correction. Chains not in the set are left at BCM_MAX_LEVEL.
+ *
+ * @param dot_correction: Dot correction values for each chain and LED.
+ * @param chains: LED_CHAIN_x bits of the chains to convert.
+ * @param levels: Array to fill with the level of each LED per colour.
+ *
+ * @return None.
+ */
+void bcm_levels_from_dot_correction(uint8_t dot_correction[3][NUM_LEDS],
+		uint8_t chains, uint8_t levels[3][NUM_LEDS]) {
+	for (int chain = 0; chain < 3; chain++) {
+		for (int led = 0; led < NUM_LEDS; led++) {
+			levels[chain][led] = ((chains >> chain) & 1) ?
+					(dot_correction[chain][led] * BCM_MAX_LEVEL
+							+ DOT_CORRECTION_MAX / 2) / DOT_CORRECTION_MAX :
+					BCM_MAX_LEVEL;
+		}
+	}
+}
+
+/**
+ * @brief Works out how long a bit-plane is latched for.
+ *
+ * @param plane: The plane, 0 to BCM_BITS - 1.
+ * @param profile: The PWM profile BLANK runs at.
+ *
+ * @return The length in TIM6 (and TIM3) counts.
+ */
+uint32_t get_bcm_plane_length(uint8_t plane, const PwmProfile *profile) {
+	return ((uint32_t) profile->period + 1) * (BCM_BASE_PERIODS << plane);
+}
+
+/**
+ * @brief Checks whether BCM can run with a PWM profile.
+ *
+ * The longest plane must fit TIM6's 16-bit counter, the shortest must outlast
+ * a shift frame, and a cycle must be faster than BCM_MIN_CYCLE_RATE.
+ *
+ * @param profile: The PWM profile BLANK runs at.
+ *
+ * @return 1 if supported, 0 otherwise.
+ */
+uint8_t bcm_profile_supported(const PwmProfile *profile) {
+	uint32_t prescale = (uint32_t) profile->prescaler + 1;
+	uint32_t shift_ticks = SHIFT_FRAME_LENGTH * (SHIFT_TIMER_PRESCALER + 1)
+			* (SHIFT_TIMER_PERIOD + 1);
+	uint64_t cycle_ticks = (uint64_t) prescale * BCM_MAX_LEVEL
+			* get_bcm_plane_length(0, profile);
+
+	return (get_bcm_plane_length(BCM_BITS - 1, profile) <= 0x10000)
+			&& (get_bcm_plane_length(0, profile) * prescale > shift_ticks)
+			&& (cycle_ticks * BCM_MIN_CYCLE_RATE <= SystemCoreClock);
+}
+
+/**
+ * @brief Configures TIM6 to time the bit-planes.
+ *
+ * @return None.
+ */
+void initialise_bcm(void) {
+	__HAL_RCC_TIM6_CLK_ENABLE();
+
+	/* start_bcm() matches the prescaler and period to the PWM profile. */
+	htim6.Instance = TIM6;
+	htim6.Init.Prescaler = active_pwm_profile->prescaler;
+	htim6.Init.CounterMode = TIM_COUNTERMODE_UP;
+	htim6.Init.Period = get_bcm_plane_length(0, active_pwm_profile) - 1;
+	htim6.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+	if (HAL_TIM_Base_Init(&htim6) != HAL_OK) {
+		Error_Handler();
+	}
+
+	HAL_NVIC_SetPriority(TIM6_DAC_IRQn, 0, 0);
+	HAL_NVIC_EnableIRQ(TIM6_DAC_IRQn);
+
+	/* Default to every LED fully on. */
+	memset(bcm_planes, 0xFF, sizeof(bcm_planes));
+#ifdef DEBUG_INIT
+	printf("BCM TIMER INITIALISED\n");
+#endif /* DEBUG_INIT */
+}
+
+/**
+ * @brief Sets new per-LED intensities, applied at the start of the next cycle.
+ *
+ * @param levels: Intensity of each LED per colour (0 to BCM_MAX_LEVEL).
+ *
+ * @return None.
+ */
+void set_bcm_levels(uint8_t levels[3][NUM_LEDS]) {
+	/* Wait for the last set of planes to be picked up by the ISR. */
+	while (swap_pending && running && !held) {
+	}
+	build_bcm_planes(levels, bcm_planes[front_planes ^ 1]);
+	if (running && !held) {
+		swap_pending = 1;
+	} else {
+		front_planes ^= 1;
+	}
+}
+
+/**
+ * @brief Starts TIM6 with an update now, so the first ISR starts plane 0.
+ *
+ * @return None.
+ */
+static void start_cycle(void) {
+	current_plane = BCM_BITS - 1;
+	__HAL_TIM_SET_PRESCALER(&htim6, bcm_profile->prescaler);
+	__HAL_TIM_SET_AUTORELOAD(&htim6, get_bcm_plane_length(0, bcm_profile) - 1);
+	__HAL_TIM_CLEAR_FLAG(&htim6, TIM_FLAG_UPDATE);
+	HAL_TIM_Base_Start_IT(&htim6);
+	HAL_TIM_GenerateEvent(&htim6, TIM_EVENTSOURCE_UPDATE);
+}
+
+/**
+ * @brief Starts cycling through the bit-planes.
+ *
+ * While running, the BCM engine owns the on/off words of all three chains and
+ * set_LED_masks() must not be called. The planes are timed for the active PWM
+ * profile, so stop the engine before changing it.
+ *
+ * @return BCM_PROFILE_UNSUPPORTED if the active profile cannot be used (see
+ * bcm_profile_supported()), BCM_OK otherwise.
+ */
+BcmStatus start_bcm(void) {
+	if (running) {
+		return BCM_OK;
+	}
+	const PwmProfile *profile = active_pwm_profile;
+	if (!bcm_profile_supported(profile)) {
+		return BCM_PROFILE_UNSUPPORTED;
+	}
+	bcm_profile = profile;
+	running = 1;
+	start_cycle();
+	return BCM_OK;
+}
+
+/**
+ * @brief Stops the bit-plane cycle, leaving the last plane latched.
+ *
+ * @return None.
+ */
+void stop_bcm(void) {
+	HAL_TIM_Base_Stop_IT(&htim6);
+	running = 0;
+	swap_pending = 0;
+	hold_requested = 0;
+	held = 0;
+	wait_for_shift_engine();
+
+	/* The latched words are whatever plane was last shown. */
+	invalidate_LED_masks();
+}
+
+/**
+ * @brief Checks whether the BCM engine is running.
+ *
+ * @return 1 if running, 0 otherwise.
+ */
+uint8_t bcm_running(void) {
+	return running;
+}
+
+/**
+ * @brief Asks the engine to stop at the end of the current cycle.
+ *
+ * Every LED with a non-zero level is then latched fully on and left there, so
+ * the driver lines are free (for a fault scan) until release_bcm(). The
+ * completed cycles keep their exact duty; the hold itself shows the LEDs at
+ * full level, so keep it short.
+ *
+ * @return None.
+ */
+void hold_bcm(void) {
+	if (running && !held) {
+		hold_requested = 1;
+	}
+}
+
+/**
+ * @brief Gets the words latched by a hold.
+ *
+ * @param masks: Array to fill with the on/off word of each chain.
+ *
+ * @return 1 once the engine is held, 0 if it is not (yet).
+ */
+uint8_t get_bcm_held_masks(uint16_t masks[3]) {
+	if (!held) {
+		return 0;
+	}
+	masks[0] = held_masks[0];
+	masks[1] = held_masks[1];
+	masks[2] = held_masks[2];
+	return 1;
+}
+
+/**
+ * @brief Restarts the bit-plane cycle after a hold, from plane 0.
+ *
+ * @return None.
+ */
+void release_bcm(void) {
+	hold_requested = 0;
+	if (!held) {
+		return;
+	}
+	held = 0;
+	start_cycle();
+}
+
+/**
+ * @brief Gets the number of planes that could not be latched on time.
+ *
+ * @return Planes retried because the shift engine was busy, since boot.
+ */
+uint32_t get_bcm_missed_planes(void) {
+	return missed_planes;
+}
+
+/**
+ * @brief Starts the next bit-plane (called from the TIM6 update interrupt).
+ *
+ * The plane's duration was loaded into ARR at this update, so the duration of
+ * the following plane is written to the ARR preload once this plane has been
+ * queued on the shift engine. If the engine is busy, the last plane stays
+ * latched for this slot and the plane is tried again at the next update with
+ * its full duration, so only the cycle it happened in is uneven.
+ *
+ * A requested hold is taken in place of plane 0, once a cycle has ended.
+ *
+ * @return None.
+ */
+void advance_bcm_plane(void) {
+	uint8_t plane = (current_plane + 1) % BCM_BITS;
+	if ((plane == 0) && swap_pending) {
+		front_planes ^= 1;
+		swap_pending = 0;
+	}
+
+	if ((plane == 0) && hold_requested) {
+		uint16_t lit[3] = { LED_MASK_NONE, LED_MASK_NONE, LED_MASK_NONE };
+		for (int bit = 0; bit < BCM_BITS; bit++) {
+			for (int chain = 0; chain < 3; chain++) {
+				lit[chain] |= bcm_planes[front_planes][bit][chain];
+			}
+		}
+		if (queue_shift_frame(lit[0], lit[1], lit[2], NULL)
+				== SHIFT_ENGINE_OK) {
+			HAL_TIM_Base_Stop_IT(&htim6);
+			memcpy(held_masks, lit, sizeof(held_masks));
+			hold_requested = 0;
+			held = 1;
+			return;
+		}
+		missed_planes++;
+		__HAL_TIM_SET_AUTORELOAD(&htim6,
+				get_bcm_plane_length(0, bcm_profile) - 1);
+		return;
+	}
+
+	uint16_t *masks = bcm_planes[front_planes][plane];
+	if (queue_shift_frame(masks[0], masks[1], masks[2], NULL)
+			!= SHIFT_ENGINE_OK) {
+		missed_planes++;
+		__HAL_TIM_SET_AUTORELOAD(&htim6,
+				get_bcm_plane_length(plane, bcm_profile) - 1);
+		return;
+	}
+	current_plane = plane;
+
+	uint8_t next_plane = (plane + 1) % BCM_BITS;
+	__HAL_TIM_SET_AUTORELOAD(&htim6,
+			get_bcm_plane_length(next_plane, bcm_profile) - 1);
+}
@@ -3,6 +3,15 @@
  * @file LED_driver_config.c
  * @brief Functions for configuring the three LED drivers.
  *
+ * set_LED_masks() and configure_dot_correction() stay synchronous: they
+ * block in wait_for_shift_engine() until their frames are latched. Both
+ * return whether the drivers took the data, which is only known once the
+ * SOUT read-back of the same pass has been checked, and dot correction must
+ * also drop MODE after its second frame. Their callers (the framebuffer
+ * flush, calibration and start-up) act on that result. Code that cannot
+ * wait, such as the BCM engine, queues frames on the shift engine itself
+ * and does not call these functions.
+ *
  * @author Erwin Bauernschmitt
  * @date 3/12/2023
  *******************************************************************************
@@ -14,41 +23,243 @@
 #include "hardware_defines.h"
 #include "globals.h"
 #include "LED_driver_config.h"
+#include "LED_shift_engine.h"
 #include "debug_flags.h"
 
+static uint16_t latched_masks[3];			///< Last words latched per chain.
+static uint8_t latched_masks_valid = 0;		///< Whether latched_masks is known.
+static uint8_t failed_chains = 0;			///< LED_CHAIN_x bits of last failure.
+
 /**
  * @brief Configures the drivers to turn on all 16 RGB LEDs.
  *
+ * The same on/off value is written to the red, green and blue chains. Use
+ * set_LED_masks() to control the chains independently.
+ *
+ * @param led_init_config: Array of NUM_LEDS on/off values (index 0 is LED 1).
+ *
  * @return The status of the LED drivers.
  */
 LED_Driver_Status initialise_LED_drivers(uint8_t *led_init_config) {
 #ifdef DEBUG_INIT
 	printf("\nINITIALISING LED DRIVERS\n");
-	printf("Bit-banging...\n");
 #endif /* DEBUG_INIT */
-	/* Set MODE/XLAT/SCLK low for ON/OFF configuration mode. */
+	uint16_t mask = LED_MASK_NONE;
+	for (int i = 0; i < NUM_LEDS; i++) {
+		if (led_init_config[i]) {
+			mask |= (1 << i);
+		}
+	}
+
+	return set_LED_masks(mask, mask, mask);
+}
+
+/**
+ * @brief Sets the on/off state of every LED in each of the three chains.
+ *
+ * Bit n of each mask controls LED n + 1 of that colour. The words are handed
+ * to the shift engine, which clocks them out and pulses XLAT. If the words
+ * match the last ones latched, the whole shift/latch sequence is skipped.
+ *
+ * The chains are verified from the SOUT bits captured during the same pass.
+ * XLAT loads the LOD data into the shift registers, so what comes back is the
+ * open LED word of the previously latched word. Only outputs that were on can
+ * report an open LED, so any bit outside the previous word means the chain is
+ * broken (e.g. SOUT stuck high). The check is skipped when the previous word
+ * is not known.
+ *
+ * @param red_mask: On/off word for the red chain.
+ * @param green_mask: On/off word for the green chain.
+ * @param blue_mask: On/off word for the blue chain.
+ *
+ * @return The status of the LED drivers.
+ */
+LED_Driver_Status set_LED_masks(uint16_t red_mask, uint16_t green_mask,
+		uint16_t blue_mask) {
+	if (latched_masks_valid && (red_mask == latched_masks[0])
+			&& (green_mask == latched_masks[1])
+			&& (blue_mask == latched_masks[2])) {
+		return LED_DRIVER_OK;
+	}
+
+#ifdef DEBUG_LED_DRIVERS
+	printf("Shifting LED masks...\n");
+#endif /* DEBUG_LED_DRIVERS */
+	/* Wait for any previous frame to be latched before queuing this one. */
+	wait_for_shift_engine();
+	if (queue_shift_frame(red_mask, green_mask, blue_mask, NULL)
+			!= SHIFT_ENGINE_OK) {
+		latched_masks_valid = 0;
+		return LED_DRIVER_INIT_FAIL;
+	}
+
+	/* Check what came out of SOUT against the previous word. */
+	wait_for_shift_engine();
+	failed_chains = 0;
+	if (latched_masks_valid) {
+		uint16_t readback[3];
+		get_shift_readback(readback);
+		uint8_t chain_bits[3] = { LED_CHAIN_RED, LED_CHAIN_GREEN,
+				LED_CHAIN_BLUE };
+		for (int chain = 0; chain < 3; chain++) {
+			if (readback[chain] & ~latched_masks[chain]) {
+				failed_chains |= chain_bits[chain];
+			}
+		}
+	}
+	if (failed_chains) {
+#ifdef DEBUG_LED_DRIVERS
+		printf("LED chain read-back failed: %u\n", failed_chains);
+#endif /* DEBUG_LED_DRIVERS */
+		/* Force the next update through so the chain is checked again. */
+		latched_masks_valid = 0;
+		return LED_DRIVER_INIT_FAIL;
+	}
+
+	latched_masks[0] = red_mask;
+	latched_masks[1] = green_mask;
+	latched_masks[2] = blue_mask;
+	latched_masks_valid = 1;
+
+	return LED_DRIVER_OK;
+}
+
+/**
+ * @brief Forgets the last latched masks so the next update is always shifted.
+ *
+ * Must be called after anything other than set_LED_masks() latches the
+ * drivers' shift registers (e.g. reading the LOD data).
+ *
+ * @return None.
+ */
+void invalidate_LED_masks(void) {
+	latched_masks_valid = 0;
+}
+
+/**
+ * @brief Copies the words currently latched in the three chains.
+ *
+ * @param masks: Array to fill with the red, green and blue words.
+ *
+ * @return 1 if the latched words are known, 0 otherwise.
+ */
+uint8_t get_latched_LED_masks(uint16_t masks[3]) {
+	if (!latched_masks_valid) {
+		return 0;
+	}
+	masks[0] = latched_masks[0];
+	masks[1] = latched_masks[1];
+	masks[2] = latched_masks[2];
+	return 1;
+}
+
+/**
+ * @brief Derives per-chain dot correction values from LED calibration data.
+ *
+ * During LED calibration the pots set how long BLANK is held high for each
+ * colour, so the on-time of LED n in a chain is proportional to
+ * (ADC_RES - 1 - calibration[n][chain]). Each chain is normalised so its
+ * brightest LED gets DOT_CORRECTION_MAX, which keeps the per-LED differences
+ * in hardware and leaves the colour balance between chains to the PWM.
+ *
+ * @param calibration: The LED calibration buffer (ADC values per colour).
+ * @param dot_correction: Array to fill with the dot correction values.
+ *
+ * @return None.
+ */
+void calculate_dot_correction(uint16_t calibration[NUM_LEDS][3],
+		uint8_t dot_correction[3][NUM_LEDS]) {
+	for (int chain = 0; chain < 3; chain++) {
+		/* Find the longest on-time in the chain. */
+		uint32_t max_on_time = 0;
+		for (int led = 0; led < NUM_LEDS; led++) {
+			uint32_t on_time = (ADC_RES - 1) - calibration[led][chain];
+			if (on_time > max_on_time) {
+				max_on_time = on_time;
+			}
+		}
+
+		for (int led = 0; led < NUM_LEDS; led++) {
+			if (max_on_time == 0) {
+				dot_correction[chain][led] = DOT_CORRECTION_MAX;
+			} else {
+				uint32_t on_time = (ADC_RES - 1) - calibration[led][chain];
+				dot_correction[chain][led] = (on_time * DOT_CORRECTION_MAX
+						+ max_on_time / 2) / max_on_time;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Writes dot correction data to the drivers and verifies it over SOUT.
+ *
+ * The values are queued as a dot correction frame on the shift engine, which
+ * sets MODE high to select the drivers' dot correction registers. The same
+ * frame is then queued again, and its SOUT capture reads back the first copy.
+ * Any chain whose read-back differs is reported by get_failed_LED_chains().
+ * Blocks until both frames have been latched.
+ *
+ * @param dot_correction: Dot correction values for each chain and LED.
+ *
+ * @return The status of the LED drivers.
+ */
+LED_Driver_Status configure_dot_correction(
+		uint8_t dot_correction[3][NUM_LEDS]) {
+#ifdef DEBUG_LED_DRIVERS
+	printf("\nCONFIGURING DOT CORRECTION\n");
+#endif /* DEBUG_LED_DRIVERS */
+	failed_chains = 0;
+	for (int pass = 0; pass < 2; pass++) {
+		/* Let any frame in flight finish before queuing this one. */
+		wait_for_shift_engine();
+		if (queue_dot_correction_frame(dot_correction, NULL)
+				!= SHIFT_ENGINE_OK) {
+			failed_chains = LED_CHAIN_RED | LED_CHAIN_GREEN | LED_CHAIN_BLUE;
+			break;
+		}
+	}
+	wait_for_shift_engine();
+
+	/* Compare what the second pass clocked out with the first pass. */
+	if (!failed_chains) {
+		uint8_t readback[3][NUM_LEDS];
+		uint8_t chain_bits[3] = { LED_CHAIN_RED, LED_CHAIN_GREEN,
+				LED_CHAIN_BLUE };
+		get_dot_correction_readback(readback);
+		for (int chain = 0; chain < 3; chain++) {
+			for (int led = 0; led < NUM_LEDS; led++) {
+				if (readback[chain][led] != dot_correction[chain][led]) {
+					failed_chains |= chain_bits[chain];
+				}
+			}
+		}
+	}
+
+	/* Return to ON/OFF mode. The on/off shift registers now hold junk. */
 	HAL_GPIO_WritePin(MODE_GPIO_Port, MODE_Pin, RESET);
-	HAL_GPIO_WritePin(XLAT_GPIO_Port, XLAT_Pin, RESET);
-	HAL_GPIO_WritePin(SCLK_GPIO_Port, SCLK_Pin, RESET);
-
-	int i;
-	for (i = 1; i <= 16; i++) {
-		/* Turn the LED on/off according to the config array. */
-		HAL_GPIO_WritePin(SIN_R_GPIO_Port, SIN_R_Pin,
-				led_init_config[NUM_LEDS - i]);
-		HAL_GPIO_WritePin(SIN_G_GPIO_Port, SIN_G_Pin,
-				led_init_config[NUM_LEDS - i]);
-		HAL_GPIO_WritePin(SIN_B_GPIO_Port, SIN_B_Pin,
-				led_init_config[NUM_LEDS - i]);
-		/* Clock the configuration into the LED drivers. */
-		HAL_GPIO_WritePin(SCLK_GPIO_Port, SCLK_Pin, SET);
-		HAL_GPIO_WritePin(SCLK_GPIO_Port, SCLK_Pin, RESET);
-	}
-
-	/* Latch the configuration registers. */
-	HAL_GPIO_WritePin(XLAT_GPIO_Port, XLAT_Pin, SET);
-	HAL_GPIO_WritePin(XLAT_GPIO_Port, XLAT_Pin, RESET);
+	invalidate_LED_masks();
+
+#ifdef DEBUG_LED_DRIVERS
+	for (int led = 0; led < NUM_LEDS; led++) {
+		printf("LED %2u:    DC R = %3u,    G = %3u,    B = %3u\n", led,
+				dot_correction[0][led], dot_correction[1][led],
+				dot_correction[2][led]);
+	}
+	printf("Failed chains: %u\n", failed_chains);
+#endif /* DEBUG_LED_DRIVERS */
 
+	if (failed_chains) {
+		return LED_DRIVER_DOT_FAIL;
+	}
 	return LED_DRIVER_OK;
 }
 
+/**
+ * @brief Gets the chains that failed the last read-back verification.
+ *
+ * @return A set of LED_CHAIN_x bits (0 if every chain verified).
+ */
+uint8_t get_failed_LED_chains(void) {
+	return failed_chains;
+}
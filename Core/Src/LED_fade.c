@@ -0,0 +1,152 @@
+/**
+ *******************************************************************************
+ * @file LED_fade.c
+ * @brief Fixed-point fades between sets of RGB pulse values.
+ *
+ * A fade covers a whole number of PWM periods. Its progress is a Q24
+ * fraction that grows by a constant step each period, so the only division
+ * is the one that sets the step when the fade starts. The progress is shaped
+ * by a 65 point easing curve with linear interpolation between points, and
+ * the eased fraction moves each output from its start value towards its
+ * current target. Targets may change while a fade runs (the pots are still
+ * read), so they are read again every period rather than stored.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <stdint.h>
+#include "LED_fade.h"
+
+/**
+ * @brief Easing curves, Q16 fraction of the change at each 1/64 of the time.
+ */
+static const uint16_t fade_curves[NUM_FADE_CURVES][FADE_CURVE_POINTS] = {
+	/* FADE_LINEAR */
+	{
+		    0,  1024,  2048,  3072,  4096,  5120,  6144,  7168,
+		 8192,  9216, 10240, 11264, 12288, 13312, 14336, 15360,
+		16384, 17408, 18432, 19456, 20480, 21504, 22528, 23552,
+		24576, 25600, 26624, 27648, 28672, 29696, 30720, 31744,
+		32768, 33792, 34816, 35840, 36864, 37888, 38912, 39936,
+		40960, 41984, 43008, 44032, 45056, 46080, 47104, 48128,
+		49152, 50176, 51200, 52224, 53248, 54272, 55296, 56320,
+		57344, 58368, 59392, 60416, 61440, 62464, 63488, 64512,
+		65535
+	},
+	/* FADE_EASE_IN */
+	{
+		    0,     0,     2,     7,    16,    31,    54,    86,
+		  128,   182,   250,   333,   432,   549,   686,   844,
+		 1024,  1228,  1458,  1715,  2000,  2315,  2662,  3042,
+		 3456,  3906,  4394,  4921,  5488,  6097,  6750,  7448,
+		 8192,  8984,  9826, 10719, 11664, 12663, 13718, 14830,
+		16000, 17230, 18522, 19877, 21296, 22781, 24334, 25956,
+		27648, 29412, 31250, 33163, 35152, 37219, 39366, 41594,
+		43904, 46298, 48778, 51345, 54000, 56745, 59582, 62512,
+		65535
+	},
+	/* FADE_EASE_OUT */
+	{
+		    0,  3024,  5954,  8791, 11536, 14191, 16758, 19238,
+		21632, 23942, 26170, 28317, 30384, 32373, 34286, 36124,
+		37888, 39580, 41202, 42755, 44240, 45659, 47014, 48306,
+		49536, 50706, 51818, 52873, 53872, 54817, 55710, 56552,
+		57344, 58088, 58786, 59439, 60048, 60615, 61142, 61630,
+		62080, 62494, 62874, 63221, 63536, 63821, 64078, 64308,
+		64512, 64692, 64850, 64987, 65104, 65203, 65286, 65354,
+		65408, 65450, 65482, 65505, 65520, 65529, 65534, 65535,
+		65535
+	},
+	/* FADE_EASE_IN_OUT */
+	{
+		    0,    48,   188,   418,   736,  1138,  1620,  2180,
+		 2816,  3524,  4300,  5142,  6048,  7014,  8036,  9112,
+		10240, 11416, 12636, 13898, 15200, 16538, 17908, 19308,
+		20736, 22188, 23660, 25150, 26656, 28174, 29700, 31232,
+		32768, 34304, 35836, 37362, 38880, 40386, 41876, 43348,
+		44800, 46228, 47628, 48998, 50336, 51638, 52900, 54120,
+		55296, 56424, 57500, 58522, 59488, 60394, 61236, 62012,
+		62720, 63356, 63916, 64398, 64800, 65118, 65348, 65488,
+		65535
+	}
+};
+
+/**
+ * @brief Starts a fade.
+ *
+ * @param fade: The fade to start.
+ * @param start: The Q8 pulse values (R, G, B) to fade from.
+ * @param steps: Number of PWM periods the fade lasts (0 to jump).
+ * @param curve: The easing curve.
+ *
+ * @return None.
+ */
+void start_fade(FadeState *fade, const uint32_t start[3], uint32_t steps,
+		FadeCurve curve) {
+	fade->start[0] = start[0];
+	fade->start[1] = start[1];
+	fade->start[2] = start[2];
+	fade->progress = 0;
+	fade->step = (steps == 0) ? FADE_PROGRESS_ONE : FADE_PROGRESS_ONE / steps;
+	if (fade->step == 0) {
+		fade->step = 1;
+	}
+	fade->curve = (curve < NUM_FADE_CURVES) ? curve : FADE_LINEAR;
+	fade->running = 1;
+}
+
+/**
+ * @brief Looks up the eased fraction of a fade's progress.
+ *
+ * @param curve: The easing curve.
+ * @param progress: Q24 progress, below FADE_PROGRESS_ONE.
+ *
+ * @return The Q16 eased fraction.
+ */
+static uint32_t ease(FadeCurve curve, uint32_t progress) {
+	const uint32_t fraction_bits = FADE_PROGRESS_BITS - FADE_CURVE_BITS;
+	uint32_t index = progress >> fraction_bits;
+	uint32_t fraction = progress & ((1UL << fraction_bits) - 1);
+	uint32_t lower = fade_curves[curve][index];
+	uint32_t upper = fade_curves[curve][index + 1];
+	return lower + (((upper - lower) * fraction) >> fraction_bits);
+}
+
+/**
+ * @brief Moves a fade on by one PWM period.
+ *
+ * @param fade: The fade to advance.
+ * @param targets: The Q8 pulse values (R, G, B) being faded to.
+ * @param limit: Q8 value at which the output is fully off. Values above it
+ * (such as a held-off pulse) are faded to the limit and only reached at the
+ * end.
+ * @param outputs: Array to fill with the Q8 pulse values for this period.
+ *
+ * @return None.
+ */
+void advance_fade(FadeState *fade, const uint32_t targets[3], uint32_t limit,
+		uint32_t outputs[3]) {
+	if (fade->running) {
+		fade->progress += fade->step;
+		if (fade->progress >= FADE_PROGRESS_ONE) {
+			fade->running = 0;
+		}
+	}
+	if (!fade->running) {
+		outputs[0] = targets[0];
+		outputs[1] = targets[1];
+		outputs[2] = targets[2];
+		return;
+	}
+
+	int64_t eased = ease(fade->curve, fade->progress);
+	for (int colour = 0; colour < 3; colour++) {
+		int32_t start = (fade->start[colour] > limit) ?
+				limit : fade->start[colour];
+		int32_t target = (targets[colour] > limit) ? limit : targets[colour];
+		outputs[colour] = start
+				+ (int32_t) (((target - start) * eased) >> FADE_CURVE_SHIFT);
+	}
+}
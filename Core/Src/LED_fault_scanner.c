@@ -0,0 +1,412 @@
+/**
+ *******************************************************************************
+ * @file LED_fault_scanner.c
+ * @brief Background scan of the LED drivers' thermal and open LED flags.
+ *
+ * The scan is split into short slices run from the main loop, so no ISR ever
+ * clocks the drivers and the PWM is never touched. XERR only shows the thermal
+ * flag while the lit chains are blanked and LOD is only latched while they are
+ * unblanked, so both are sampled inside the matching part of the PWM period.
+ *
+ * Each scan:
+ *  1. Shifts the current on/off words back in (XLAT leaves LOD data in the
+ *     shift registers, so they no longer hold the words).
+ *  2. Reads each lit chain's XERR while that chain's BLANK is high (the
+ *     colours are out of phase, see LED_pwm.c, so they may never all be
+ *     blanked at once).
+ *  3. Pulses XLAT while every lit chain's BLANK is low, which latches the same
+ *     words again and loads the LOD data.
+ *  4. Clocks the LOD data out through SOUT.
+ *  5. Compares the result with the last fault set.
+ *
+ * If a frame is latched by anything else part way through, the scan restarts.
+ * While the BCM engine runs it owns the driver lines, so it is held between
+ * two of its cycles for the length of the scan (see hold_bcm()).
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include "stm32f3xx_hal.h"
+#include <stdint.h>
+#include <stdio.h>
+#include "main.h"
+#include "hardware_defines.h"
+#include "globals.h"
+#include "LED_fault_scanner.h"
+#include "LED_shift_engine.h"
+#include "LED_driver_config.h"
+#include "LED_bcm.h"
+#include "debug_flags.h"
+
+/**
+ * @brief Represents the phases of a scan.
+ */
+typedef enum {
+	SCAN_IDLE,			///< Waiting for a request or the next period.
+	SCAN_LOAD_MASKS,	///< Shifting the on/off words back in.
+	SCAN_READ_TEF,		///< Waiting for a blanked window to read XERR.
+	SCAN_LATCH_LOD,		///< Waiting for an unblanked window to pulse XLAT.
+	SCAN_READ_LOD,		///< Clocking the LOD data out.
+	SCAN_EVALUATE		///< Comparing the result with the last fault set.
+} ScanPhase;
+
+static ScanPhase scan_phase = SCAN_IDLE;
+static volatile uint8_t scan_requested = 0;
+static uint32_t last_scan_time = 0;
+static uint32_t window_start_time;		///< When the window search started.
+static uint32_t scan_frame_count;		///< Shift engine frames at scan start.
+static uint16_t scan_masks[3];			///< On/off words being scanned.
+static uint8_t scan_bit;				///< Bits left to clock in this phase.
+static uint16_t scan_lod[3];			///< LOD words being clocked out.
+static uint8_t scan_thermal;			///< LED_CHAIN_x bits read from XERR.
+static uint8_t scan_tef_pending;		///< Chains whose XERR is still unread.
+
+static GPIO_TypeDef *const xerr_ports[3] = { XERR_R_GPIO_Port,
+		XERR_G_GPIO_Port, XERR_B_GPIO_Port };
+static const uint16_t xerr_pins[3] = { XERR_R_Pin, XERR_G_Pin, XERR_B_Pin };
+
+static uint16_t fault_lod[3];			///< Current open LED words.
+static uint8_t fault_thermal = 0;		///< Current thermal error chains.
+static uint16_t fault_counts[3][NUM_LEDS];
+static LEDFaultRecord fault_history[FAULT_HISTORY_LENGTH];
+static uint8_t history_head = 0;		///< Index of the next record.
+static uint8_t history_count = 0;
+
+/**
+ * @brief Requests a scan at the next main loop slice (safe to call from ISRs).
+ *
+ * @return None.
+ */
+void request_led_fault_scan(void) {
+	scan_requested = 1;
+}
+
+/**
+ * @brief Checks whether the BLANK line of every given chain is at a level.
+ *
+ * A margin is kept before the next edge so a pin access made straight after
+ * the check still lands inside the window.
+ *
+ * @param chains: LED_CHAIN_x bits of the chains to check.
+ * @param level: GPIO_PIN_SET for blanked, GPIO_PIN_RESET for unblanked.
+ *
+ * @return 1 if every chain is at the level, 0 otherwise.
+ */
+static uint8_t blank_window(uint8_t chains, GPIO_PinState level) {
+	uint32_t margin = FAULT_SCAN_WINDOW_MARGIN * (SystemCoreClock / 1000000)
+			/ (active_pwm_profile->prescaler + 1);
+
+	for (int chain = 0; chain < 3; chain++) {
+		if (!(chains & (1 << chain))) {
+			continue;
+		}
+		if (get_blank_time_left(chain, level) <= margin) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * @brief Returns the LED_CHAIN_x bits of the chains with any LED on.
+ *
+ * @return The lit chains.
+ */
+static uint8_t lit_chains(void) {
+	return (scan_masks[0] ? LED_CHAIN_RED : 0)
+			| (scan_masks[1] ? LED_CHAIN_GREEN : 0)
+			| (scan_masks[2] ? LED_CHAIN_BLUE : 0);
+}
+
+/**
+ * @brief Clocks up to FAULT_SCAN_BITS_PER_SLICE bits of the scanned words.
+ *
+ * @param lod: Array to collect the SOUT bits in (NULL to ignore SOUT).
+ *
+ * @return None.
+ */
+static void clock_scan_bits(uint16_t *lod) {
+	for (int i = 0; (i < FAULT_SCAN_BITS_PER_SLICE) && (scan_bit > 0); i++) {
+		scan_bit--;
+		HAL_GPIO_WritePin(SIN_R_GPIO_Port, SIN_R_Pin,
+				(scan_masks[0] >> scan_bit) & 1);
+		HAL_GPIO_WritePin(SIN_G_GPIO_Port, SIN_G_Pin,
+				(scan_masks[1] >> scan_bit) & 1);
+		HAL_GPIO_WritePin(SIN_B_GPIO_Port, SIN_B_Pin,
+				(scan_masks[2] >> scan_bit) & 1);
+		if (lod != NULL) {
+			/* The MSB (LED 16) is on SOUT before the first clock. */
+			lod[0] |= HAL_GPIO_ReadPin(SOUT_R_GPIO_Port, SOUT_R_Pin) << scan_bit;
+			lod[1] |= HAL_GPIO_ReadPin(SOUT_G_GPIO_Port, SOUT_G_Pin) << scan_bit;
+			lod[2] |= HAL_GPIO_ReadPin(SOUT_B_GPIO_Port, SOUT_B_Pin) << scan_bit;
+		}
+		HAL_GPIO_WritePin(SCLK_GPIO_Port, SCLK_Pin, SET);
+		HAL_GPIO_WritePin(SCLK_GPIO_Port, SCLK_Pin, RESET);
+	}
+}
+
+/**
+ * @brief Starts (or restarts) a scan of the given on/off words.
+ *
+ * @param masks: The words currently latched in the three chains.
+ *
+ * @return None.
+ */
+static void start_scan(uint16_t masks[3]) {
+	scan_masks[0] = masks[0];
+	scan_masks[1] = masks[1];
+	scan_masks[2] = masks[2];
+	scan_frame_count = get_shift_frame_count();
+	scan_bit = SHIFT_BITS_PER_CHAIN;
+	scan_phase = SCAN_LOAD_MASKS;
+
+	HAL_GPIO_WritePin(MODE_GPIO_Port, MODE_Pin, RESET);
+	HAL_GPIO_WritePin(XLAT_GPIO_Port, XLAT_Pin, RESET);
+	HAL_GPIO_WritePin(SCLK_GPIO_Port, SCLK_Pin, RESET);
+}
+
+/**
+ * @brief Updates the fault set, counters and history from a finished scan.
+ *
+ * Only open LEDs that are switched on can be detected, so the LOD words are
+ * masked with the scanned on/off words. The fault flag is only raised when
+ * the fault set differs from the last one.
+ *
+ * @param current_time: System time when the scan finished.
+ *
+ * @return None.
+ */
+static void evaluate_scan(uint32_t current_time) {
+	uint16_t lod[3];
+	for (int chain = 0; chain < 3; chain++) {
+		lod[chain] = scan_lod[chain] & scan_masks[chain];
+	}
+
+	if ((lod[0] == fault_lod[0]) && (lod[1] == fault_lod[1])
+			&& (lod[2] == fault_lod[2]) && (scan_thermal == fault_thermal)) {
+		return;
+	}
+
+	/* Count each LED's transitions into the open state. */
+	for (int chain = 0; chain < 3; chain++) {
+		uint16_t new_faults = lod[chain] & ~fault_lod[chain];
+		for (int led = 0; led < NUM_LEDS; led++) {
+			if (((new_faults >> led) & 1)
+					&& (fault_counts[chain][led] < UINT16_MAX)) {
+				fault_counts[chain][led]++;
+			}
+		}
+		fault_lod[chain] = lod[chain];
+	}
+	fault_thermal = scan_thermal;
+
+	LEDFaultRecord *record = &fault_history[history_head];
+	record->time = current_time;
+	record->lod[0] = lod[0];
+	record->lod[1] = lod[1];
+	record->lod[2] = lod[2];
+	record->thermal = scan_thermal;
+	history_head = (history_head + 1) % FAULT_HISTORY_LENGTH;
+	if (history_count < FAULT_HISTORY_LENGTH) {
+		history_count++;
+	}
+
+	red_thermal_error_flag = (scan_thermal & LED_CHAIN_RED) != 0;
+	green_thermal_error_flag = (scan_thermal & LED_CHAIN_GREEN) != 0;
+	blue_thermal_error_flag = (scan_thermal & LED_CHAIN_BLUE) != 0;
+	red_lod_flag = lod[0];
+	green_lod_flag = lod[1];
+	blue_lod_flag = lod[2];
+	led_fault_flag = FAULTS_CHANGED;
+}
+
+/**
+ * @brief Runs the next slice of the scan (called from the main loop).
+ *
+ * A scan starts every FAULT_SCAN_PERIOD ms or as soon as one is requested.
+ * Nothing is done while the shift engine is busy, as it owns the driver
+ * lines. A running BCM engine is held for the scan and released after it.
+ *
+ * @return None.
+ */
+void service_led_fault_scan(void) {
+	uint32_t current_time = HAL_GetTick();
+	if ((scan_phase == SCAN_IDLE) && (!scan_requested)
+			&& (current_time - last_scan_time < FAULT_SCAN_PERIOD)) {
+		return;
+	}
+	if (shift_engine_busy()) {
+		return;
+	}
+
+	uint16_t masks[3];
+	uint8_t masks_known;
+	if (bcm_running()) {
+		hold_bcm();
+		if (!get_bcm_held_masks(masks)) {
+			return;		/* Wait for the current cycle to end. */
+		}
+		masks_known = 1;
+	} else {
+		masks_known = get_latched_LED_masks(masks);
+	}
+
+	if (scan_phase == SCAN_IDLE) {
+		if (masks_known) {
+			scan_requested = 0;
+			start_scan(masks);
+		}
+		return;
+	}
+
+	/* Restart if anything else has latched the drivers since the scan began. */
+	if (!masks_known) {
+		scan_phase = SCAN_IDLE;
+		scan_requested = 1;
+		return;
+	}
+	if ((get_shift_frame_count() != scan_frame_count)
+			|| (masks[0] != scan_masks[0]) || (masks[1] != scan_masks[1])
+			|| (masks[2] != scan_masks[2])) {
+		start_scan(masks);
+		return;
+	}
+
+	uint32_t primask;
+	switch (scan_phase) {
+	case SCAN_LOAD_MASKS:
+		clock_scan_bits(NULL);
+		if (scan_bit == 0) {
+			scan_phase = SCAN_READ_TEF;
+			scan_thermal = 0;
+			scan_tef_pending = lit_chains();
+			window_start_time = current_time;
+		}
+		break;
+
+	case SCAN_READ_TEF:
+		/* XERR also shows open LEDs in unblanked chains. */
+		for (int chain = 0; chain < 3; chain++) {
+			if (!(scan_tef_pending & (1 << chain))) {
+				continue;
+			}
+			primask = __get_PRIMASK();
+			__disable_irq();
+			if (blank_window(1 << chain, GPIO_PIN_SET)) {
+				if (!HAL_GPIO_ReadPin(xerr_ports[chain], xerr_pins[chain])) {
+					scan_thermal |= (1 << chain);
+				}
+				scan_tef_pending &= ~(1 << chain);
+			}
+			__set_PRIMASK(primask);
+		}
+		if (scan_tef_pending
+				&& (current_time - window_start_time
+						< FAULT_SCAN_WINDOW_TIMEOUT)) {
+			break;
+		}
+		/* Never blanked (full brightness): keep the last reading. */
+		scan_thermal |= fault_thermal & scan_tef_pending;
+		scan_phase = SCAN_LATCH_LOD;
+		window_start_time = current_time;
+		break;
+
+	case SCAN_LATCH_LOD:
+		primask = __get_PRIMASK();
+		__disable_irq();
+		if (blank_window(lit_chains(), GPIO_PIN_RESET)) {
+			HAL_GPIO_WritePin(XLAT_GPIO_Port, XLAT_Pin, SET);
+			HAL_GPIO_WritePin(XLAT_GPIO_Port, XLAT_Pin, RESET);
+			__set_PRIMASK(primask);
+			scan_lod[0] = 0;
+			scan_lod[1] = 0;
+			scan_lod[2] = 0;
+			scan_bit = SHIFT_BITS_PER_CHAIN;
+			scan_phase = SCAN_READ_LOD;
+		} else {
+			__set_PRIMASK(primask);
+			if (current_time - window_start_time >= FAULT_SCAN_WINDOW_TIMEOUT) {
+				/* Never unblanked (LEDs off): keep the last LOD words. */
+				scan_lod[0] = fault_lod[0];
+				scan_lod[1] = fault_lod[1];
+				scan_lod[2] = fault_lod[2];
+				scan_phase = SCAN_EVALUATE;
+			}
+		}
+		break;
+
+	case SCAN_READ_LOD:
+		/* The scanned words are clocked back in behind the LOD data. */
+		clock_scan_bits(scan_lod);
+		if (scan_bit == 0) {
+			scan_phase = SCAN_EVALUATE;
+		}
+		break;
+
+	case SCAN_EVALUATE:
+		evaluate_scan(current_time);
+		last_scan_time = current_time;
+		scan_phase = SCAN_IDLE;
+		release_bcm();
+		break;
+
+	default:
+		scan_phase = SCAN_IDLE;
+		break;
+	}
+}
+
+/**
+ * @brief Returns how many times an LED has been found open.
+ *
+ * @param chain: Chain index (0 red, 1 green, 2 blue).
+ * @param led: LED index (0 is LED 1).
+ *
+ * @return The number of times the LED went open (saturates at UINT16_MAX).
+ */
+uint16_t get_led_fault_count(uint8_t chain, uint8_t led) {
+	if ((chain >= 3) || (led >= NUM_LEDS)) {
+		return 0;
+	}
+	return fault_counts[chain][led];
+}
+
+/**
+ * @brief Copies the fault set history, oldest first.
+ *
+ * @param history: Array to fill with the records.
+ *
+ * @return The number of records copied.
+ */
+uint8_t get_led_fault_history(LEDFaultRecord history[FAULT_HISTORY_LENGTH]) {
+	uint8_t oldest = (history_head + FAULT_HISTORY_LENGTH - history_count)
+			% FAULT_HISTORY_LENGTH;
+	for (int i = 0; i < history_count; i++) {
+		history[i] = fault_history[(oldest + i) % FAULT_HISTORY_LENGTH];
+	}
+	return history_count;
+}
+
+/**
+ * @brief Reports the current fault set over SWO.
+ *
+ * @return None.
+ */
+void report_led_faults(void) {
+#ifdef DEBUG_LED_DRIVERS
+	printf("\nLED fault set changed at %lu ms\n", last_scan_time);
+	printf("\nThermal Error Flags\n");
+	printf("R: %u\n", red_thermal_error_flag);
+	printf("G: %u\n", green_thermal_error_flag);
+	printf("B: %u\n", blue_thermal_error_flag);
+	printf("\nLOD Status Data\n");
+	printf("R: ");
+	print_binary(red_lod_flag);
+	printf("G: ");
+	print_binary(green_lod_flag);
+	printf("B: ");
+	print_binary(blue_lod_flag);
+#endif /* DEBUG_LED_DRIVERS */
+}
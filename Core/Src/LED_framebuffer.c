@@ -0,0 +1,285 @@
+/**
+ *******************************************************************************
+ * @file LED_framebuffer.c
+ * @brief Single owner of the LED on/off words and RGB pulse values.
+ *
+ * Producers (state machine, colour control, calibration) write the state they
+ * want into the framebuffer. Writes that change nothing are dropped, and the
+ * rest mark their part dirty. flush_framebuffer() is called once per main
+ * loop tick and pushes only the dirty parts to the shift engine and the timer
+ * compare registers. Blocking flows that need the LEDs to change before they
+ * continue (calibration measurements) flush explicitly.
+ *
+ * Notification animations are laid over the pulse values rather than
+ * replacing them, so the live output comes back unchanged when they end.
+ *
+ * Per-LED levels can be set on top of the on/off words. While they are, the
+ * flush hands the LEDs that are on to the BCM engine at their level instead
+ * of shifting the words directly. BCM_PWM_PROFILE is switched to for as long
+ * as BCM runs, and the previous profile comes back once every LED is off or
+ * the levels are cleared.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include "stm32f3xx_hal.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "globals.h"
+#include "colour_control.h"
+#include "LED_framebuffer.h"
+#include "LED_driver_config.h"
+#include "LED_bcm.h"
+#include "LED_pwm.h"
+#include "debug_flags.h"
+
+/* Nothing is known to be in the hardware yet, so the first flush writes all. */
+static LEDFramebuffer framebuffer = { { LED_MASK_NONE, LED_MASK_NONE,
+		LED_MASK_NONE }, { { 0 } }, 0, { PULSE_TO_Q8(PWM_PULSE_OFF),
+		PULSE_TO_Q8(PWM_PULSE_OFF), PULSE_TO_Q8(PWM_PULSE_OFF) }, {
+		FRAMEBUFFER_NO_OVERLAY, FRAMEBUFFER_NO_OVERLAY, FRAMEBUFFER_NO_OVERLAY },
+		FRAMEBUFFER_DIRTY_ALL };
+
+static uint8_t bcm_profile_held = 0;	///< BCM_PWM_PROFILE forced for BCM.
+static PwmProfileId restore_profile;	///< Profile to go back to after BCM.
+
+/**
+ * @brief Sets the on/off words of the three chains.
+ *
+ * @param red_mask: On/off word for the red chain.
+ * @param green_mask: On/off word for the green chain.
+ * @param blue_mask: On/off word for the blue chain.
+ *
+ * @return None.
+ */
+void framebuffer_set_masks(uint16_t red_mask, uint16_t green_mask,
+		uint16_t blue_mask) {
+	if ((red_mask == framebuffer.masks[0])
+			&& (green_mask == framebuffer.masks[1])
+			&& (blue_mask == framebuffer.masks[2])) {
+		return;
+	}
+	framebuffer.masks[0] = red_mask;
+	framebuffer.masks[1] = green_mask;
+	framebuffer.masks[2] = blue_mask;
+	framebuffer.dirty |= FRAMEBUFFER_DIRTY_MASKS;
+}
+
+/**
+ * @brief Sets the BCM level of every LED, or goes back to plain on/off.
+ *
+ * Levels only apply to LEDs that are on in the on/off words. The flush runs
+ * BCM under BCM_PWM_PROFILE while any LED is on, and stops it and restores
+ * the previous profile while they are all off.
+ *
+ * @param levels: Level of each LED per colour (0 to BCM_MAX_LEVEL), or NULL
+ * to stop using levels.
+ *
+ * @return None.
+ */
+void framebuffer_set_levels(uint8_t levels[3][NUM_LEDS]) {
+	if (levels == NULL) {
+		if (framebuffer.use_levels) {
+			framebuffer.use_levels = 0;
+			framebuffer.dirty |= FRAMEBUFFER_DIRTY_MASKS;
+		}
+		return;
+	}
+	if (framebuffer.use_levels
+			&& (memcmp(levels, framebuffer.levels, sizeof(framebuffer.levels))
+					== 0)) {
+		return;
+	}
+	memcpy(framebuffer.levels, levels, sizeof(framebuffer.levels));
+	framebuffer.use_levels = 1;
+	framebuffer.dirty |= FRAMEBUFFER_DIRTY_MASKS;
+}
+
+/**
+ * @brief Sets the BLANK pulse values of the three colours.
+ *
+ * @param pulse_values: Array of three pulse values (R, G, B).
+ *
+ * @return None.
+ */
+void framebuffer_set_pulses(uint16_t *pulse_values) {
+	uint32_t pulse_values_q8[3] = { PULSE_TO_Q8(pulse_values[0]),
+			PULSE_TO_Q8(pulse_values[1]), PULSE_TO_Q8(pulse_values[2]) };
+	framebuffer_set_pulses_q8(pulse_values_q8);
+}
+
+/**
+ * @brief Sets the BLANK pulse values of the three colours with a fraction.
+ *
+ * @param pulse_values: Array of three Q8 pulse values (R, G, B).
+ *
+ * @return None.
+ */
+void framebuffer_set_pulses_q8(uint32_t *pulse_values) {
+	if ((pulse_values[0] == framebuffer.pulses[0])
+			&& (pulse_values[1] == framebuffer.pulses[1])
+			&& (pulse_values[2] == framebuffer.pulses[2])) {
+		return;
+	}
+	framebuffer.pulses[0] = pulse_values[0];
+	framebuffer.pulses[1] = pulse_values[1];
+	framebuffer.pulses[2] = pulse_values[2];
+	framebuffer.dirty |= FRAMEBUFFER_DIRTY_PULSES;
+}
+
+/**
+ * @brief Sets pulse values to show in place of the stored ones.
+ *
+ * @param pulse_values: Array of three Q8 pulse values (R, G, B), each
+ * FRAMEBUFFER_NO_OVERLAY to show the stored value, or NULL to clear.
+ *
+ * @return None.
+ */
+void framebuffer_set_overlay(uint32_t *pulse_values) {
+	for (int colour = 0; colour < 3; colour++) {
+		uint32_t overlay =
+				(pulse_values == NULL) ?
+						FRAMEBUFFER_NO_OVERLAY : pulse_values[colour];
+		if (overlay != framebuffer.overlay[colour]) {
+			framebuffer.overlay[colour] = overlay;
+			framebuffer.dirty |= FRAMEBUFFER_DIRTY_PULSES;
+		}
+	}
+}
+
+/**
+ * @brief Rescales the stored pulse values and switches the PWM profile.
+ *
+ * @param profile: The profile to switch to.
+ *
+ * @return None.
+ */
+static void switch_pwm_profile(PwmProfileId profile) {
+	uint16_t old_period = COUNTER_PERIOD;
+	uint16_t new_period = pwm_profiles[profile].period;
+
+	/* The planes are timed for the old profile; the flush restarts BCM. */
+	if (bcm_running()) {
+		stop_bcm();
+		framebuffer.dirty |= FRAMEBUFFER_DIRTY_MASKS;
+	}
+	for (int colour = 0; colour < 3; colour++) {
+		framebuffer.pulses[colour] = rescale_pulse_value(
+				framebuffer.pulses[colour], old_period, new_period);
+		if (framebuffer.overlay[colour] != FRAMEBUFFER_NO_OVERLAY) {
+			framebuffer.overlay[colour] = rescale_pulse_value(
+					framebuffer.overlay[colour], old_period, new_period);
+		}
+	}
+	set_pwm_profile(profile);
+}
+
+/**
+ * @brief Switches the PWM profile, keeping the stored pulse values in scale.
+ *
+ * While BCM holds BCM_PWM_PROFILE, the profile is only taken once BCM stops.
+ *
+ * @param profile: The profile to switch to.
+ *
+ * @return None.
+ */
+void framebuffer_set_pwm_profile(PwmProfileId profile) {
+	if (profile >= NUM_PWM_PROFILES) {
+		return;
+	}
+	if (bcm_profile_held) {
+		restore_profile = profile;
+		return;
+	}
+	switch_pwm_profile(profile);
+}
+
+/**
+ * @brief Stops BCM and goes back to the profile it replaced.
+ *
+ * @return None.
+ */
+static void release_bcm_profile(void) {
+	if (bcm_running()) {
+		stop_bcm();
+	}
+	if (bcm_profile_held) {
+		bcm_profile_held = 0;
+		switch_pwm_profile(restore_profile);
+	}
+}
+
+/**
+ * @brief Shows the on/off words at the set levels with the BCM engine.
+ *
+ * @return 1 if BCM is showing them, 0 if they are all off or BCM cannot run.
+ */
+static uint8_t flush_levels(void) {
+	if ((framebuffer.masks[0] == LED_MASK_NONE)
+			&& (framebuffer.masks[1] == LED_MASK_NONE)
+			&& (framebuffer.masks[2] == LED_MASK_NONE)) {
+		return 0;
+	}
+	if (!bcm_profile_held) {
+		restore_profile = (PwmProfileId) (active_pwm_profile - pwm_profiles);
+		switch_pwm_profile(BCM_PWM_PROFILE);
+		bcm_profile_held = 1;
+	}
+
+	uint8_t shown[3][NUM_LEDS];
+	for (int chain = 0; chain < 3; chain++) {
+		for (int led = 0; led < NUM_LEDS; led++) {
+			shown[chain][led] = ((framebuffer.masks[chain] >> led) & 1) ?
+					framebuffer.levels[chain][led] : 0;
+		}
+	}
+	set_bcm_levels(shown);
+	if (start_bcm() != BCM_OK) {
+#ifdef DEBUG_LED_DRIVERS
+		printf("PWM profile too slow for BCM, showing on/off words\n");
+#endif /* DEBUG_LED_DRIVERS */
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * @brief Pushes the dirty parts of the framebuffer to the hardware.
+ *
+ * @return The status of the LED drivers.
+ */
+LED_Driver_Status flush_framebuffer(void) {
+	LED_Driver_Status status = LED_DRIVER_OK;
+	if (framebuffer.dirty & FRAMEBUFFER_DIRTY_MASKS) {
+		if (!framebuffer.use_levels || !flush_levels()) {
+			release_bcm_profile();
+			status = set_LED_masks(framebuffer.masks[0], framebuffer.masks[1],
+					framebuffer.masks[2]);
+		}
+		/* Left dirty on failure, so the next tick tries again. */
+		if (status == LED_DRIVER_OK) {
+			framebuffer.dirty &= ~FRAMEBUFFER_DIRTY_MASKS;
+		}
+#ifdef DEBUG_LED_DRIVERS
+		if (status != LED_DRIVER_OK) {
+			printf("Framebuffer flush failed: %u\n", status);
+		}
+#endif /* DEBUG_LED_DRIVERS */
+	}
+	if (framebuffer.dirty & FRAMEBUFFER_DIRTY_PULSES) {
+		framebuffer.dirty &= ~FRAMEBUFFER_DIRTY_PULSES;
+		uint32_t pulse_values[3];
+		for (int colour = 0; colour < 3; colour++) {
+			pulse_values[colour] =
+					(framebuffer.overlay[colour] == FRAMEBUFFER_NO_OVERLAY) ?
+							framebuffer.pulses[colour] :
+							framebuffer.overlay[colour];
+		}
+		set_pulse_values(pulse_values);
+	}
+
+	return status;
+}
@@ -0,0 +1,598 @@
+/**
+ *******************************************************************************
+ * @file LED_pwm.c
+ * @brief Tear-free updates of the BLANK pulse values.
+ *
+ * The compare registers are preloaded, so new values only take effect at the
+ * next update event. The red and blue values (TIM3 CCR3/CCR1) are written
+ * together by a DMA burst (TIMx_DCR/DMAR) on the TIM3 update event, which
+ * means they always land in the same period. The green value (TIM15 CCR1) is
+ * written from the burst complete interrupt, straight after that update.
+ *
+ * Committing only fills the idle buffer and hands it over, so a commit made
+ * while a burst is waiting for its update simply replaces the queued values.
+ *
+ * The timebase of both timers comes from the active PwmProfile, which is also
+ * the source of COUNTER_PERIOD for all of the colour maths.
+ *
+ * TIM15 runs as a slave of TIM3. TIM3 puts OC2REF (PWM mode 2 on the unused
+ * CH2) on TRGO, and TIM15 is reset by it, so green starts PWM_GREEN_PHASE of
+ * a period after red. With PWM_BLUE_TRAILING, blue's BLANK uses PWM mode 2 so
+ * its on-time ends, rather than starts, at the TIM3 update. This keeps the
+ * three colours from switching together. Blue's compare value is then
+ * period + 1 - pulse, converted where the register is written or read.
+ *
+ * With PWM_DITHER, pulse values carry PWM_FRACTION_BITS of fraction and the
+ * bursts are replaced by the TIM3 update interrupt. Each period it adds the
+ * fraction to an accumulator per colour and writes the whole part plus the
+ * carry, so the compare value alternates between neighbours and averages out
+ * to the fractional value (first order sigma-delta). Only the top
+ * PWM_DITHER_BITS of the fraction are used to keep the pattern well above the
+ * flicker threshold (16 periods at 4 bits).
+ *
+ * The same interrupt steps fades (see LED_fade.c): start_pwm_fade() freezes
+ * the current output, and each period the output moves one step from there
+ * towards the committed values until the fade ends. Without PWM_DITHER there
+ * is no per-period interrupt, so fades are skipped and commits apply at once.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include "stm32f3xx_hal.h"
+#include <stdint.h>
+#include <stdio.h>
+#include "main.h"
+#include "globals.h"
+#include "LED_pwm.h"
+#include "debug_flags.h"
+
+DMA_HandleTypeDef hdma_tim3_up;
+
+const PwmProfile pwm_profiles[NUM_PWM_PROFILES] = {
+		[PWM_PROFILE_STANDARD] = { 7, 1000 },
+		[PWM_PROFILE_FAST] = { 0, 1000 },
+		[PWM_PROFILE_12_BIT] = { 0, 4000 },
+		[PWM_PROFILE_16_BIT] = { 0, PWM_MAX_PERIOD } };
+
+/* Matches the timebase set up by MX_TIM3_Init() and MX_TIM15_Init(). */
+const PwmProfile *volatile active_pwm_profile =
+		&pwm_profiles[PWM_PROFILE_STANDARD];
+
+#ifndef PWM_DITHER
+static uint32_t burst_buffers[2][PWM_BURST_LENGTH];	///< TIM3 CCR1 to CCR3.
+static uint16_t green_pulses[2];				///< TIM15 CCR1 per buffer.
+static volatile uint8_t active_buffer = 0;		///< Buffer of the last burst.
+static volatile uint8_t burst_active = 0;		///< A burst awaits its update.
+static volatile uint8_t burst_pending = 0;		///< The idle buffer is queued.
+#else
+static uint32_t dither_targets[2][3];			///< Q8 pulse values (R, G, B).
+static volatile uint8_t dither_front = 0;		///< Targets used by the ISR.
+static uint8_t dither_accumulators[3];
+static FadeState fade;							///< Fade being stepped.
+static uint32_t fade_outputs[3];				///< Last Q8 output (R, G, B).
+#endif /* PWM_DITHER */
+
+/* Fully on blue needs a compare of period + 1 in the 16-bit CCR1. */
+_Static_assert(PWM_MAX_PERIOD + 1 <= UINT16_MAX,
+		"blue's full-on compare must fit TIM3 CCR1");
+
+/**
+ * @brief Converts a blue pulse value to its TIM3 CCR1 compare value.
+ *
+ * @param pulse_value: Blue pulse value (0 fully on to period, or off).
+ * @param period: Counter period the value is for.
+ *
+ * @return The compare value.
+ */
+static uint32_t blue_compare(uint16_t pulse_value, uint16_t period) {
+#ifdef PWM_BLUE_TRAILING
+	/* PWM mode 2: BLANK is high from the compare value to the end. */
+	return (pulse_value > period) ? 0 : (uint32_t) period + 1 - pulse_value;
+#else
+	(void) period;
+	return pulse_value;
+#endif /* PWM_BLUE_TRAILING */
+}
+
+/**
+ * @brief Converts a TIM3 CCR1 compare value back to a blue pulse value.
+ *
+ * @param compare: The compare value.
+ * @param period: Counter period the value is for.
+ *
+ * @return The blue pulse value.
+ */
+static uint16_t blue_pulse(uint32_t compare, uint16_t period) {
+#ifdef PWM_BLUE_TRAILING
+	return (compare == 0) ? PWM_PULSE_OFF : (uint16_t) (period + 1 - compare);
+#else
+	(void) period;
+	return compare;
+#endif /* PWM_BLUE_TRAILING */
+}
+
+/**
+ * @brief Works out the TIM3 CCR2 value that resets TIM15.
+ *
+ * @param period: Counter period of the profile.
+ *
+ * @return The compare value.
+ */
+static uint32_t green_phase_compare(uint16_t period) {
+	return (((uint32_t) period + 1) * PWM_GREEN_PHASE) >> 16;
+}
+
+/**
+ * @brief Sets up blue's PWM mode and the TIM3 to TIM15 synchronisation.
+ *
+ * Must be called before the timers are started.
+ *
+ * @return None.
+ */
+static void initialise_pwm_sync(void) {
+	TIM_OC_InitTypeDef sConfigOC = { 0 };
+	TIM_MasterConfigTypeDef sMasterConfig = { 0 };
+	TIM_SlaveConfigTypeDef sSlaveConfig = { 0 };
+
+	/* CH2 is never started, so OC2REF only drives TRGO. */
+	sConfigOC.OCMode = TIM_OCMODE_PWM2;
+	sConfigOC.Pulse = green_phase_compare(htim3.Init.Period);
+	sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+	sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+	if (HAL_TIM_PWM_ConfigChannel(&htim3, &sConfigOC, TIM_CHANNEL_2)
+			!= HAL_OK) {
+		Error_Handler();
+	}
+
+#ifdef PWM_BLUE_TRAILING
+	/* Start with blue off (BLANK high for the whole period). */
+	sConfigOC.Pulse = 0;
+	if (HAL_TIM_PWM_ConfigChannel(&htim3, &sConfigOC, TIM_CHANNEL_1)
+			!= HAL_OK) {
+		Error_Handler();
+	}
+#endif /* PWM_BLUE_TRAILING */
+
+#if PWM_GREEN_PHASE == 0
+	sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
+#else
+	sMasterConfig.MasterOutputTrigger = TIM_TRGO_OC2REF;
+#endif /* PWM_GREEN_PHASE */
+	sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+	if (HAL_TIMEx_MasterConfigSynchronization(&htim3, &sMasterConfig)
+			!= HAL_OK) {
+		Error_Handler();
+	}
+
+	/* ITR1 of TIM15 is TIM3 TRGO. */
+	sSlaveConfig.SlaveMode = TIM_SLAVEMODE_RESET;
+	sSlaveConfig.InputTrigger = TIM_TS_ITR1;
+	if (HAL_TIM_SlaveConfigSynchro(&htim15, &sSlaveConfig) != HAL_OK) {
+		Error_Handler();
+	}
+}
+
+#ifndef PWM_DITHER
+/**
+ * @brief Starts a burst of one buffer on the next TIM3 update event.
+ *
+ * @param buffer: Index of the buffer to write.
+ *
+ * @return None.
+ */
+static void start_pwm_burst(uint8_t buffer) {
+	active_buffer = buffer;
+	burst_active = 1;
+	if (HAL_TIM_DMABurst_WriteStart(&htim3, TIM_DMABASE_CCR1, TIM_DMA_UPDATE,
+			burst_buffers[buffer], TIM_DMABURSTLENGTH_3TRANSFERS) != HAL_OK) {
+		/* Fall back to writing the preload registers directly. */
+		burst_active = 0;
+		__HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_1, burst_buffers[buffer][0]);
+		__HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_3, burst_buffers[buffer][2]);
+		__HAL_TIM_SET_COMPARE(&htim15, TIM_CHANNEL_1, green_pulses[buffer]);
+	}
+}
+#endif /* PWM_DITHER */
+
+/**
+ * @brief Sets up the commit path and the TIM3 to TIM15 synchronisation.
+ *
+ * Configures DMA1 Channel 3 (TIM3_UP) for the compare register bursts, or the
+ * TIM3 update interrupt with PWM_DITHER. The compare preload of each BLANK
+ * channel is already enabled by the PWM channel configuration.
+ *
+ * @return None.
+ */
+void initialise_pwm_commit(void) {
+	initialise_pwm_sync();
+
+#ifndef PWM_DITHER
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	hdma_tim3_up.Instance = DMA1_Channel3;
+	hdma_tim3_up.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	hdma_tim3_up.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma_tim3_up.Init.MemInc = DMA_MINC_ENABLE;
+	hdma_tim3_up.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+	hdma_tim3_up.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+	hdma_tim3_up.Init.Mode = DMA_NORMAL;
+	hdma_tim3_up.Init.Priority = DMA_PRIORITY_MEDIUM;
+	if (HAL_DMA_Init(&hdma_tim3_up) != HAL_OK) {
+		Error_Handler();
+	}
+	__HAL_LINKDMA(&htim3, hdma[TIM_DMA_ID_UPDATE], hdma_tim3_up);
+
+	HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, 0, 0);
+	HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+#else
+	/* Start with every colour off until the first commit. */
+	for (int colour = 0; colour < 3; colour++) {
+		dither_targets[0][colour] = PULSE_TO_Q8(PWM_PULSE_OFF);
+		dither_targets[1][colour] = PULSE_TO_Q8(PWM_PULSE_OFF);
+		fade_outputs[colour] = PULSE_TO_Q8(PWM_PULSE_OFF);
+	}
+	HAL_NVIC_SetPriority(TIM3_IRQn, 0, 0);
+	HAL_NVIC_EnableIRQ(TIM3_IRQn);
+	__HAL_TIM_ENABLE_IT(&htim3, TIM_IT_UPDATE);
+#endif /* PWM_DITHER */
+
+	set_pwm_profile(PWM_DEFAULT_PROFILE);
+#ifdef DEBUG_INIT
+	printf("PWM COMMIT INITIALISED\n");
+#endif /* DEBUG_INIT */
+}
+
+/**
+ * @brief Stages new pulse values to be applied together at the next period.
+ *
+ * @param pulse_values: Array of three pulse values (R, G, B).
+ *
+ * @return None.
+ */
+void commit_pulse_values(uint16_t *pulse_values) {
+	uint32_t pulse_values_q8[3] = { PULSE_TO_Q8(pulse_values[0]),
+			PULSE_TO_Q8(pulse_values[1]), PULSE_TO_Q8(pulse_values[2]) };
+	commit_pulse_values_q8(pulse_values_q8);
+}
+
+/**
+ * @brief Stages new Q8 pulse values to be applied from the next period.
+ *
+ * Without PWM_DITHER the values are rounded to whole counts.
+ *
+ * @param pulse_values: Array of three Q8 pulse values (R, G, B).
+ *
+ * @return None.
+ */
+void commit_pulse_values_q8(uint32_t *pulse_values) {
+#ifdef PWM_DITHER
+	/* Fill the idle targets, then hand them to the ISR in one write. */
+	uint8_t back = dither_front ^ 1;
+	dither_targets[back][0] = pulse_values[0];
+	dither_targets[back][1] = pulse_values[1];
+	dither_targets[back][2] = pulse_values[2];
+	dither_front = back;
+#else
+	uint16_t whole[3];
+	for (int colour = 0; colour < 3; colour++) {
+		uint32_t rounded = (pulse_values[colour]
+				+ (1 << (PWM_FRACTION_BITS - 1))) >> PWM_FRACTION_BITS;
+		whole[colour] = (rounded > PWM_PULSE_OFF) ? PWM_PULSE_OFF : rounded;
+	}
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	/* The idle buffer is free, or holds values that were never applied. */
+	uint8_t buffer = active_buffer ^ 1;
+	burst_buffers[buffer][0] = blue_compare(whole[2], COUNTER_PERIOD);
+	burst_buffers[buffer][1] = green_phase_compare(COUNTER_PERIOD);
+	burst_buffers[buffer][2] = whole[0];
+	green_pulses[buffer] = whole[1];
+
+	if (burst_active) {
+		burst_pending = 1;
+	} else {
+		start_pwm_burst(buffer);
+	}
+
+	__set_PRIMASK(primask);
+#endif /* PWM_DITHER */
+}
+
+/**
+ * @brief Works out the next period's compare values from Q8 targets.
+ *
+ * Kept free of hardware access so it can be run against a model on the host.
+ *
+ * @param targets: Q8 pulse values (R, G, B).
+ * @param accumulators: Fraction accumulators (R, G, B), updated in place.
+ * @param outputs: Array to fill with the compare values (R, G, B).
+ *
+ * @return None.
+ */
+void advance_pwm_dither(uint32_t targets[3], uint8_t accumulators[3],
+		uint16_t outputs[3]) {
+	const uint32_t drop = PWM_FRACTION_BITS - PWM_DITHER_BITS;
+	const uint32_t fraction_mask = (1 << PWM_DITHER_BITS) - 1;
+
+	for (int colour = 0; colour < 3; colour++) {
+		/* Round the target to PWM_DITHER_BITS of fraction. */
+		uint32_t target = (targets[colour] + ((1 << drop) >> 1)) >> drop;
+		uint32_t whole = target >> PWM_DITHER_BITS;
+		uint32_t sum = accumulators[colour] + (target & fraction_mask);
+
+		accumulators[colour] = sum & fraction_mask;
+		whole += sum >> PWM_DITHER_BITS;
+		outputs[colour] = (whole > PWM_PULSE_OFF) ? PWM_PULSE_OFF : whole;
+	}
+}
+
+/**
+ * @brief Handles a TIM3 period (called from the TIM3 period elapsed callback).
+ *
+ * With PWM_DITHER this is the update interrupt, and the next period's compare
+ * values are written to the preload registers. Otherwise it is the end of a
+ * burst: TIM3 has just loaded the previous values and received the new ones,
+ * so the TIM15 value is written now to go out with them, and a queued buffer
+ * is started for the next update.
+ *
+ * @return None.
+ */
+void pwm_period_elapsed(void) {
+#ifdef PWM_DITHER
+	uint16_t outputs[3];
+	advance_fade(&fade, dither_targets[dither_front],
+			PULSE_TO_Q8(COUNTER_PERIOD), fade_outputs);
+	advance_pwm_dither(fade_outputs, dither_accumulators, outputs);
+	__HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_3, outputs[0]);
+	__HAL_TIM_SET_COMPARE(&htim15, TIM_CHANNEL_1, outputs[1]);
+	__HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_1,
+			blue_compare(outputs[2], COUNTER_PERIOD));
+#else
+	HAL_TIM_DMABurst_WriteStop(&htim3, TIM_DMA_UPDATE);
+	__HAL_TIM_SET_COMPARE(&htim15, TIM_CHANNEL_1, green_pulses[active_buffer]);
+	burst_active = 0;
+
+	if (burst_pending) {
+		burst_pending = 0;
+		start_pwm_burst(active_buffer ^ 1);
+	}
+#endif /* PWM_DITHER */
+}
+
+/**
+ * @brief Converts a Q8 pulse value from one period to another.
+ *
+ * @param pulse_value: Q8 pulse value in the old scale.
+ * @param old_period: Period the pulse value was calculated for.
+ * @param new_period: Period to convert the pulse value to.
+ *
+ * @return The Q8 pulse value in the new scale (off stays off).
+ */
+uint32_t rescale_pulse_value(uint32_t pulse_value, uint16_t old_period,
+		uint16_t new_period) {
+	if (pulse_value >= PULSE_TO_Q8(old_period)) {
+		return (pulse_value >= PULSE_TO_Q8(PWM_PULSE_OFF)) ?
+				pulse_value : PULSE_TO_Q8(new_period);
+	}
+	return (uint32_t) (((uint64_t) pulse_value * new_period + old_period / 2)
+			/ old_period);
+}
+
+/**
+ * @brief Rescales one compare register's preload value to a new period.
+ *
+ * @param htim: Pointer to the timer handle.
+ * @param channel: The timer channel.
+ * @param old_period: The period of the current value.
+ * @param new_period: The period to convert to.
+ *
+ * @return None.
+ */
+static void rescale_compare(TIM_HandleTypeDef *htim, uint32_t channel,
+		uint16_t old_period, uint16_t new_period) {
+	uint32_t pulse_value = rescale_pulse_value(
+			PULSE_TO_Q8(__HAL_TIM_GET_COMPARE(htim, channel)), old_period,
+			new_period) >> PWM_FRACTION_BITS;
+	__HAL_TIM_SET_COMPARE(htim, channel, pulse_value);
+}
+
+/**
+ * @brief Switches TIM3 and TIM15 to another PWM profile.
+ *
+ * Any queued burst is dropped and the compare registers are rescaled so the
+ * brightness is unchanged. An update event is then generated on both timers
+ * to load the new prescaler, period and compares together. Pulse values held
+ * elsewhere must be rescaled by the caller (see framebuffer_set_pwm_profile).
+ *
+ * @param profile: The profile to switch to.
+ *
+ * @return None.
+ */
+void set_pwm_profile(PwmProfileId profile) {
+	if (profile >= NUM_PWM_PROFILES) {
+		return;
+	}
+	const PwmProfile *old_profile = active_pwm_profile;
+	const PwmProfile *new_profile = &pwm_profiles[profile];
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+#ifndef PWM_DITHER
+	HAL_TIM_DMABurst_WriteStop(&htim3, TIM_DMA_UPDATE);
+	burst_active = 0;
+	burst_pending = 0;
+#endif /* PWM_DITHER */
+
+	uint32_t blue = rescale_pulse_value(
+			PULSE_TO_Q8(blue_pulse(__HAL_TIM_GET_COMPARE(&htim3, TIM_CHANNEL_1),
+					old_profile->period)), old_profile->period,
+			new_profile->period) >> PWM_FRACTION_BITS;
+	__HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_1,
+			blue_compare(blue, new_profile->period));
+	__HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_2,
+			green_phase_compare(new_profile->period));
+	rescale_compare(&htim3, TIM_CHANNEL_3, old_profile->period,
+			new_profile->period);
+	rescale_compare(&htim15, TIM_CHANNEL_1, old_profile->period,
+			new_profile->period);
+
+#ifdef PWM_DITHER
+	for (int buffer = 0; buffer < 2; buffer++) {
+		for (int colour = 0; colour < 3; colour++) {
+			dither_targets[buffer][colour] = rescale_pulse_value(
+					dither_targets[buffer][colour], old_profile->period,
+					new_profile->period);
+		}
+	}
+	for (int colour = 0; colour < 3; colour++) {
+		fade.start[colour] = rescale_pulse_value(fade.start[colour],
+				old_profile->period, new_profile->period);
+		fade_outputs[colour] = rescale_pulse_value(fade_outputs[colour],
+				old_profile->period, new_profile->period);
+	}
+#endif /* PWM_DITHER */
+
+	__HAL_TIM_SET_PRESCALER(&htim3, new_profile->prescaler);
+	__HAL_TIM_SET_AUTORELOAD(&htim3, new_profile->period);
+	__HAL_TIM_SET_PRESCALER(&htim15, new_profile->prescaler);
+	__HAL_TIM_SET_AUTORELOAD(&htim15, new_profile->period);
+	HAL_TIM_GenerateEvent(&htim3, TIM_EVENTSOURCE_UPDATE);
+	HAL_TIM_GenerateEvent(&htim15, TIM_EVENTSOURCE_UPDATE);
+
+	active_pwm_profile = new_profile;
+	__set_PRIMASK(primask);
+#ifdef DEBUG_INIT
+	printf("PWM PROFILE %u: PRESCALER %u, PERIOD %u\n", profile,
+			new_profile->prescaler, new_profile->period);
+#endif /* DEBUG_INIT */
+}
+
+/**
+ * @brief Fades from the current output to the committed pulse values.
+ *
+ * Later commits change the values being faded to without restarting the
+ * fade, so it can be started before the new values are calculated.
+ *
+ * @param duration: Length of the fade in ms.
+ * @param curve: The easing curve.
+ *
+ * @return None.
+ */
+void start_pwm_fade(uint32_t duration, FadeCurve curve) {
+#ifdef PWM_DITHER
+	const PwmProfile *profile = active_pwm_profile;
+	uint32_t period_ticks = (profile->prescaler + 1)
+			* ((uint32_t) profile->period + 1);
+	uint32_t steps = (uint32_t) ((uint64_t) duration * SystemCoreClock
+			/ ((uint64_t) period_ticks * 1000));
+
+	HAL_NVIC_DisableIRQ(TIM3_IRQn);
+	start_fade(&fade, fade_outputs, steps, curve);
+	HAL_NVIC_EnableIRQ(TIM3_IRQn);
+#ifdef DEBUG_LED_DRIVERS
+	printf("PWM FADE: %lu ms, %lu periods\n", duration, steps);
+#endif /* DEBUG_LED_DRIVERS */
+#else
+	(void) duration;
+	(void) curve;
+#endif /* PWM_DITHER */
+}
+
+/**
+ * @brief Checks whether a fade is still being stepped.
+ *
+ * @return 1 if a fade is running, 0 otherwise.
+ */
+uint8_t pwm_fade_running(void) {
+#ifdef PWM_DITHER
+	return fade.running;
+#else
+	return 0;
+#endif /* PWM_DITHER */
+}
+
+/**
+ * @brief Finds how long a colour's BLANK line stays at a level.
+ *
+ * @param colour: 0 for red, 1 for green, 2 for blue.
+ * @param level: GPIO_PIN_SET for blanked, GPIO_PIN_RESET for unblanked.
+ *
+ * @return Counts of the colour's timer left at the level, 0 if not at it.
+ */
+uint32_t get_blank_time_left(uint8_t colour, GPIO_PinState level) {
+	TIM_HandleTypeDef *htim = (colour == 1) ? &htim15 : &htim3;
+	uint32_t channel = (colour == 0) ? TIM_CHANNEL_3 : TIM_CHANNEL_1;
+	uint32_t compare = __HAL_TIM_GET_COMPARE(htim, channel);
+	uint32_t count = __HAL_TIM_GET_COUNTER(htim);
+	uint32_t end = __HAL_TIM_GET_AUTORELOAD(htim) + 1;
+
+	/* PWM mode 1 is high below the compare value, mode 2 from it. */
+	uint8_t high_first = 1;
+#ifdef PWM_BLUE_TRAILING
+	high_first = (colour != 2);
+#endif /* PWM_BLUE_TRAILING */
+
+	uint8_t before_compare = (count < compare);
+	GPIO_PinState state =
+			(before_compare == high_first) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+	if (state != level) {
+		return 0;
+	}
+	return before_compare ? compare - count : end - count;
+}
+
+/**
+ * @brief Measures the alignment of the TIM15 counter to TIM3.
+ *
+ * Reads both counters back to back PWM_SYNC_SAMPLES times, after waiting
+ * PWM_SYNC_SETTLE_TIME for TIM15 to have been reset. The timers must be
+ * running.
+ *
+ * @param report: Filled with the expected lag and the error range.
+ *
+ * @return PWM_SYNC_OK if every sample is within PWM_SYNC_TOLERANCE.
+ */
+PwmSyncStatus check_pwm_sync(PwmSyncReport *report) {
+	HAL_Delay(PWM_SYNC_SETTLE_TIME);
+
+	int32_t length = __HAL_TIM_GET_AUTORELOAD(&htim3) + 1;
+	int32_t expected = 0;
+#if PWM_GREEN_PHASE != 0
+	expected = __HAL_TIM_GET_COMPARE(&htim3, TIM_CHANNEL_2);
+#endif /* PWM_GREEN_PHASE */
+	report->expected_lag = expected;
+	report->min_error = INT16_MAX;
+	report->max_error = INT16_MIN;
+
+	for (int sample = 0; sample < PWM_SYNC_SAMPLES; sample++) {
+		uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		int32_t master = __HAL_TIM_GET_COUNTER(&htim3);
+		int32_t slave = __HAL_TIM_GET_COUNTER(&htim15);
+		__set_PRIMASK(primask);
+
+		/* Wrap the error into half a period either side of zero. */
+		int32_t error = ((master - slave - expected) % length + length)
+				% length;
+		if (error > length / 2) {
+			error -= length;
+		}
+		if (error < report->min_error) {
+			report->min_error = error;
+		}
+		if (error > report->max_error) {
+			report->max_error = error;
+		}
+	}
+
+	if ((report->min_error < -PWM_SYNC_TOLERANCE)
+			|| (report->max_error > PWM_SYNC_TOLERANCE)) {
+		return PWM_SYNC_DRIFT;
+	}
+	return PWM_SYNC_OK;
+}
@@ -0,0 +1,552 @@
+/**
+ *******************************************************************************
+ * @file LED_shift_engine.c
+ * @brief Timer-paced DMA engine for shifting frames into the LED drivers.
+ *
+ * A frame (one 16-bit word per driver chain) is encoded into GPIO BSRR words
+ * and written to the ports by two DMA channels paced by TIM4. The GPIOA words
+ * (SIN_B) are written on the TIM4 CC1 event (DMA1 Channel 1) early in each
+ * step and the GPIOB words (SIN_R, SIN_G, SCLK, XLAT, MODE) are written on the
+ * TIM4 update event (DMA1 Channel 7) at the end of each step. Data is always
+ * set up a full step before the SCLK rising edge.
+ *
+ * The SOUT lines are sampled in every step on the TIM4 CC2 (GPIOB IDR, DMA1
+ * Channel 4) and CC3 (GPIOA IDR, DMA1 Channel 5) events, so the words that
+ * were in the shift registers come back out during the same pass.
+ *
+ * On/off frames shift one word per chain with MODE low. Dot correction frames
+ * go through the same steps with MODE high and DOT_CORRECTION_BITS per LED.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include "stm32f3xx_hal.h"
+#include <stdint.h>
+#include <stdio.h>
+#include "main.h"
+#include "hardware_defines.h"
+#include "LED_shift_engine.h"
+#include "debug_flags.h"
+
+#define BSRR_SET(pin) ((uint32_t) (pin))			///< BSRR word to set a pin.
+#define BSRR_RESET(pin) ((uint32_t) (pin) << 16)	///< BSRR word to reset a pin.
+
+TIM_HandleTypeDef htim4;
+DMA_HandleTypeDef hdma_shift_port_a;
+DMA_HandleTypeDef hdma_shift_port_b;
+DMA_HandleTypeDef hdma_shift_capture_a;
+DMA_HandleTypeDef hdma_shift_capture_b;
+
+static ShiftFrame shift_frame;
+static ShiftCapture shift_capture;
+static uint16_t shift_readback[3];		///< Words read back by the last frame.
+static uint8_t dot_correction_readback[3][NUM_LEDS];	///< Read back by DC frame.
+static volatile uint8_t shift_in_progress = 0;
+static volatile uint32_t frames_queued = 0;	///< Frames claimed since boot.
+static ShiftCompleteCallback shift_complete_callback = NULL;
+
+#ifdef LED_SHIFT_DMA
+static void shift_transfer_complete(DMA_HandleTypeDef *hdma);
+#endif /* LED_SHIFT_DMA */
+
+/**
+ * @brief Encodes the first step of a frame: MODE set, XLAT and SCLK low.
+ *
+ * @param frame: Pointer to the frame to fill.
+ * @param mode: 1 for dot correction mode, 0 for ON/OFF mode.
+ *
+ * @return None.
+ */
+static void encode_start(ShiftFrame *frame, uint8_t mode) {
+	frame->port_a[0] = 0;
+	frame->port_b[0] = (mode ? BSRR_SET(MODE_Pin) : BSRR_RESET(MODE_Pin))
+			| BSRR_RESET(XLAT_Pin) | BSRR_RESET(SCLK_Pin);
+}
+
+/**
+ * @brief Encodes the two steps that clock one bit into every chain.
+ *
+ * @param frame: Pointer to the frame to fill.
+ * @param index: Position of the bit in the frame (0 is shifted first).
+ * @param red_bit: Bit for the red chain.
+ * @param green_bit: Bit for the green chain.
+ * @param blue_bit: Bit for the blue chain.
+ *
+ * @return None.
+ */
+static void encode_bit(ShiftFrame *frame, int index, uint8_t red_bit,
+		uint8_t green_bit, uint8_t blue_bit) {
+	int step = 1 + SHIFT_STEPS_PER_BIT * index;
+
+	/* Present the data bits with SCLK low. */
+	frame->port_a[step] = blue_bit ? BSRR_SET(SIN_B_Pin) : BSRR_RESET(SIN_B_Pin);
+	frame->port_b[step] = BSRR_RESET(SCLK_Pin)
+			| (red_bit ? BSRR_SET(SIN_R_Pin) : BSRR_RESET(SIN_R_Pin))
+			| (green_bit ? BSRR_SET(SIN_G_Pin) : BSRR_RESET(SIN_G_Pin));
+
+	/* Clock the bits into the LED drivers. */
+	frame->port_a[step + 1] = 0;
+	frame->port_b[step + 1] = BSRR_SET(SCLK_Pin);
+}
+
+/**
+ * @brief Encodes the XLAT pulse that ends a frame and sets its length.
+ *
+ * MODE is left as the first step set it.
+ *
+ * @param frame: Pointer to the frame to fill.
+ * @param bits: Number of bits clocked into each chain.
+ *
+ * @return None.
+ */
+static void encode_latch(ShiftFrame *frame, uint16_t bits) {
+	int step = 1 + SHIFT_STEPS_PER_BIT * bits;
+
+	/* Latch the configuration registers. */
+	frame->port_a[step] = 0;
+	frame->port_b[step] = BSRR_RESET(SCLK_Pin) | BSRR_SET(XLAT_Pin);
+	frame->port_a[step + 1] = 0;
+	frame->port_b[step + 1] = BSRR_RESET(XLAT_Pin);
+	frame->bits = bits;
+}
+
+/**
+ * @brief Encodes three chain words into a frame of GPIO BSRR words.
+ *
+ * Bits are shifted MSB first so bit n of each mask ends up on output n of its
+ * chain (bit 0 is LED 1). Only pin masks are used, so the encoder can be run
+ * on the host and checked by replaying the words into a fake pin trace.
+ *
+ * @param red_mask: Word for the red chain.
+ * @param green_mask: Word for the green chain.
+ * @param blue_mask: Word for the blue chain.
+ * @param frame: Pointer to the frame to fill.
+ *
+ * @return None.
+ */
+void encode_shift_frame(uint16_t red_mask, uint16_t green_mask,
+		uint16_t blue_mask, ShiftFrame *frame) {
+	/* MODE low for ON/OFF configuration mode. */
+	encode_start(frame, 0);
+	for (int index = 0; index < SHIFT_BITS_PER_CHAIN; index++) {
+		int bit = SHIFT_BITS_PER_CHAIN - 1 - index;
+		encode_bit(frame, index, (red_mask >> bit) & 1, (green_mask >> bit) & 1,
+				(blue_mask >> bit) & 1);
+	}
+	encode_latch(frame, SHIFT_BITS_PER_CHAIN);
+}
+
+/**
+ * @brief Encodes dot correction values into a frame of GPIO BSRR words.
+ *
+ * MODE is set high to select the drivers' dot correction registers and left
+ * high after XLAT, so a second frame can read the values back. Values are
+ * shifted OUT15 first, MSB first.
+ *
+ * @param dot_correction: Dot correction values for each chain and LED.
+ * @param frame: Pointer to the frame to fill.
+ *
+ * @return None.
+ */
+void encode_dot_correction_frame(uint8_t dot_correction[3][NUM_LEDS],
+		ShiftFrame *frame) {
+	encode_start(frame, 1);
+	for (int index = 0; index < SHIFT_DOT_CORRECTION_BITS; index++) {
+		int led = NUM_LEDS - 1 - index / DOT_CORRECTION_BITS;
+		int bit = DOT_CORRECTION_BITS - 1 - index % DOT_CORRECTION_BITS;
+		encode_bit(frame, index, (dot_correction[0][led] >> bit) & 1,
+				(dot_correction[1][led] >> bit) & 1,
+				(dot_correction[2][led] >> bit) & 1);
+	}
+	encode_latch(frame, SHIFT_DOT_CORRECTION_BITS);
+}
+
+/**
+ * @brief Reads one chain's SOUT bit from a frame's input samples.
+ *
+ * SOUT presents the MSB of the old contents before the first clock and the
+ * next bit after each rising edge, so the bit at a position is taken from the
+ * sample after its data step (while SCLK is still low).
+ *
+ * @param capture: Pointer to the samples taken during the frame.
+ * @param index: Position of the bit in the frame (0 is shifted first).
+ * @param chain: 0 for red, 1 for green, 2 for blue.
+ *
+ * @return The bit.
+ */
+static uint8_t capture_bit(const ShiftCapture *capture, int index, int chain) {
+	int step = 2 + SHIFT_STEPS_PER_BIT * index;
+	if (chain == 0) {
+		return (capture->port_a[step] & SOUT_R_Pin) != 0;
+	} else if (chain == 1) {
+		return (capture->port_b[step] & SOUT_G_Pin) != 0;
+	}
+	return (capture->port_b[step] & SOUT_B_Pin) != 0;
+}
+
+/**
+ * @brief Extracts the words clocked out of SOUT from an on/off frame.
+ *
+ * @param capture: Pointer to the samples taken during the frame.
+ * @param words: Array to fill with the red, green and blue words.
+ *
+ * @return None.
+ */
+void decode_shift_capture(const ShiftCapture *capture, uint16_t words[3]) {
+	for (int chain = 0; chain < 3; chain++) {
+		words[chain] = 0;
+		for (int index = 0; index < SHIFT_BITS_PER_CHAIN; index++) {
+			words[chain] = (words[chain] << 1) | capture_bit(capture, index, chain);
+		}
+	}
+}
+
+/**
+ * @brief Extracts the dot correction clocked out of SOUT from a dot
+ * correction frame.
+ *
+ * @param capture: Pointer to the samples taken during the frame.
+ * @param dot_correction: Array to fill with the values for each chain and LED.
+ *
+ * @return None.
+ */
+void decode_dot_correction_capture(const ShiftCapture *capture,
+		uint8_t dot_correction[3][NUM_LEDS]) {
+	for (int chain = 0; chain < 3; chain++) {
+		for (int led = NUM_LEDS - 1; led >= 0; led--) {
+			int first = (NUM_LEDS - 1 - led) * DOT_CORRECTION_BITS;
+			uint8_t value = 0;
+			for (int bit = 0; bit < DOT_CORRECTION_BITS; bit++) {
+				value = (value << 1) | capture_bit(capture, first + bit, chain);
+			}
+			dot_correction[chain][led] = value;
+		}
+	}
+}
+
+/**
+ * @brief Configures TIM4 and the four DMA channels used by the shift engine.
+ *
+ * Does nothing when LED_SHIFT_DMA is not defined.
+ *
+ * @return None.
+ */
+void initialise_shift_engine(void) {
+#ifdef LED_SHIFT_DMA
+#ifdef DEBUG_INIT
+	printf("\nINITIALISING SHIFT ENGINE\n");
+#endif /* DEBUG_INIT */
+	__HAL_RCC_TIM4_CLK_ENABLE();
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	htim4.Instance = TIM4;
+	htim4.Init.Prescaler = SHIFT_TIMER_PRESCALER;
+	htim4.Init.CounterMode = TIM_COUNTERMODE_UP;
+	htim4.Init.Period = SHIFT_TIMER_PERIOD;
+	htim4.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	htim4.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+	if (HAL_TIM_Base_Init(&htim4) != HAL_OK) {
+		Error_Handler();
+	}
+
+	/* CC1 fires one count into each step to write the GPIOA word. */
+	TIM_OC_InitTypeDef sConfigOC = { 0 };
+	sConfigOC.OCMode = TIM_OCMODE_TIMING;
+	sConfigOC.Pulse = 1;
+	sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+	sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+	if (HAL_TIM_OC_ConfigChannel(&htim4, &sConfigOC, TIM_CHANNEL_1)
+			!= HAL_OK) {
+		Error_Handler();
+	}
+
+	/* CC2 and CC3 fire mid-step to sample the SOUT lines. */
+	sConfigOC.Pulse = SHIFT_CAPTURE_PULSE;
+	if ((HAL_TIM_OC_ConfigChannel(&htim4, &sConfigOC, TIM_CHANNEL_2) != HAL_OK)
+			|| (HAL_TIM_OC_ConfigChannel(&htim4, &sConfigOC, TIM_CHANNEL_3)
+					!= HAL_OK)) {
+		Error_Handler();
+	}
+
+	/* DMA1 Channel 1 (TIM4_CH1): frame -> GPIOA BSRR. */
+	hdma_shift_port_a.Instance = DMA1_Channel1;
+	hdma_shift_port_a.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	hdma_shift_port_a.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma_shift_port_a.Init.MemInc = DMA_MINC_ENABLE;
+	hdma_shift_port_a.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+	hdma_shift_port_a.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+	hdma_shift_port_a.Init.Mode = DMA_NORMAL;
+	hdma_shift_port_a.Init.Priority = DMA_PRIORITY_HIGH;
+	if (HAL_DMA_Init(&hdma_shift_port_a) != HAL_OK) {
+		Error_Handler();
+	}
+
+	/* DMA1 Channel 7 (TIM4_UP): frame -> GPIOB BSRR. */
+	hdma_shift_port_b.Instance = DMA1_Channel7;
+	hdma_shift_port_b.Init = hdma_shift_port_a.Init;
+	if (HAL_DMA_Init(&hdma_shift_port_b) != HAL_OK) {
+		Error_Handler();
+	}
+	hdma_shift_port_b.XferCpltCallback = shift_transfer_complete;
+
+	/* DMA1 Channel 4 (TIM4_CH2): GPIOB IDR -> capture. */
+	hdma_shift_capture_b.Instance = DMA1_Channel4;
+	hdma_shift_capture_b.Init.Direction = DMA_PERIPH_TO_MEMORY;
+	hdma_shift_capture_b.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma_shift_capture_b.Init.MemInc = DMA_MINC_ENABLE;
+	hdma_shift_capture_b.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+	hdma_shift_capture_b.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+	hdma_shift_capture_b.Init.Mode = DMA_NORMAL;
+	hdma_shift_capture_b.Init.Priority = DMA_PRIORITY_HIGH;
+	if (HAL_DMA_Init(&hdma_shift_capture_b) != HAL_OK) {
+		Error_Handler();
+	}
+
+	/* DMA1 Channel 5 (TIM4_CH3): GPIOA IDR -> capture. */
+	hdma_shift_capture_a.Instance = DMA1_Channel5;
+	hdma_shift_capture_a.Init = hdma_shift_capture_b.Init;
+	if (HAL_DMA_Init(&hdma_shift_capture_a) != HAL_OK) {
+		Error_Handler();
+	}
+
+	HAL_NVIC_SetPriority(DMA1_Channel7_IRQn, 0, 0);
+	HAL_NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+#ifdef DEBUG_INIT
+	printf("SHIFT ENGINE INITIALISED\n");
+#endif /* DEBUG_INIT */
+#endif /* LED_SHIFT_DMA */
+}
+
+/**
+ * @brief Claims the engine for a new frame.
+ *
+ * Claims atomically as frames may be queued from ISRs.
+ *
+ * @param callback: Function called on completion (may be NULL).
+ *
+ * @return 1 if claimed, 0 if a frame is already in flight.
+ */
+static uint8_t claim_shift_engine(ShiftCompleteCallback callback) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if (shift_in_progress) {
+		__set_PRIMASK(primask);
+		return 0;
+	}
+	shift_in_progress = 1;
+	frames_queued++;
+	__set_PRIMASK(primask);
+	shift_complete_callback = callback;
+	return 1;
+}
+
+/**
+ * @brief Decodes the read-back of the frame that has just been latched.
+ *
+ * @return None.
+ */
+static void decode_readback(void) {
+	if (shift_frame.bits == SHIFT_DOT_CORRECTION_BITS) {
+		decode_dot_correction_capture(&shift_capture, dot_correction_readback);
+	} else {
+		decode_shift_capture(&shift_capture, shift_readback);
+	}
+}
+
+/**
+ * @brief Clocks the encoded frame out, in the background with LED_SHIFT_DMA.
+ *
+ * @return The status of the shift engine.
+ */
+static ShiftEngineStatus start_shift_frame(void) {
+	uint16_t length = SHIFT_FRAME_STEPS(shift_frame.bits);
+
+#ifdef LED_SHIFT_DMA
+	__HAL_TIM_DISABLE(&htim4);
+	__HAL_TIM_SET_COUNTER(&htim4, 0);
+	__HAL_TIM_CLEAR_FLAG(&htim4,
+			TIM_FLAG_UPDATE | TIM_FLAG_CC1 | TIM_FLAG_CC2 | TIM_FLAG_CC3);
+
+	if ((HAL_DMA_Start(&hdma_shift_capture_a, (uint32_t) &GPIOA->IDR,
+			(uint32_t) shift_capture.port_a, length) != HAL_OK)
+			|| (HAL_DMA_Start(&hdma_shift_capture_b, (uint32_t) &GPIOB->IDR,
+					(uint32_t) shift_capture.port_b, length) != HAL_OK)
+			|| (HAL_DMA_Start(&hdma_shift_port_a, (uint32_t) shift_frame.port_a,
+					(uint32_t) &GPIOA->BSRR, length) != HAL_OK)
+			|| (HAL_DMA_Start_IT(&hdma_shift_port_b,
+					(uint32_t) shift_frame.port_b, (uint32_t) &GPIOB->BSRR,
+					length) != HAL_OK)) {
+		HAL_DMA_Abort(&hdma_shift_capture_a);
+		HAL_DMA_Abort(&hdma_shift_capture_b);
+		HAL_DMA_Abort(&hdma_shift_port_a);
+		HAL_DMA_Abort(&hdma_shift_port_b);
+		shift_in_progress = 0;
+		return SHIFT_ENGINE_ERROR;
+	}
+
+	__HAL_TIM_ENABLE_DMA(&htim4,
+			TIM_DMA_CC1 | TIM_DMA_CC2 | TIM_DMA_CC3 | TIM_DMA_UPDATE);
+	__HAL_TIM_ENABLE(&htim4);
+#else
+	for (int step = 0; step < length; step++) {
+		/* Sample before writing, as the CC2/CC3 DMA requests would. */
+		shift_capture.port_a[step] = GPIOA->IDR;
+		shift_capture.port_b[step] = GPIOB->IDR;
+		GPIOA->BSRR = shift_frame.port_a[step];
+		GPIOB->BSRR = shift_frame.port_b[step];
+	}
+	decode_readback();
+	shift_in_progress = 0;
+	if (shift_complete_callback != NULL) {
+		shift_complete_callback();
+	}
+#endif /* LED_SHIFT_DMA */
+
+	return SHIFT_ENGINE_OK;
+}
+
+/**
+ * @brief Queues a frame to be shifted into the three LED driver chains.
+ *
+ * With LED_SHIFT_DMA the frame is clocked out in the background and the
+ * callback is called from the DMA interrupt once XLAT has been pulsed.
+ * Otherwise the frame is written out from the CPU before returning and the
+ * callback is called immediately. Either way, the words clocked out of SOUT
+ * are available from get_shift_readback() once the frame has been latched.
+ *
+ * @param red_mask: Word for the red chain.
+ * @param green_mask: Word for the green chain.
+ * @param blue_mask: Word for the blue chain.
+ * @param callback: Function called on completion (may be NULL).
+ *
+ * @return The status of the shift engine.
+ */
+ShiftEngineStatus queue_shift_frame(uint16_t red_mask, uint16_t green_mask,
+		uint16_t blue_mask, ShiftCompleteCallback callback) {
+	if (!claim_shift_engine(callback)) {
+		return SHIFT_ENGINE_BUSY;
+	}
+	encode_shift_frame(red_mask, green_mask, blue_mask, &shift_frame);
+	return start_shift_frame();
+}
+
+/**
+ * @brief Queues a frame that writes the drivers' dot correction registers.
+ *
+ * Works like queue_shift_frame(). The values that were in the registers come
+ * back from get_dot_correction_readback() once the frame has been latched.
+ * MODE stays high afterwards; the next on/off frame sets it low again.
+ *
+ * @param dot_correction: Dot correction values for each chain and LED.
+ * @param callback: Function called on completion (may be NULL).
+ *
+ * @return The status of the shift engine.
+ */
+ShiftEngineStatus queue_dot_correction_frame(
+		uint8_t dot_correction[3][NUM_LEDS], ShiftCompleteCallback callback) {
+	if (!claim_shift_engine(callback)) {
+		return SHIFT_ENGINE_BUSY;
+	}
+	encode_dot_correction_frame(dot_correction, &shift_frame);
+	return start_shift_frame();
+}
+
+/**
+ * @brief Checks whether a frame is still being shifted out.
+ *
+ * @return 1 if the engine is busy, 0 otherwise.
+ */
+uint8_t shift_engine_busy(void) {
+	return shift_in_progress;
+}
+
+/**
+ * @brief Returns the number of frames queued since boot.
+ *
+ * Lets code that drives the lines directly detect that a frame (and its XLAT
+ * pulse) has gone out in between two of its own accesses.
+ *
+ * @return The frame count (wraps around).
+ */
+uint32_t get_shift_frame_count(void) {
+	return frames_queued;
+}
+
+/**
+ * @brief Copies the words clocked out of SOUT by the last latched on/off frame.
+ *
+ * @param words: Array to fill with the red, green and blue words.
+ *
+ * @return None.
+ */
+void get_shift_readback(uint16_t words[3]) {
+	words[0] = shift_readback[0];
+	words[1] = shift_readback[1];
+	words[2] = shift_readback[2];
+}
+
+/**
+ * @brief Copies the values clocked out of SOUT by the last latched dot
+ * correction frame.
+ *
+ * @param dot_correction: Array to fill with the values for each chain and LED.
+ *
+ * @return None.
+ */
+void get_dot_correction_readback(uint8_t dot_correction[3][NUM_LEDS]) {
+	for (int chain = 0; chain < 3; chain++) {
+		for (int led = 0; led < NUM_LEDS; led++) {
+			dot_correction[chain][led] = dot_correction_readback[chain][led];
+		}
+	}
+}
+
+/**
+ * @brief Blocks until the frame in flight (if any) has been latched.
+ *
+ * Safe to call from an ISR that the DMA interrupt cannot preempt.
+ *
+ * @return None.
+ */
+void wait_for_shift_engine(void) {
+	while (shift_in_progress) {
+#ifdef LED_SHIFT_DMA
+		/* Service the completion here in case the DMA IRQ cannot preempt. */
+		uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		if (__HAL_DMA_GET_FLAG(&hdma_shift_port_b, DMA_FLAG_TC7)) {
+			HAL_DMA_IRQHandler(&hdma_shift_port_b);
+		}
+		__set_PRIMASK(primask);
+#endif /* LED_SHIFT_DMA */
+	}
+}
+
+#ifdef LED_SHIFT_DMA
+/**
+ * @brief Stops TIM4 once the last GPIOB word (XLAT low) has been written.
+ *
+ * @param hdma: pointer to the DMA handle (GPIOB channel).
+ *
+ * @return None.
+ */
+static void shift_transfer_complete(DMA_HandleTypeDef *hdma) {
+	(void) hdma;
+	__HAL_TIM_DISABLE(&htim4);
+	__HAL_TIM_DISABLE_DMA(&htim4,
+			TIM_DMA_CC1 | TIM_DMA_CC2 | TIM_DMA_CC3 | TIM_DMA_UPDATE);
+
+	/* The other channels finish earlier in the last step without an IRQ. */
+	HAL_DMA_Abort(&hdma_shift_port_a);
+	HAL_DMA_Abort(&hdma_shift_capture_a);
+	HAL_DMA_Abort(&hdma_shift_capture_b);
+	decode_readback();
+
+	shift_in_progress = 0;
+	if (shift_complete_callback != NULL) {
+		shift_complete_callback();
+	}
+}
+#endif /* LED_SHIFT_DMA */
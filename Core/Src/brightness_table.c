@@ -0,0 +1,531 @@
+/**
+ *******************************************************************************
+ * @file brightness_table.c
+ * @brief CIE L* brightness lookup table (generated, do not edit).
+ *
+ * Generated by Tools/generate_brightness_table.py. Entry n is the
+ * relative luminance (Q16) for a brightness pot reading of n.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <stdint.h>
+#include "globals.h"
+#include "brightness_table.h"
+
+const uint16_t brightness_table[ADC_RES] = {
+		65535, 65494, 65452, 65411, 65370, 65328, 65287, 65246,
+		65204, 65163, 65122, 65081, 65040, 64998, 64957, 64916,
+		64875, 64834, 64793, 64752, 64711, 64670, 64629, 64588,
+		64547, 64506, 64465, 64424, 64383, 64342, 64301, 64260,
+		64219, 64179, 64138, 64097, 64056, 64016, 63975, 63934,
+		63893, 63853, 63812, 63771, 63731, 63690, 63649, 63609,
+		63568, 63528, 63487, 63447, 63406, 63366, 63325, 63285,
+		63244, 63204, 63164, 63123, 63083, 63043, 63002, 62962,
+		62922, 62881, 62841, 62801, 62761, 62720, 62680, 62640,
+		62600, 62560, 62520, 62480, 62440, 62399, 62359, 62319,
+		62279, 62239, 62199, 62159, 62119, 62080, 62040, 62000,
+		61960, 61920, 61880, 61840, 61801, 61761, 61721, 61681,
+		61641, 61602, 61562, 61522, 61483, 61443, 61403, 61364,
+		61324, 61285, 61245, 61205, 61166, 61126, 61087, 61047,
+		61008, 60968, 60929, 60890, 60850, 60811, 60771, 60732,
+		60693, 60653, 60614, 60575, 60536, 60496, 60457, 60418,
+		60379, 60340, 60300, 60261, 60222, 60183, 60144, 60105,
+		60066, 60027, 59988, 59949, 59910, 59871, 59832, 59793,
+		59754, 59715, 59676, 59637, 59598, 59559, 59521, 59482,
+		59443, 59404, 59366, 59327, 59288, 59249, 59211, 59172,
+		59133, 59095, 59056, 59017, 58979, 58940, 58902, 58863,
+		58825, 58786, 58748, 58709, 58671, 58632, 58594, 58556,
+		58517, 58479, 58440, 58402, 58364, 58325, 58287, 58249,
+		58211, 58172, 58134, 58096, 58058, 58020, 57981, 57943,
+		57905, 57867, 57829, 57791, 57753, 57715, 57677, 57639,
+		57601, 57563, 57525, 57487, 57449, 57411, 57373, 57335,
+		57298, 57260, 57222, 57184, 57146, 57109, 57071, 57033,
+		56995, 56958, 56920, 56882, 56845, 56807, 56769, 56732,
+		56694, 56657, 56619, 56582, 56544, 56507, 56469, 56432,
+		56394, 56357, 56319, 56282, 56244, 56207, 56170, 56132,
+		56095, 56058, 56021, 55983, 55946, 55909, 55872, 55834,
+		55797, 55760, 55723, 55686, 55649, 55611, 55574, 55537,
+		55500, 55463, 55426, 55389, 55352, 55315, 55278, 55241,
+		55204, 55167, 55131, 55094, 55057, 55020, 54983, 54946,
+		54910, 54873, 54836, 54799, 54763, 54726, 54689, 54652,
+		54616, 54579, 54543, 54506, 54469, 54433, 54396, 54360,
+		54323, 54287, 54250, 54214, 54177, 54141, 54104, 54068,
+		54031, 53995, 53959, 53922, 53886, 53850, 53813, 53777,
+		53741, 53705, 53668, 53632, 53596, 53560, 53524, 53487,
+		53451, 53415, 53379, 53343, 53307, 53271, 53235, 53199,
+		53163, 53127, 53091, 53055, 53019, 52983, 52947, 52911,
+		52875, 52839, 52804, 52768, 52732, 52696, 52660, 52625,
+		52589, 52553, 52517, 52482, 52446, 52410, 52375, 52339,
+		52303, 52268, 52232, 52197, 52161, 52126, 52090, 52055,
+		52019, 51984, 51948, 51913, 51877, 51842, 51806, 51771,
+		51736, 51700, 51665, 51630, 51594, 51559, 51524, 51489,
+		51453, 51418, 51383, 51348, 51313, 51277, 51242, 51207,
+		51172, 51137, 51102, 51067, 51032, 50997, 50962, 50927,
+		50892, 50857, 50822, 50787, 50752, 50717, 50682, 50647,
+		50613, 50578, 50543, 50508, 50473, 50439, 50404, 50369,
+		50334, 50300, 50265, 50230, 50196, 50161, 50126, 50092,
+		50057, 50023, 49988, 49954, 49919, 49885, 49850, 49816,
+		49781, 49747, 49712, 49678, 49643, 49609, 49575, 49540,
+		49506, 49472, 49437, 49403, 49369, 49334, 49300, 49266,
+		49232, 49198, 49163, 49129, 49095, 49061, 49027, 48993,
+		48959, 48925, 48891, 48857, 48823, 48789, 48755, 48721,
+		48687, 48653, 48619, 48585, 48551, 48517, 48483, 48449,
+		48415, 48382, 48348, 48314, 48280, 48247, 48213, 48179,
+		48145, 48112, 48078, 48044, 48011, 47977, 47944, 47910,
+		47876, 47843, 47809, 47776, 47742, 47709, 47675, 47642,
+		47608, 47575, 47541, 47508, 47475, 47441, 47408, 47375,
+		47341, 47308, 47275, 47241, 47208, 47175, 47142, 47108,
+		47075, 47042, 47009, 46976, 46942, 46909, 46876, 46843,
+		46810, 46777, 46744, 46711, 46678, 46645, 46612, 46579,
+		46546, 46513, 46480, 46447, 46414, 46381, 46349, 46316,
+		46283, 46250, 46217, 46184, 46152, 46119, 46086, 46053,
+		46021, 45988, 45955, 45923, 45890, 45857, 45825, 45792,
+		45760, 45727, 45695, 45662, 45630, 45597, 45565, 45532,
+		45500, 45467, 45435, 45402, 45370, 45338, 45305, 45273,
+		45240, 45208, 45176, 45144, 45111, 45079, 45047, 45015,
+		44982, 44950, 44918, 44886, 44854, 44821, 44789, 44757,
+		44725, 44693, 44661, 44629, 44597, 44565, 44533, 44501,
+		44469, 44437, 44405, 44373, 44341, 44309, 44278, 44246,
+		44214, 44182, 44150, 44118, 44087, 44055, 44023, 43991,
+		43960, 43928, 43896, 43865, 43833, 43801, 43770, 43738,
+		43706, 43675, 43643, 43612, 43580, 43549, 43517, 43486,
+		43454, 43423, 43391, 43360, 43328, 43297, 43266, 43234,
+		43203, 43171, 43140, 43109, 43078, 43046, 43015, 42984,
+		42952, 42921, 42890, 42859, 42828, 42797, 42765, 42734,
+		42703, 42672, 42641, 42610, 42579, 42548, 42517, 42486,
+		42455, 42424, 42393, 42362, 42331, 42300, 42269, 42238,
+		42207, 42176, 42146, 42115, 42084, 42053, 42022, 41992,
+		41961, 41930, 41899, 41869, 41838, 41807, 41777, 41746,
+		41715, 41685, 41654, 41624, 41593, 41562, 41532, 41501,
+		41471, 41440, 41410, 41379, 41349, 41319, 41288, 41258,
+		41227, 41197, 41167, 41136, 41106, 41076, 41045, 41015,
+		40985, 40954, 40924, 40894, 40864, 40834, 40803, 40773,
+		40743, 40713, 40683, 40653, 40623, 40592, 40562, 40532,
+		40502, 40472, 40442, 40412, 40382, 40352, 40322, 40292,
+		40263, 40233, 40203, 40173, 40143, 40113, 40083, 40054,
+		40024, 39994, 39964, 39934, 39905, 39875, 39845, 39816,
+		39786, 39756, 39727, 39697, 39667, 39638, 39608, 39578,
+		39549, 39519, 39490, 39460, 39431, 39401, 39372, 39342,
+		39313, 39284, 39254, 39225, 39195, 39166, 39137, 39107,
+		39078, 39049, 39019, 38990, 38961, 38931, 38902, 38873,
+		38844, 38815, 38785, 38756, 38727, 38698, 38669, 38640,
+		38611, 38582, 38552, 38523, 38494, 38465, 38436, 38407,
+		38378, 38349, 38320, 38292, 38263, 38234, 38205, 38176,
+		38147, 38118, 38089, 38061, 38032, 38003, 37974, 37945,
+		37917, 37888, 37859, 37831, 37802, 37773, 37745, 37716,
+		37687, 37659, 37630, 37601, 37573, 37544, 37516, 37487,
+		37459, 37430, 37402, 37373, 37345, 37316, 37288, 37260,
+		37231, 37203, 37174, 37146, 37118, 37089, 37061, 37033,
+		37005, 36976, 36948, 36920, 36892, 36863, 36835, 36807,
+		36779, 36751, 36722, 36694, 36666, 36638, 36610, 36582,
+		36554, 36526, 36498, 36470, 36442, 36414, 36386, 36358,
+		36330, 36302, 36274, 36246, 36218, 36191, 36163, 36135,
+		36107, 36079, 36051, 36024, 35996, 35968, 35940, 35913,
+		35885, 35857, 35830, 35802, 35774, 35747, 35719, 35691,
+		35664, 35636, 35609, 35581, 35554, 35526, 35499, 35471,
+		35444, 35416, 35389, 35361, 35334, 35306, 35279, 35252,
+		35224, 35197, 35170, 35142, 35115, 35088, 35060, 35033,
+		35006, 34979, 34951, 34924, 34897, 34870, 34843, 34815,
+		34788, 34761, 34734, 34707, 34680, 34653, 34626, 34599,
+		34572, 34545, 34518, 34491, 34464, 34437, 34410, 34383,
+		34356, 34329, 34302, 34275, 34248, 34222, 34195, 34168,
+		34141, 34114, 34088, 34061, 34034, 34007, 33981, 33954,
+		33927, 33901, 33874, 33847, 33821, 33794, 33767, 33741,
+		33714, 33688, 33661, 33635, 33608, 33581, 33555, 33528,
+		33502, 33476, 33449, 33423, 33396, 33370, 33344, 33317,
+		33291, 33264, 33238, 33212, 33185, 33159, 33133, 33107,
+		33080, 33054, 33028, 33002, 32976, 32949, 32923, 32897,
+		32871, 32845, 32819, 32793, 32767, 32740, 32714, 32688,
+		32662, 32636, 32610, 32584, 32558, 32532, 32507, 32481,
+		32455, 32429, 32403, 32377, 32351, 32325, 32299, 32274,
+		32248, 32222, 32196, 32171, 32145, 32119, 32093, 32068,
+		32042, 32016, 31991, 31965, 31939, 31914, 31888, 31862,
+		31837, 31811, 31786, 31760, 31735, 31709, 31684, 31658,
+		31633, 31607, 31582, 31556, 31531, 31506, 31480, 31455,
+		31429, 31404, 31379, 31353, 31328, 31303, 31277, 31252,
+		31227, 31202, 31176, 31151, 31126, 31101, 31076, 31051,
+		31025, 31000, 30975, 30950, 30925, 30900, 30875, 30850,
+		30825, 30800, 30775, 30750, 30725, 30700, 30675, 30650,
+		30625, 30600, 30575, 30550, 30525, 30500, 30476, 30451,
+		30426, 30401, 30376, 30352, 30327, 30302, 30277, 30253,
+		30228, 30203, 30178, 30154, 30129, 30104, 30080, 30055,
+		30031, 30006, 29981, 29957, 29932, 29908, 29883, 29859,
+		29834, 29810, 29785, 29761, 29736, 29712, 29687, 29663,
+		29639, 29614, 29590, 29566, 29541, 29517, 29493, 29468,
+		29444, 29420, 29396, 29371, 29347, 29323, 29299, 29274,
+		29250, 29226, 29202, 29178, 29154, 29130, 29105, 29081,
+		29057, 29033, 29009, 28985, 28961, 28937, 28913, 28889,
+		28865, 28841, 28817, 28793, 28769, 28746, 28722, 28698,
+		28674, 28650, 28626, 28602, 28579, 28555, 28531, 28507,
+		28484, 28460, 28436, 28412, 28389, 28365, 28341, 28318,
+		28294, 28270, 28247, 28223, 28199, 28176, 28152, 28129,
+		28105, 28082, 28058, 28035, 28011, 27988, 27964, 27941,
+		27917, 27894, 27871, 27847, 27824, 27800, 27777, 27754,
+		27730, 27707, 27684, 27660, 27637, 27614, 27591, 27567,
+		27544, 27521, 27498, 27474, 27451, 27428, 27405, 27382,
+		27359, 27336, 27313, 27289, 27266, 27243, 27220, 27197,
+		27174, 27151, 27128, 27105, 27082, 27059, 27036, 27013,
+		26991, 26968, 26945, 26922, 26899, 26876, 26853, 26830,
+		26808, 26785, 26762, 26739, 26717, 26694, 26671, 26648,
+		26626, 26603, 26580, 26558, 26535, 26512, 26490, 26467,
+		26444, 26422, 26399, 26377, 26354, 26332, 26309, 26286,
+		26264, 26241, 26219, 26197, 26174, 26152, 26129, 26107,
+		26084, 26062, 26040, 26017, 25995, 25973, 25950, 25928,
+		25906, 25883, 25861, 25839, 25817, 25794, 25772, 25750,
+		25728, 25706, 25683, 25661, 25639, 25617, 25595, 25573,
+		25551, 25529, 25506, 25484, 25462, 25440, 25418, 25396,
+		25374, 25352, 25330, 25308, 25286, 25265, 25243, 25221,
+		25199, 25177, 25155, 25133, 25111, 25090, 25068, 25046,
+		25024, 25002, 24981, 24959, 24937, 24915, 24894, 24872,
+		24850, 24829, 24807, 24785, 24764, 24742, 24720, 24699,
+		24677, 24656, 24634, 24613, 24591, 24569, 24548, 24526,
+		24505, 24483, 24462, 24441, 24419, 24398, 24376, 24355,
+		24333, 24312, 24291, 24269, 24248, 24227, 24205, 24184,
+		24163, 24142, 24120, 24099, 24078, 24057, 24035, 24014,
+		23993, 23972, 23951, 23930, 23908, 23887, 23866, 23845,
+		23824, 23803, 23782, 23761, 23740, 23719, 23698, 23677,
+		23656, 23635, 23614, 23593, 23572, 23551, 23530, 23509,
+		23488, 23467, 23446, 23426, 23405, 23384, 23363, 23342,
+		23322, 23301, 23280, 23259, 23239, 23218, 23197, 23176,
+		23156, 23135, 23114, 23094, 23073, 23052, 23032, 23011,
+		22991, 22970, 22949, 22929, 22908, 22888, 22867, 22847,
+		22826, 22806, 22785, 22765, 22744, 22724, 22704, 22683,
+		22663, 22642, 22622, 22602, 22581, 22561, 22541, 22520,
+		22500, 22480, 22459, 22439, 22419, 22399, 22378, 22358,
+		22338, 22318, 22298, 22278, 22257, 22237, 22217, 22197,
+		22177, 22157, 22137, 22117, 22097, 22077, 22057, 22036,
+		22016, 21996, 21976, 21957, 21937, 21917, 21897, 21877,
+		21857, 21837, 21817, 21797, 21777, 21757, 21738, 21718,
+		21698, 21678, 21658, 21639, 21619, 21599, 21579, 21560,
+		21540, 21520, 21501, 21481, 21461, 21442, 21422, 21402,
+		21383, 21363, 21343, 21324, 21304, 21285, 21265, 21246,
+		21226, 21207, 21187, 21168, 21148, 21129, 21109, 21090,
+		21070, 21051, 21031, 21012, 20993, 20973, 20954, 20935,
+		20915, 20896, 20877, 20857, 20838, 20819, 20800, 20780,
+		20761, 20742, 20723, 20703, 20684, 20665, 20646, 20627,
+		20608, 20588, 20569, 20550, 20531, 20512, 20493, 20474,
+		20455, 20436, 20417, 20398, 20379, 20360, 20341, 20322,
+		20303, 20284, 20265, 20246, 20227, 20208, 20189, 20170,
+		20152, 20133, 20114, 20095, 20076, 20057, 20039, 20020,
+		20001, 19982, 19964, 19945, 19926, 19907, 19889, 19870,
+		19851, 19833, 19814, 19795, 19777, 19758, 19740, 19721,
+		19702, 19684, 19665, 19647, 19628, 19610, 19591, 19573,
+		19554, 19536, 19517, 19499, 19480, 19462, 19444, 19425,
+		19407, 19388, 19370, 19352, 19333, 19315, 19297, 19278,
+		19260, 19242, 19223, 19205, 19187, 19169, 19150, 19132,
+		19114, 19096, 19078, 19059, 19041, 19023, 19005, 18987,
+		18969, 18951, 18933, 18914, 18896, 18878, 18860, 18842,
+		18824, 18806, 18788, 18770, 18752, 18734, 18716, 18698,
+		18680, 18663, 18645, 18627, 18609, 18591, 18573, 18555,
+		18537, 18520, 18502, 18484, 18466, 18448, 18431, 18413,
+		18395, 18377, 18360, 18342, 18324, 18307, 18289, 18271,
+		18254, 18236, 18218, 18201, 18183, 18165, 18148, 18130,
+		18113, 18095, 18078, 18060, 18043, 18025, 18008, 17990,
+		17973, 17955, 17938, 17920, 17903, 17885, 17868, 17851,
+		17833, 17816, 17798, 17781, 17764, 17746, 17729, 17712,
+		17694, 17677, 17660, 17643, 17625, 17608, 17591, 17574,
+		17557, 17539, 17522, 17505, 17488, 17471, 17454, 17436,
+		17419, 17402, 17385, 17368, 17351, 17334, 17317, 17300,
+		17283, 17266, 17249, 17232, 17215, 17198, 17181, 17164,
+		17147, 17130, 17113, 17096, 17079, 17062, 17046, 17029,
+		17012, 16995, 16978, 16961, 16945, 16928, 16911, 16894,
+		16877, 16861, 16844, 16827, 16811, 16794, 16777, 16760,
+		16744, 16727, 16710, 16694, 16677, 16661, 16644, 16627,
+		16611, 16594, 16578, 16561, 16545, 16528, 16512, 16495,
+		16479, 16462, 16446, 16429, 16413, 16396, 16380, 16363,
+		16347, 16331, 16314, 16298, 16281, 16265, 16249, 16232,
+		16216, 16200, 16184, 16167, 16151, 16135, 16118, 16102,
+		16086, 16070, 16054, 16037, 16021, 16005, 15989, 15973,
+		15957, 15940, 15924, 15908, 15892, 15876, 15860, 15844,
+		15828, 15812, 15796, 15780, 15764, 15748, 15732, 15716,
+		15700, 15684, 15668, 15652, 15636, 15620, 15604, 15588,
+		15572, 15556, 15541, 15525, 15509, 15493, 15477, 15461,
+		15446, 15430, 15414, 15398, 15383, 15367, 15351, 15335,
+		15320, 15304, 15288, 15273, 15257, 15241, 15226, 15210,
+		15194, 15179, 15163, 15148, 15132, 15116, 15101, 15085,
+		15070, 15054, 15039, 15023, 15008, 14992, 14977, 14961,
+		14946, 14930, 14915, 14900, 14884, 14869, 14853, 14838,
+		14823, 14807, 14792, 14777, 14761, 14746, 14731, 14715,
+		14700, 14685, 14669, 14654, 14639, 14624, 14608, 14593,
+		14578, 14563, 14548, 14533, 14517, 14502, 14487, 14472,
+		14457, 14442, 14427, 14412, 14397, 14381, 14366, 14351,
+		14336, 14321, 14306, 14291, 14276, 14261, 14246, 14231,
+		14216, 14202, 14187, 14172, 14157, 14142, 14127, 14112,
+		14097, 14082, 14068, 14053, 14038, 14023, 14008, 13993,
+		13979, 13964, 13949, 13934, 13920, 13905, 13890, 13876,
+		13861, 13846, 13831, 13817, 13802, 13787, 13773, 13758,
+		13744, 13729, 13714, 13700, 13685, 13671, 13656, 13642,
+		13627, 13613, 13598, 13584, 13569, 13555, 13540, 13526,
+		13511, 13497, 13482, 13468, 13453, 13439, 13425, 13410,
+		13396, 13382, 13367, 13353, 13339, 13324, 13310, 13296,
+		13281, 13267, 13253, 13239, 13224, 13210, 13196, 13182,
+		13167, 13153, 13139, 13125, 13111, 13097, 13082, 13068,
+		13054, 13040, 13026, 13012, 12998, 12984, 12970, 12956,
+		12942, 12928, 12914, 12900, 12886, 12872, 12858, 12844,
+		12830, 12816, 12802, 12788, 12774, 12760, 12746, 12732,
+		12718, 12704, 12691, 12677, 12663, 12649, 12635, 12621,
+		12608, 12594, 12580, 12566, 12553, 12539, 12525, 12511,
+		12498, 12484, 12470, 12457, 12443, 12429, 12416, 12402,
+		12388, 12375, 12361, 12347, 12334, 12320, 12307, 12293,
+		12280, 12266, 12252, 12239, 12225, 12212, 12198, 12185,
+		12171, 12158, 12145, 12131, 12118, 12104, 12091, 12077,
+		12064, 12051, 12037, 12024, 12010, 11997, 11984, 11970,
+		11957, 11944, 11931, 11917, 11904, 11891, 11877, 11864,
+		11851, 11838, 11824, 11811, 11798, 11785, 11772, 11759,
+		11745, 11732, 11719, 11706, 11693, 11680, 11667, 11654,
+		11640, 11627, 11614, 11601, 11588, 11575, 11562, 11549,
+		11536, 11523, 11510, 11497, 11484, 11471, 11458, 11445,
+		11432, 11420, 11407, 11394, 11381, 11368, 11355, 11342,
+		11329, 11317, 11304, 11291, 11278, 11265, 11252, 11240,
+		11227, 11214, 11201, 11189, 11176, 11163, 11150, 11138,
+		11125, 11112, 11100, 11087, 11074, 11062, 11049, 11037,
+		11024, 11011, 10999, 10986, 10974, 10961, 10948, 10936,
+		10923, 10911, 10898, 10886, 10873, 10861, 10848, 10836,
+		10823, 10811, 10798, 10786, 10774, 10761, 10749, 10736,
+		10724, 10712, 10699, 10687, 10675, 10662, 10650, 10638,
+		10625, 10613, 10601, 10588, 10576, 10564, 10552, 10539,
+		10527, 10515, 10503, 10490, 10478, 10466, 10454, 10442,
+		10430, 10417, 10405, 10393, 10381, 10369, 10357, 10345,
+		10333, 10321, 10308, 10296, 10284, 10272, 10260, 10248,
+		10236, 10224, 10212, 10200, 10188, 10176, 10164, 10152,
+		10141, 10129, 10117, 10105, 10093, 10081, 10069, 10057,
+		10045, 10034, 10022, 10010,  9998,  9986,  9974,  9963,
+		 9951,  9939,  9927,  9916,  9904,  9892,  9880,  9869,
+		 9857,  9845,  9834,  9822,  9810,  9798,  9787,  9775,
+		 9764,  9752,  9740,  9729,  9717,  9706,  9694,  9682,
+		 9671,  9659,  9648,  9636,  9625,  9613,  9602,  9590,
+		 9579,  9567,  9556,  9544,  9533,  9521,  9510,  9498,
+		 9487,  9476,  9464,  9453,  9441,  9430,  9419,  9407,
+		 9396,  9385,  9373,  9362,  9351,  9339,  9328,  9317,
+		 9306,  9294,  9283,  9272,  9261,  9249,  9238,  9227,
+		 9216,  9205,  9193,  9182,  9171,  9160,  9149,  9138,
+		 9127,  9115,  9104,  9093,  9082,  9071,  9060,  9049,
+		 9038,  9027,  9016,  9005,  8994,  8983,  8972,  8961,
+		 8950,  8939,  8928,  8917,  8906,  8895,  8884,  8873,
+		 8862,  8851,  8840,  8830,  8819,  8808,  8797,  8786,
+		 8775,  8765,  8754,  8743,  8732,  8721,  8710,  8700,
+		 8689,  8678,  8667,  8657,  8646,  8635,  8625,  8614,
+		 8603,  8592,  8582,  8571,  8560,  8550,  8539,  8529,
+		 8518,  8507,  8497,  8486,  8475,  8465,  8454,  8444,
+		 8433,  8423,  8412,  8402,  8391,  8381,  8370,  8360,
+		 8349,  8339,  8328,  8318,  8307,  8297,  8286,  8276,
+		 8266,  8255,  8245,  8234,  8224,  8214,  8203,  8193,
+		 8183,  8172,  8162,  8152,  8141,  8131,  8121,  8110,
+		 8100,  8090,  8080,  8069,  8059,  8049,  8039,  8028,
+		 8018,  8008,  7998,  7988,  7978,  7967,  7957,  7947,
+		 7937,  7927,  7917,  7907,  7896,  7886,  7876,  7866,
+		 7856,  7846,  7836,  7826,  7816,  7806,  7796,  7786,
+		 7776,  7766,  7756,  7746,  7736,  7726,  7716,  7706,
+		 7696,  7686,  7676,  7667,  7657,  7647,  7637,  7627,
+		 7617,  7607,  7597,  7588,  7578,  7568,  7558,  7548,
+		 7539,  7529,  7519,  7509,  7499,  7490,  7480,  7470,
+		 7460,  7451,  7441,  7431,  7422,  7412,  7402,  7393,
+		 7383,  7373,  7364,  7354,  7344,  7335,  7325,  7316,
+		 7306,  7296,  7287,  7277,  7268,  7258,  7249,  7239,
+		 7230,  7220,  7211,  7201,  7192,  7182,  7173,  7163,
+		 7154,  7144,  7135,  7125,  7116,  7107,  7097,  7088,
+		 7078,  7069,  7060,  7050,  7041,  7031,  7022,  7013,
+		 7003,  6994,  6985,  6976,  6966,  6957,  6948,  6938,
+		 6929,  6920,  6911,  6901,  6892,  6883,  6874,  6865,
+		 6855,  6846,  6837,  6828,  6819,  6810,  6800,  6791,
+		 6782,  6773,  6764,  6755,  6746,  6737,  6728,  6719,
+		 6709,  6700,  6691,  6682,  6673,  6664,  6655,  6646,
+		 6637,  6628,  6619,  6610,  6601,  6592,  6583,  6574,
+		 6566,  6557,  6548,  6539,  6530,  6521,  6512,  6503,
+		 6494,  6486,  6477,  6468,  6459,  6450,  6441,  6433,
+		 6424,  6415,  6406,  6397,  6389,  6380,  6371,  6362,
+		 6354,  6345,  6336,  6327,  6319,  6310,  6301,  6293,
+		 6284,  6275,  6267,  6258,  6249,  6241,  6232,  6223,
+		 6215,  6206,  6198,  6189,  6181,  6172,  6163,  6155,
+		 6146,  6138,  6129,  6121,  6112,  6104,  6095,  6087,
+		 6078,  6070,  6061,  6053,  6044,  6036,  6027,  6019,
+		 6011,  6002,  5994,  5985,  5977,  5969,  5960,  5952,
+		 5944,  5935,  5927,  5918,  5910,  5902,  5894,  5885,
+		 5877,  5869,  5860,  5852,  5844,  5836,  5827,  5819,
+		 5811,  5803,  5794,  5786,  5778,  5770,  5762,  5753,
+		 5745,  5737,  5729,  5721,  5713,  5705,  5696,  5688,
+		 5680,  5672,  5664,  5656,  5648,  5640,  5632,  5624,
+		 5616,  5608,  5599,  5591,  5583,  5575,  5567,  5559,
+		 5551,  5543,  5535,  5528,  5520,  5512,  5504,  5496,
+		 5488,  5480,  5472,  5464,  5456,  5448,  5440,  5433,
+		 5425,  5417,  5409,  5401,  5393,  5385,  5378,  5370,
+		 5362,  5354,  5346,  5339,  5331,  5323,  5315,  5308,
+		 5300,  5292,  5284,  5277,  5269,  5261,  5254,  5246,
+		 5238,  5231,  5223,  5215,  5208,  5200,  5192,  5185,
+		 5177,  5169,  5162,  5154,  5147,  5139,  5131,  5124,
+		 5116,  5109,  5101,  5094,  5086,  5079,  5071,  5064,
+		 5056,  5049,  5041,  5034,  5026,  5019,  5011,  5004,
+		 4996,  4989,  4981,  4974,  4967,  4959,  4952,  4944,
+		 4937,  4930,  4922,  4915,  4907,  4900,  4893,  4885,
+		 4878,  4871,  4864,  4856,  4849,  4842,  4834,  4827,
+		 4820,  4813,  4805,  4798,  4791,  4784,  4776,  4769,
+		 4762,  4755,  4747,  4740,  4733,  4726,  4719,  4712,
+		 4704,  4697,  4690,  4683,  4676,  4669,  4662,  4655,
+		 4648,  4640,  4633,  4626,  4619,  4612,  4605,  4598,
+		 4591,  4584,  4577,  4570,  4563,  4556,  4549,  4542,
+		 4535,  4528,  4521,  4514,  4507,  4500,  4493,  4486,
+		 4479,  4472,  4466,  4459,  4452,  4445,  4438,  4431,
+		 4424,  4417,  4411,  4404,  4397,  4390,  4383,  4376,
+		 4370,  4363,  4356,  4349,  4342,  4336,  4329,  4322,
+		 4315,  4309,  4302,  4295,  4288,  4282,  4275,  4268,
+		 4262,  4255,  4248,  4242,  4235,  4228,  4222,  4215,
+		 4208,  4202,  4195,  4188,  4182,  4175,  4169,  4162,
+		 4155,  4149,  4142,  4136,  4129,  4123,  4116,  4110,
+		 4103,  4096,  4090,  4083,  4077,  4070,  4064,  4057,
+		 4051,  4045,  4038,  4032,  4025,  4019,  4012,  4006,
+		 3999,  3993,  3987,  3980,  3974,  3967,  3961,  3955,
+		 3948,  3942,  3936,  3929,  3923,  3917,  3910,  3904,
+		 3898,  3891,  3885,  3879,  3873,  3866,  3860,  3854,
+		 3847,  3841,  3835,  3829,  3823,  3816,  3810,  3804,
+		 3798,  3791,  3785,  3779,  3773,  3767,  3761,  3754,
+		 3748,  3742,  3736,  3730,  3724,  3718,  3712,  3705,
+		 3699,  3693,  3687,  3681,  3675,  3669,  3663,  3657,
+		 3651,  3645,  3639,  3633,  3627,  3621,  3615,  3609,
+		 3603,  3597,  3591,  3585,  3579,  3573,  3567,  3561,
+		 3555,  3549,  3543,  3537,  3531,  3526,  3520,  3514,
+		 3508,  3502,  3496,  3490,  3484,  3479,  3473,  3467,
+		 3461,  3455,  3449,  3444,  3438,  3432,  3426,  3420,
+		 3415,  3409,  3403,  3397,  3392,  3386,  3380,  3374,
+		 3369,  3363,  3357,  3352,  3346,  3340,  3334,  3329,
+		 3323,  3317,  3312,  3306,  3300,  3295,  3289,  3284,
+		 3278,  3272,  3267,  3261,  3256,  3250,  3244,  3239,
+		 3233,  3228,  3222,  3217,  3211,  3205,  3200,  3194,
+		 3189,  3183,  3178,  3172,  3167,  3161,  3156,  3150,
+		 3145,  3139,  3134,  3129,  3123,  3118,  3112,  3107,
+		 3101,  3096,  3091,  3085,  3080,  3074,  3069,  3064,
+		 3058,  3053,  3048,  3042,  3037,  3032,  3026,  3021,
+		 3016,  3010,  3005,  3000,  2994,  2989,  2984,  2979,
+		 2973,  2968,  2963,  2957,  2952,  2947,  2942,  2937,
+		 2931,  2926,  2921,  2916,  2911,  2905,  2900,  2895,
+		 2890,  2885,  2879,  2874,  2869,  2864,  2859,  2854,
+		 2849,  2844,  2838,  2833,  2828,  2823,  2818,  2813,
+		 2808,  2803,  2798,  2793,  2788,  2783,  2778,  2773,
+		 2768,  2763,  2758,  2753,  2748,  2743,  2738,  2733,
+		 2728,  2723,  2718,  2713,  2708,  2703,  2698,  2693,
+		 2688,  2683,  2678,  2673,  2668,  2664,  2659,  2654,
+		 2649,  2644,  2639,  2634,  2629,  2625,  2620,  2615,
+		 2610,  2605,  2600,  2596,  2591,  2586,  2581,  2576,
+		 2572,  2567,  2562,  2557,  2553,  2548,  2543,  2538,
+		 2534,  2529,  2524,  2519,  2515,  2510,  2505,  2501,
+		 2496,  2491,  2487,  2482,  2477,  2473,  2468,  2463,
+		 2459,  2454,  2449,  2445,  2440,  2436,  2431,  2426,
+		 2422,  2417,  2413,  2408,  2403,  2399,  2394,  2390,
+		 2385,  2381,  2376,  2372,  2367,  2363,  2358,  2353,
+		 2349,  2344,  2340,  2336,  2331,  2327,  2322,  2318,
+		 2313,  2309,  2304,  2300,  2295,  2291,  2287,  2282,
+		 2278,  2273,  2269,  2265,  2260,  2256,  2251,  2247,
+		 2243,  2238,  2234,  2230,  2225,  2221,  2217,  2212,
+		 2208,  2204,  2199,  2195,  2191,  2186,  2182,  2178,
+		 2174,  2169,  2165,  2161,  2157,  2152,  2148,  2144,
+		 2140,  2135,  2131,  2127,  2123,  2118,  2114,  2110,
+		 2106,  2102,  2098,  2093,  2089,  2085,  2081,  2077,
+		 2073,  2068,  2064,  2060,  2056,  2052,  2048,  2044,
+		 2040,  2036,  2032,  2027,  2023,  2019,  2015,  2011,
+		 2007,  2003,  1999,  1995,  1991,  1987,  1983,  1979,
+		 1975,  1971,  1967,  1963,  1959,  1955,  1951,  1947,
+		 1943,  1939,  1935,  1931,  1927,  1923,  1919,  1915,
+		 1911,  1908,  1904,  1900,  1896,  1892,  1888,  1884,
+		 1880,  1876,  1872,  1869,  1865,  1861,  1857,  1853,
+		 1849,  1846,  1842,  1838,  1834,  1830,  1826,  1823,
+		 1819,  1815,  1811,  1807,  1804,  1800,  1796,  1792,
+		 1789,  1785,  1781,  1777,  1774,  1770,  1766,  1763,
+		 1759,  1755,  1751,  1748,  1744,  1740,  1737,  1733,
+		 1729,  1726,  1722,  1718,  1715,  1711,  1707,  1704,
+		 1700,  1696,  1693,  1689,  1686,  1682,  1678,  1675,
+		 1671,  1668,  1664,  1661,  1657,  1653,  1650,  1646,
+		 1643,  1639,  1636,  1632,  1629,  1625,  1622,  1618,
+		 1615,  1611,  1608,  1604,  1601,  1597,  1594,  1590,
+		 1587,  1583,  1580,  1576,  1573,  1569,  1566,  1563,
+		 1559,  1556,  1552,  1549,  1545,  1542,  1539,  1535,
+		 1532,  1529,  1525,  1522,  1518,  1515,  1512,  1508,
+		 1505,  1502,  1498,  1495,  1492,  1488,  1485,  1482,
+		 1478,  1475,  1472,  1468,  1465,  1462,  1459,  1455,
+		 1452,  1449,  1446,  1442,  1439,  1436,  1433,  1429,
+		 1426,  1423,  1420,  1416,  1413,  1410,  1407,  1404,
+		 1400,  1397,  1394,  1391,  1388,  1385,  1381,  1378,
+		 1375,  1372,  1369,  1366,  1363,  1359,  1356,  1353,
+		 1350,  1347,  1344,  1341,  1338,  1335,  1332,  1328,
+		 1325,  1322,  1319,  1316,  1313,  1310,  1307,  1304,
+		 1301,  1298,  1295,  1292,  1289,  1286,  1283,  1280,
+		 1277,  1274,  1271,  1268,  1265,  1262,  1259,  1256,
+		 1253,  1250,  1247,  1244,  1241,  1238,  1235,  1232,
+		 1229,  1227,  1224,  1221,  1218,  1215,  1212,  1209,
+		 1206,  1203,  1200,  1198,  1195,  1192,  1189,  1186,
+		 1183,  1180,  1178,  1175,  1172,  1169,  1166,  1163,
+		 1161,  1158,  1155,  1152,  1149,  1147,  1144,  1141,
+		 1138,  1136,  1133,  1130,  1127,  1124,  1122,  1119,
+		 1116,  1114,  1111,  1108,  1105,  1103,  1100,  1097,
+		 1094,  1092,  1089,  1086,  1084,  1081,  1078,  1076,
+		 1073,  1070,  1068,  1065,  1062,  1060,  1057,  1054,
+		 1052,  1049,  1047,  1044,  1041,  1039,  1036,  1033,
+		 1031,  1028,  1026,  1023,  1020,  1018,  1015,  1013,
+		 1010,  1008,  1005,  1003,  1000,   997,   995,   992,
+		  990,   987,   985,   982,   980,   977,   975,   972,
+		  970,   967,   965,   962,   960,   957,   955,   952,
+		  950,   947,   945,   943,   940,   938,   935,   933,
+		  930,   928,   926,   923,   921,   918,   916,   913,
+		  911,   909,   906,   904,   902,   899,   897,   894,
+		  892,   890,   887,   885,   883,   880,   878,   876,
+		  873,   871,   869,   866,   864,   862,   859,   857,
+		  855,   853,   850,   848,   846,   843,   841,   839,
+		  837,   834,   832,   830,   828,   825,   823,   821,
+		  819,   816,   814,   812,   810,   808,   805,   803,
+		  801,   799,   797,   794,   792,   790,   788,   786,
+		  784,   781,   779,   777,   775,   773,   771,   768,
+		  766,   764,   762,   760,   758,   756,   754,   752,
+		  749,   747,   745,   743,   741,   739,   737,   735,
+		  733,   731,   729,   727,   725,   722,   720,   718,
+		  716,   714,   712,   710,   708,   706,   704,   702,
+		  700,   698,   696,   694,   692,   690,   688,   686,
+		  684,   682,   680,   678,   676,   674,   672,   670,
+		  669,   667,   665,   663,   661,   659,   657,   655,
+		  653,   651,   649,   647,   645,   644,   642,   640,
+		  638,   636,   634,   632,   630,   628,   627,   625,
+		  623,   621,   619,   617,   615,   614,   612,   610,
+		  608,   606,   604,   603,   601,   599,   597,   595,
+		  594,   592,   590,   588,   586,   585,   583,   581,
+		  579,   578,   576,   574,   572,   570,   569,   567,
+		  565,   563,   562,   560,   558,   556,   555,   553,
+		  551,   549,   547,   546,   544,   542,   540,   539,
+		  537,   535,   533,   532,   530,   528,   526,   524,
+		  523,   521,   519,   517,   516,   514,   512,   510,
+		  508,   507,   505,   503,   501,   500,   498,   496,
+		  494,   493,   491,   489,   487,   485,   484,   482,
+		  480,   478,   477,   475,   473,   471,   469,   468,
+		  466,   464,   462,   461,   459,   457,   455,   454,
+		  452,   450,   448,   446,   445,   443,   441,   439,
+		  438,   436,   434,   432,   431,   429,   427,   425,
+		  423,   422,   420,   418,   416,   415,   413,   411,
+		  409,   407,   406,   404,   402,   400,   399,   397,
+		  395,   393,   392,   390,   388,   386,   384,   383,
+		  381,   379,   377,   376,   374,   372,   370,   369,
+		  367,   365,   363,   361,   360,   358,   356,   354,
+		  353,   351,   349,   347,   345,   344,   342,   340,
+		  338,   337,   335,   333,   331,   330,   328,   326,
+		  324,   322,   321,   319,   317,   315,   314,   312,
+		  310,   308,   307,   305,   303,   301,   299,   298,
+		  296,   294,   292,   291,   289,   287,   285,   283,
+		  282,   280,   278,   276,   275,   273,   271,   269,
+		  268,   266,   264,   262,   260,   259,   257,   255,
+		  253,   252,   250,   248,   246,   244,   243,   241,
+		  239,   237,   236,   234,   232,   230,   229,   227,
+		  225,   223,   221,   220,   218,   216,   214,   213,
+		  211,   209,   207,   206,   204,   202,   200,   198,
+		  197,   195,   193,   191,   190,   188,   186,   184,
+		  182,   181,   179,   177,   175,   174,   172,   170,
+		  168,   167,   165,   163,   161,   159,   158,   156,
+		  154,   152,   151,   149,   147,   145,   144,   142,
+		  140,   138,   136,   135,   133,   131,   129,   128,
+		  126,   124,   122,   120,   119,   117,   115,   113,
+		  112,   110,   108,   106,   105,   103,   101,    99,
+		   97,    96,    94,    92,    90,    89,    87,    85,
+		   83,    81,    80,    78,    76,    74,    73,    71,
+		   69,    67,    66,    64,    62,    60,    58,    57,
+		   55,    53,    51,    50,    48,    46,    44,    43,
+		   41,    39,    37,    35,    34,    32,    30,    28,
+		   27,    25,    23,    21,    19,    18,    16,    14,
+		   12,    11,     9,     7,     5,     4,     2,     0
+};
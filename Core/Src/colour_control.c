@@ -1,244 +1,350 @@
 #include "stm32f3xx_hal.h"
+#include <math.h>
 #include <stdint.h>
 #include <stdio.h>
 #include "globals.h"
 #include "state_machine.h"
 #include "external_interrupts.h"
 #include "kelvin_to_rgb.h"
+#include "LED_pwm.h"
+#include "brightness_table.h"
+#include "luminance_balance.h"
+#include "hue_table.h"
+
+/*
+ * Colours are worked out as Q16 on-fractions (COLOUR_ONE is fully on), scaled
+ * by the brightness gain and only then converted to inverted BLANK duty. The
+ * ADC range is a power of two and the tables are spaced in powers of two, so
+ * no stage divides.
+ */
+
+static inline uint32_t pot_to_colour(uint16_t pot_value) {
+	return (uint32_t) pot_value << (COLOUR_SHIFT - ADC_RES_BITS);
+}
+
+/*
+ * brightness_table and the gain tables are uint16_t, so they store full
+ * scale as 65535. Adding the top bit back gives exactly COLOUR_ONE at full
+ * scale and stays within a Q16 step everywhere else.
+ */
+static inline uint32_t table_to_colour(uint32_t entry) {
+	return entry + (entry >> 15);
+}
+
+/**
+ * @brief Finds the brightness gain for a brightness pot reading.
+ *
+ * @param pot_value: Pot 1 reading, 0 (full brightness) to ADC_RES - 1 (off).
+ *
+ * @return The gain, Q16 (COLOUR_ONE at 0, 0 at ADC_RES - 1).
+ */
+uint32_t brightness_gain(uint16_t pot_value) {
+	return table_to_colour(brightness_table[pot_value]);
+}
+
+/* Spacing of white_table entries in pot counts. */
+#define WHITE_TABLE_STEP_BITS (ADC_RES_BITS - WHITE_TABLE_BITS)
+
+/* Mireds are worked in 1/16 steps, so kelvin = MIRED_SCALE / mired. */
+#define MIRED_SCALE 16000000UL
+
+/* Q16 colour (R, G, B) at every WHITE_TABLE_STEP_BITS pot counts. */
+static uint16_t white_table[WHITE_TABLE_LENGTH][3];
+
+#ifdef CONSTANT_LUMINANCE
+/* Q16 luminance gain per pot position, spaced like white_table. */
+static uint16_t white_gains[WHITE_TABLE_LENGTH];
+static uint16_t hue_gains[WHITE_TABLE_LENGTH];
+#endif /* CONSTANT_LUMINANCE */
+
+/**
+ * @brief Converts an 8-bit gamma-encoded sRGB value to a Q16 linear colour.
+ *
+ * Only used when white_table is rebuilt, so the single precision maths is
+ * kept off the per-frame path.
+ *
+ * @param value: The sRGB value, 0 to 255.
+ *
+ * @return The linear light value, Q16.
+ */
+static uint32_t srgb_to_colour(uint32_t value) {
+	float encoded = value / 255.0f;
+	float linear = (encoded <= 0.04045f) ? encoded / 12.92f :
+			powf((encoded + 0.055f) / 1.055f, 2.4f);
+	return (uint32_t) (linear * COLOUR_ONE + 0.5f);
+}
+
+/**
+ * @brief Fills white_table from kelvin_table.
+ *
+ * Pot 2 selects a colour temperature between the ends of kelvin_table,
+ * hottest at 0. The entries are evenly spaced in mireds (1e6 / kelvin)
+ * rather than kelvin, as a step in mireds looks about the same size
+ * anywhere on the range; even kelvin steps spend most of the pot on
+ * near-identical cool whites and cramp the warm end. Called at start-up
+ * and again whenever the colours behind kelvin_table are recalibrated.
+ *
+ * kelvin_table is gamma-encoded sRGB. Until a luminance balance has been
+ * fitted the values are used as they are, so the output is unchanged. The
+ * fitted gains expect linear sRGB, so from then on the entries are
+ * linearised. The calibration sweep always drives the raw table values
+ * (see white_drive()).
+ *
+ * @return None.
+ */
+void generate_white_table(void) {
+	uint32_t min_mired = MIRED_SCALE
+			/ kelvin_table[KELVIN_TABLE_LENGTH - 1].kelvin;
+	uint32_t max_mired = MIRED_SCALE / kelvin_table[0].kelvin;
+
+	for (uint32_t i = 0; i < WHITE_TABLE_LENGTH; i++) {
+		uint32_t pot_value = i << WHITE_TABLE_STEP_BITS;
+		uint32_t mired = min_mired
+				+ ((pot_value * (max_mired - min_mired)) >> ADC_RES_BITS);
+		uint32_t kelvin = (MIRED_SCALE + mired / 2) / mired;
 
-void calculate_pulse_values(uint16_t *pulse_values) {
-	switch (current_state) {
-	case STANDBY:
-		break;
-
-	case WHITE_LIGHT:
-		/* Convert POT2 reading to a kelvin value. */
-		uint32_t min_kelvin = kelvin_table[0].kelvin;
-		uint32_t max_kelvin = kelvin_table[KELVIN_TABLE_LENGTH - 1].kelvin;
-		uint32_t kelvin_range = max_kelvin - min_kelvin;
-		uint32_t kelvin = max_kelvin
-				- (uint32_t) ((uint64_t) pot2_moving_average * kelvin_range
-						/ ADC_RES);
-		kelvin = (uint16_t) kelvin;
-
-		/* Convert the kelvin value to an RGB pulse vector. */
 		KelvinToRGB lower;
 		KelvinToRGB higher;
-		search_rgb_to_kelvin(kelvin, &lower, &higher);
-		pulse_for_kelvin(kelvin, &lower, &higher, pulse_values);
-
-		/* Adjust the RGB pulse vector for brightness */
-		pulse_values[0] = pulse_values[0]
-				+ (uint16_t) ((uint32_t) pot1_moving_average
-						* (COUNTER_PERIOD - pulse_values[0]) / ADC_RES);
-		pulse_values[1] = pulse_values[1]
-				+ (uint16_t) ((uint32_t) pot1_moving_average
-						* (COUNTER_PERIOD - pulse_values[1]) / ADC_RES);
-		pulse_values[2] = pulse_values[2]
-				+ (uint16_t) ((uint32_t) pot1_moving_average
-						* (COUNTER_PERIOD - pulse_values[2]) / ADC_RES);
-		break;
-
-	case RGB_LIGHT:
-		uint32_t colour = (ADC_RES - 1) - pot2_moving_average;
-		uint32_t segment_length = ADC_RES / 6;
-		uint32_t segment = colour / segment_length;
-		uint32_t segment_position = colour % segment_length;
-		uint32_t value = (COUNTER_PERIOD * segment_position) / segment_length;
-
-		/* Calculate the RGB colour vector. */
-		switch (segment) {
-		case 0:
-			pulse_values[0] = COUNTER_PERIOD;
-			pulse_values[1] = value;
-			pulse_values[2] = 0;
-			break;
-
-		case 1:
-			pulse_values[0] = (COUNTER_PERIOD - value);
-			pulse_values[1] = COUNTER_PERIOD;
-			pulse_values[2] = 0;
-			break;
-
-		case 2:
-			pulse_values[0] = 0;
-			pulse_values[1] = COUNTER_PERIOD;
-			pulse_values[2] = value;
-			break;
-
-		case 3:
-			pulse_values[0] = 0;
-			pulse_values[1] = (COUNTER_PERIOD - value);
-			pulse_values[2] = COUNTER_PERIOD;
-			break;
-
-		case 4:
-			pulse_values[0] = value;
-			pulse_values[1] = 0;
-			pulse_values[2] = COUNTER_PERIOD;
-			break;
-
-		case 5:
-			pulse_values[0] = COUNTER_PERIOD;
-			pulse_values[1] = 0;
-			pulse_values[2] = (COUNTER_PERIOD - value);
-			break;
-
-		case 6:
-			pulse_values[0] = COUNTER_PERIOD;
-			pulse_values[1] = 0;
-			pulse_values[2] = 0;
-		}
+		uint32_t rgb_values[3];
+		uint16_t weight = search_rgb_to_kelvin(kelvin, &lower, &higher);
+		rgb_for_kelvin(weight, &lower, &higher, rgb_values);
 
-		/* Invert pulse values as BLANK is active low. */
-		pulse_values[0] = COUNTER_PERIOD - pulse_values[0];
-		pulse_values[1] = COUNTER_PERIOD - pulse_values[1];
-		pulse_values[2] = COUNTER_PERIOD - pulse_values[2];
-
-		/* Adjust the RGB pulse vector for brightness */
-		pulse_values[0] = pulse_values[0]
-				+ (uint16_t) ((uint32_t) pot1_moving_average
-						* (COUNTER_PERIOD - pulse_values[0]) / ADC_RES);
-		pulse_values[1] = pulse_values[1]
-				+ (uint16_t) ((uint32_t) pot1_moving_average
-						* (COUNTER_PERIOD - pulse_values[1]) / ADC_RES);
-		pulse_values[2] = pulse_values[2]
-				+ (uint16_t) ((uint32_t) pot1_moving_average
-						* (COUNTER_PERIOD - pulse_values[2]) / ADC_RES);
-		break;
-
-	case POT_CALIBRATION:
-		if ((pot_cal_substate == POT_1_LOWER)
-				|| (pot_cal_substate == POT_1_UPPER)) {
-			pulse_values[0] = (pot1_moving_average * COUNTER_PERIOD / ADC_RES);
-			pulse_values[1] = COUNTER_PERIOD;
-			pulse_values[2] = COUNTER_PERIOD;
-		} else if ((pot_cal_substate == POT_2_LOWER)
-				|| (pot_cal_substate == POT_2_UPPER)) {
-			pulse_values[0] = COUNTER_PERIOD;
-			pulse_values[1] = (pot2_moving_average * COUNTER_PERIOD / ADC_RES);
-			pulse_values[2] = COUNTER_PERIOD;
-		} else if ((pot_cal_substate == POT_3_LOWER)
-				|| (pot_cal_substate == POT_3_UPPER)) {
-			pulse_values[0] = COUNTER_PERIOD;
-			pulse_values[1] = COUNTER_PERIOD;
-			pulse_values[2] = (pot3_moving_average * COUNTER_PERIOD / ADC_RES);
-		} else {
-			pulse_values[0] = (pot1_moving_average * COUNTER_PERIOD / ADC_RES);
-			pulse_values[1] = (pot1_moving_average * COUNTER_PERIOD / ADC_RES);
-			pulse_values[2] = (pot1_moving_average * COUNTER_PERIOD / ADC_RES);
+		/* The table's 8-bit values are fractions of 256. */
+		for (int channel = 0; channel < 3; channel++) {
+			uint32_t colour = luminance_balance_fitted ?
+					srgb_to_colour(rgb_values[channel]) :
+					rgb_values[channel] << (COLOUR_SHIFT - 8);
+			white_table[i][channel] = (colour > UINT16_MAX) ? UINT16_MAX : colour;
 		}
-		break;
+	}
+}
 
-	case LED_CALIBRATION:
-		pulse_values[0] = (pot1_moving_average * COUNTER_PERIOD / ADC_RES);
-		pulse_values[1] = (pot2_moving_average * COUNTER_PERIOD / ADC_RES);
-		pulse_values[2] = (pot3_moving_average * COUNTER_PERIOD / ADC_RES);
-		break;
+/* Pot 2 selects a colour temperature, interpolated from white_table. */
+static void white_colour(uint32_t *colour) {
+	uint32_t index = pot2_moving_average >> WHITE_TABLE_STEP_BITS;
+	int32_t fraction = pot2_moving_average & ((1 << WHITE_TABLE_STEP_BITS) - 1);
+
+	const uint16_t *below = white_table[index];
+	const uint16_t *above = white_table[index + 1];
+	for (int channel = 0; channel < 3; channel++) {
+		colour[channel] = below[channel]
+				+ ((((int32_t) above[channel] - below[channel]) * fraction)
+						>> WHITE_TABLE_STEP_BITS);
 	}
 }
 
-uint16_t clamp(uint16_t value, uint16_t min, uint16_t max) {
-	if (value < min) {
-		return min;
-	} else if (value > max) {
-		return max;
+/* Spacing of hue_table entries in hue positions. */
+#define HUE_TABLE_STEP_BITS (ADC_RES_BITS - HUE_TABLE_BITS)
+
+/**
+ * @brief Finds the colour at a point on the hue wheel.
+ *
+ * The wheel runs from red through yellow, green, cyan, blue and magenta in
+ * even OkLCh hue steps (see Tools/generate_hue_table.py). RGB_LIGHT and
+ * the colour calibration sweep both take their colours from here.
+ *
+ * @param position: Point on the wheel, 0 (red) to ADC_RES - 1.
+ * @param saturation: Q16 mix from white (0) to the pure hue (COLOUR_ONE).
+ * @param colour: Array to fill with the Q16 colour (R, G, B).
+ *
+ * @return None.
+ */
+void hue_colour(uint32_t position, uint32_t saturation, uint32_t *colour) {
+	uint32_t index = position >> HUE_TABLE_STEP_BITS;
+	int32_t fraction = position & ((1 << HUE_TABLE_STEP_BITS) - 1);
+
+	const uint16_t *below = hue_table[index];
+	const uint16_t *above = hue_table[index + 1];
+	for (int channel = 0; channel < 3; channel++) {
+		uint32_t pure = below[channel]
+				+ ((((int32_t) above[channel] - below[channel]) * fraction)
+						>> HUE_TABLE_STEP_BITS);
+		colour[channel] = COLOUR_ONE
+				- (((uint64_t) (COLOUR_ONE - pure) * saturation) >> COLOUR_SHIFT);
 	}
-	return value;
 }
 
-void set_pulse_values(uint16_t *pulse_values) {
-	clamp(pulse_values[0], 0, COUNTER_PERIOD);
-	clamp(pulse_values[1], 0, COUNTER_PERIOD);
-	clamp(pulse_values[2], 0, COUNTER_PERIOD);
+#ifdef CONSTANT_LUMINANCE
+/**
+ * @brief Finds the luminance of the light emitted for a colour table entry.
+ *
+ * @param hue: 1 for the hue at the entry, 0 for the white.
+ * @param index: The entry, 0 to WHITE_TABLE_LENGTH - 1.
+ *
+ * @return The luminance, Q16 of all colours fully on.
+ */
+static uint32_t entry_luminance(uint8_t hue, uint32_t index) {
+	uint32_t colour[3];
+	if (hue) {
+		uint32_t pot_value = index << WHITE_TABLE_STEP_BITS;
+		pot_value = (pot_value < ADC_RES) ? pot_value : ADC_RES - 1;
+		hue_colour((ADC_RES - 1) - pot_value, HUE_SATURATION, colour);
+	} else {
+		colour[0] = white_table[index][0];
+		colour[1] = white_table[index][1];
+		colour[2] = white_table[index][2];
+	}
+	apply_luminance_balance(colour);
+
+	uint64_t luminance = 0;
+	for (int channel = 0; channel < 3; channel++) {
+		luminance += (uint64_t) luminance_weights[channel] * colour[channel];
+	}
+	return luminance >> LUMINANCE_WEIGHT_SHIFT;
+}
+
+/**
+ * @brief Fills one gain table so the entries match a common luminance.
+ *
+ * The target is the dimmest entry's luminance, raised to
+ * CONSTANT_LUMINANCE_MIN_GAIN of the brightest's if that is higher. Entries
+ * above the target are scaled down to it; the rest stay at full scale.
+ *
+ * @param hue: 1 for the hue gains, 0 for the white gains.
+ * @param gains: The table to fill.
+ *
+ * @return None.
+ */
+static void generate_gains(uint8_t hue, uint16_t *gains) {
+	uint32_t dimmest = UINT32_MAX;
+	uint32_t brightest = 0;
+	for (uint32_t i = 0; i < WHITE_TABLE_LENGTH; i++) {
+		uint32_t luminance = entry_luminance(hue, i);
+		dimmest = (luminance < dimmest) ? luminance : dimmest;
+		brightest = (luminance > brightest) ? luminance : brightest;
+	}
 
-	__HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_3, pulse_values[0]);
-	__HAL_TIM_SET_COMPARE(&htim15, TIM_CHANNEL_1, pulse_values[1]);
-	__HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_1, pulse_values[2]);
+	uint32_t lowest = ((uint64_t) brightest * CONSTANT_LUMINANCE_MIN_GAIN)
+			>> COLOUR_SHIFT;
+	uint32_t target = (dimmest > lowest) ? dimmest : lowest;
+	for (uint32_t i = 0; i < WHITE_TABLE_LENGTH; i++) {
+		uint32_t luminance = entry_luminance(hue, i);
+		uint32_t gain = (luminance <= target) ? COLOUR_ONE :
+				((uint64_t) target << COLOUR_SHIFT) / luminance;
+		gains[i] = (gain > UINT16_MAX) ? UINT16_MAX : gain;
+	}
 }
 
-void single_pulse(void) {
-	uint16_t off_pulse[3] = { COUNTER_PERIOD, COUNTER_PERIOD, COUNTER_PERIOD };
-	uint16_t on_pulse[3] = { 0, 0, 0 };
-	HAL_NVIC_DisableIRQ(TIM2_IRQn);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	set_pulse_values(on_pulse);
-	HAL_Delay(150);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	HAL_NVIC_EnableIRQ(TIM2_IRQn);
+/* Interpolates a gain table at the pot 2 position. */
+static uint32_t colour_gain(const uint16_t *gains) {
+	uint32_t index = pot2_moving_average >> WHITE_TABLE_STEP_BITS;
+	int32_t fraction = pot2_moving_average & ((1 << WHITE_TABLE_STEP_BITS) - 1);
+	return table_to_colour(gains[index]
+			+ ((((int32_t) gains[index + 1] - gains[index]) * fraction)
+					>> WHITE_TABLE_STEP_BITS));
 }
+#endif /* CONSTANT_LUMINANCE */
 
-void double_pulse(void) {
-	uint16_t off_pulse[3] = { COUNTER_PERIOD, COUNTER_PERIOD, COUNTER_PERIOD };
-	uint16_t on_pulse[3] = { 0, 0, 0 };
-	HAL_NVIC_DisableIRQ(TIM2_IRQn);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	set_pulse_values(on_pulse);
-	HAL_Delay(150);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	set_pulse_values(on_pulse);
-	HAL_Delay(150);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	HAL_NVIC_EnableIRQ(TIM2_IRQn);
+/**
+ * @brief Fills the constant luminance gain tables.
+ *
+ * Uses the luminance weights and gains from the sensor
+ * calibration, so call it after generate_white_table() and again after a
+ * calibration. Does nothing unless CONSTANT_LUMINANCE is defined.
+ *
+ * @return None.
+ */
+void generate_gain_tables(void) {
+#ifdef CONSTANT_LUMINANCE
+	generate_gains(0, white_gains);
+	generate_gains(1, hue_gains);
+#endif /* CONSTANT_LUMINANCE */
 }
 
-void long_pulse(void) {
-	uint16_t off_pulse[3] = { COUNTER_PERIOD, COUNTER_PERIOD, COUNTER_PERIOD };
-	uint16_t on_pulse[3] = { 0, 0, 0 };
-	HAL_NVIC_DisableIRQ(TIM2_IRQn);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	set_pulse_values(on_pulse);
-	HAL_Delay(1000);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	HAL_NVIC_EnableIRQ(TIM2_IRQn);
+/* Each pot drives its colour's BLANK duty directly while calibrating. */
+static void calibration_colour(uint32_t *colour) {
+	uint32_t pot1_colour = COLOUR_ONE - pot_to_colour(pot1_moving_average);
+	uint32_t pot2_colour = COLOUR_ONE - pot_to_colour(pot2_moving_average);
+	uint32_t pot3_colour = COLOUR_ONE - pot_to_colour(pot3_moving_average);
+
+	if (current_state == LED_CALIBRATION) {
+		colour[0] = pot1_colour;
+		colour[1] = pot2_colour;
+		colour[2] = pot3_colour;
+	} else if ((pot_cal_substate == POT_1_LOWER)
+			|| (pot_cal_substate == POT_1_UPPER)) {
+		colour[0] = pot1_colour;
+		colour[1] = 0;
+		colour[2] = 0;
+	} else if ((pot_cal_substate == POT_2_LOWER)
+			|| (pot_cal_substate == POT_2_UPPER)) {
+		colour[0] = 0;
+		colour[1] = pot2_colour;
+		colour[2] = 0;
+	} else if ((pot_cal_substate == POT_3_LOWER)
+			|| (pot_cal_substate == POT_3_UPPER)) {
+		colour[0] = 0;
+		colour[1] = 0;
+		colour[2] = pot3_colour;
+	} else {
+		colour[0] = pot1_colour;
+		colour[1] = pot1_colour;
+		colour[2] = pot1_colour;
+	}
 }
 
-void red_single_pulse(void) {
-	uint16_t off_pulse[3] = { COUNTER_PERIOD, COUNTER_PERIOD, COUNTER_PERIOD };
-	uint16_t on_pulse[3] = { 0, COUNTER_PERIOD, COUNTER_PERIOD };
-	HAL_NVIC_DisableIRQ(TIM2_IRQn);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	set_pulse_values(on_pulse);
-	HAL_Delay(150);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	HAL_NVIC_EnableIRQ(TIM2_IRQn);
+void calculate_pulse_values(uint32_t *pulse_values) {
+	/* Hold BLANK high so the fade into STANDBY ends fully off. */
+	if (current_state == STANDBY) {
+		pulse_values[0] = PULSE_TO_Q8(PWM_PULSE_OFF);
+		pulse_values[1] = PULSE_TO_Q8(PWM_PULSE_OFF);
+		pulse_values[2] = PULSE_TO_Q8(PWM_PULSE_OFF);
+		return;
+	}
+
+	/* Find the target colour and the brightness it is shown at. */
+	uint32_t colour[3];
+	uint32_t gain = COLOUR_ONE;
+	if (current_state == WHITE_LIGHT) {
+		white_colour(colour);
+		apply_luminance_balance(colour);
+		gain = brightness_gain(pot1_moving_average);
+#ifdef CONSTANT_LUMINANCE
+		gain = ((uint64_t) gain * colour_gain(white_gains)) >> COLOUR_SHIFT;
+#endif /* CONSTANT_LUMINANCE */
+	} else if (current_state == RGB_LIGHT) {
+		hue_colour((ADC_RES - 1) - pot2_moving_average, HUE_SATURATION, colour);
+		apply_luminance_balance(colour);
+		gain = brightness_gain(pot1_moving_average);
+#ifdef CONSTANT_LUMINANCE
+		gain = ((uint64_t) gain * colour_gain(hue_gains)) >> COLOUR_SHIFT;
+#endif /* CONSTANT_LUMINANCE */
+	} else {
+		calibration_colour(colour);
+	}
+
+	/*
+	 * Scale for brightness, then invert the on-time as BLANK is active low.
+	 * Both factors reach COLOUR_ONE while calibrating, so multiply in 64 bits.
+	 */
+	uint32_t period = COUNTER_PERIOD;
+	for (int channel = 0; channel < 3; channel++) {
+		uint32_t on_time = ((uint64_t) colour[channel] * gain)
+				>> BRIGHTNESS_TABLE_SHIFT;
+		pulse_values[channel] = PULSE_TO_Q8(period)
+				- ((on_time * period) >> (COLOUR_SHIFT - PWM_FRACTION_BITS));
+	}
 }
 
-void red_double_pulse(void) {
-	uint16_t off_pulse[3] = { COUNTER_PERIOD, COUNTER_PERIOD, COUNTER_PERIOD };
-	uint16_t on_pulse[3] = { 0, COUNTER_PERIOD, COUNTER_PERIOD };
-	HAL_NVIC_DisableIRQ(TIM2_IRQn);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	set_pulse_values(on_pulse);
-	HAL_Delay(150);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	set_pulse_values(on_pulse);
-	HAL_Delay(150);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	HAL_NVIC_EnableIRQ(TIM2_IRQn);
+uint32_t clamp(uint32_t value, uint32_t min, uint32_t max) {
+	if (value < min) {
+		return min;
+	} else if (value > max) {
+		return max;
+	}
+	return value;
 }
 
-void red_long_pulse(void) {
-	uint16_t off_pulse[3] = { COUNTER_PERIOD, COUNTER_PERIOD, COUNTER_PERIOD };
-	uint16_t on_pulse[3] = { 0, COUNTER_PERIOD, COUNTER_PERIOD };
-	HAL_NVIC_DisableIRQ(TIM2_IRQn);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	set_pulse_values(on_pulse);
-	HAL_Delay(1000);
-	set_pulse_values(off_pulse);
-	HAL_Delay(150);
-	HAL_NVIC_EnableIRQ(TIM2_IRQn);
+void set_pulse_values(uint32_t *pulse_values) {
+	/* Limit to the period, but let a held-off pulse through. */
+	uint32_t limited[3];
+	for (int channel = 0; channel < 3; channel++) {
+		limited[channel] =
+				(pulse_values[channel] >= PULSE_TO_Q8(PWM_PULSE_OFF)) ?
+						pulse_values[channel] :
+						clamp(pulse_values[channel], 0,
+								PULSE_TO_Q8(COUNTER_PERIOD));
+	}
+
+	commit_pulse_values_q8(limited);
 }
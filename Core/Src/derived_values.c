@@ -0,0 +1,148 @@
+/**
+ *******************************************************************************
+ * @file derived_values.c
+ * @brief Recomputes values derived from the pots only when their inputs move.
+ *
+ * Each new moving average used to recompute the pulse values and the
+ * hysteresis thresholds, even when the pots had not moved. Here each derived
+ * value remembers the inputs it was last computed from and is only
+ * recomputed when one of them changes:
+ *
+ *     pulse values           pot 1, pot 2 (and pot 3 while calibrating),
+ *                            the state and substate and the PWM profile
+ *     hysteresis thresholds  pot 3
+ *
+ * A pot only counts as moved once it is more than its deadband away from
+ * the value last used, so ADC noise does not trigger recomputation. Reaching
+ * either end of the pot range always counts, so the ends stay reachable.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <stdint.h>
+#include "globals.h"
+#include "colour_control.h"
+#include "hysteresis.h"
+#include "LED_framebuffer.h"
+#include "LED_pwm.h"
+#include "derived_values.h"
+
+/**
+ * @brief The inputs the pulse values were last computed from.
+ */
+typedef struct {
+	uint16_t pot1;						///< Pot 1 moving average used.
+	uint16_t pot2;						///< Pot 2 moving average used.
+	uint16_t pot3;						///< Pot 3 moving average used.
+	State state;						///< current_state used.
+	PotCalibrationSubstate pot_substate;	///< pot_cal_substate used.
+	const PwmProfile *profile;			///< active_pwm_profile used.
+} ColourInputs;
+
+static ColourInputs colour_inputs;
+static uint16_t threshold_pot3;				///< Pot 3 the thresholds used.
+static uint8_t colour_stale = 1;			///< Recompute regardless of inputs.
+static uint8_t threshold_stale = 1;			///< Recompute regardless of inputs.
+static DerivedValueCounts counts = { 0 };
+
+/**
+ * @brief Checks whether a pot has moved past its deadband.
+ *
+ * @param value: The current moving average.
+ * @param used: The value last used.
+ * @param deadband: Counts either side of used to ignore.
+ *
+ * @return 1 if the pot has moved, 0 otherwise.
+ */
+static uint8_t pot_moved(uint16_t value, uint16_t used, uint16_t deadband) {
+	if (value == used) {
+		return 0;
+	}
+	if ((value == 0) || (value == ADC_RES - 1)) {
+		return 1;
+	}
+	uint16_t distance = (value > used) ? (value - used) : (used - value);
+	return distance > deadband;
+}
+
+/**
+ * @brief Checks whether any input of the pulse values has changed.
+ *
+ * @param inputs: The current inputs.
+ *
+ * @return 1 if the pulse values need recomputing, 0 otherwise.
+ */
+static uint8_t colour_inputs_changed(const ColourInputs *inputs) {
+	/* Pot 3 only sets a colour while calibrating. */
+	uint8_t uses_pot3 = (inputs->state == POT_CALIBRATION)
+			|| (inputs->state == LED_CALIBRATION);
+
+	return colour_stale || (inputs->state != colour_inputs.state)
+			|| (inputs->pot_substate != colour_inputs.pot_substate)
+			|| (inputs->profile != colour_inputs.profile)
+			|| pot_moved(inputs->pot1, colour_inputs.pot1, POT1_DEADBAND)
+			|| pot_moved(inputs->pot2, colour_inputs.pot2, POT2_DEADBAND)
+			|| (uses_pot3
+					&& pot_moved(inputs->pot3, colour_inputs.pot3, POT3_DEADBAND));
+}
+
+/**
+ * @brief Recomputes whichever derived values have changed inputs.
+ *
+ * Call when a new moving average is ready.
+ *
+ * @param hysteresis_thresholds: The thresholds, updated if pot 3 moved.
+ *
+ * @return None.
+ */
+void update_derived_values(uint32_t *hysteresis_thresholds) {
+	ColourInputs inputs = { pot1_moving_average, pot2_moving_average,
+			pot3_moving_average, current_state, pot_cal_substate,
+			active_pwm_profile };
+
+	if (colour_inputs_changed(&inputs)) {
+		uint32_t pulse_values[3];
+		calculate_pulse_values(pulse_values);
+		framebuffer_set_pulses_q8(pulse_values);
+		colour_inputs = inputs;
+		colour_stale = 0;
+		counts.colour_executed++;
+	} else {
+		counts.colour_skipped++;
+	}
+
+	if (threshold_stale
+			|| pot_moved(inputs.pot3, threshold_pot3, POT3_DEADBAND)) {
+		update_hysteresis_thresholds(hysteresis_thresholds);
+		threshold_pot3 = inputs.pot3;
+		threshold_stale = 0;
+		counts.threshold_executed++;
+	} else {
+		counts.threshold_skipped++;
+	}
+}
+
+/**
+ * @brief Forces every derived value to be recomputed on the next update.
+ *
+ * For changes the inputs do not show, such as rebuilt colour tables.
+ *
+ * @return None.
+ */
+void invalidate_derived_values(void) {
+	colour_stale = 1;
+	threshold_stale = 1;
+}
+
+/**
+ * @brief Reads the recompute and skip counters.
+ *
+ * @param counts_out: Filled with the counters since start-up.
+ *
+ * @return None.
+ */
+void get_derived_value_counts(DerivedValueCounts *counts_out) {
+	*counts_out = counts;
+}
@@ -15,6 +15,7 @@
 #include "hardware_defines.h"
 #include "state_machine.h"
 #include "external_interrupts.h"
+#include "LED_fault_scanner.h"
 #include "debug_flags.h"
 
 #define DEBOUNCE_TIME 50 ///< Button debounce duration in ms.
@@ -58,7 +59,7 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
 
 	case XERR_G_Pin:
 	case XERR_B_Pin:
-		determine_led_errors();
+		request_led_fault_scan();
 		break;
 
 	case INT_Pin:
@@ -193,68 +194,6 @@ void initialise_button_states(void) {
 #endif /* DEBUG_INIT */
 }
 
-/**
- * @brief Reads the error flags of all three LED drivers.
- *
- * The LED drivers are configured to read TEF (Thermal Error Flag). Then they
- * are configured to read LOD and the LOD status data is clocked out of the
- * driver registers. The function sets global error flags for the main loop.
- *
- * @return None.
- */
-void determine_led_errors(void) {
-	/* Configure LED drivers for reading error information. */
-	HAL_GPIO_WritePin(MODE_GPIO_Port, MODE_Pin, RESET);
-	HAL_GPIO_WritePin(XLAT_GPIO_Port, XLAT_Pin, RESET);
-	HAL_GPIO_WritePin(SCLK_GPIO_Port, SCLK_Pin, RESET);
-
-	/* Mask out LOD flags by setting BLANK pins to HIGH. */
-	uint16_t off_pulse[3] = { COUNTER_PERIOD, COUNTER_PERIOD, COUNTER_PERIOD };
-	set_pulse_values(off_pulse);
-
-	/* Read TEF flags - inverting the values as XERR is active low. */
-	red_thermal_error_flag = !HAL_GPIO_ReadPin(XERR_R_GPIO_Port, XERR_R_Pin);
-	green_thermal_error_flag = !HAL_GPIO_ReadPin(XERR_G_GPIO_Port, XERR_G_Pin);
-	blue_thermal_error_flag = !HAL_GPIO_ReadPin(XERR_B_GPIO_Port, XERR_B_Pin);
-
-	/* Unmask the LOD flags by setting BLANK pins to LOW. */
-	uint16_t on_pulse[3] = { 0, 0, 0 };
-	set_pulse_values(on_pulse);
-
-	/* Latch the LOD data into the internal registers. */
-	HAL_GPIO_WritePin(XLAT_GPIO_Port, XLAT_Pin, SET);
-	HAL_GPIO_WritePin(XLAT_GPIO_Port, XLAT_Pin, RESET);
-
-	int i;
-	for (i = 0; i < 16; i++) {
-		/* Clock the LOD data out of the drivers. */
-		red_lod_flag |= (HAL_GPIO_ReadPin(SOUT_R_GPIO_Port, SOUT_R_Pin) << i);
-		green_lod_flag |= (HAL_GPIO_ReadPin(SOUT_G_GPIO_Port, SOUT_G_Pin) << i);
-		blue_lod_flag |= (HAL_GPIO_ReadPin(SOUT_B_GPIO_Port, SOUT_B_Pin) << i);
-		HAL_GPIO_WritePin(SCLK_GPIO_Port, SCLK_Pin, SET);
-		HAL_GPIO_WritePin(SCLK_GPIO_Port, SCLK_Pin, RESET);
-	}
-
-	/* Latch the configuration registers. */
-	HAL_GPIO_WritePin(XLAT_GPIO_Port, XLAT_Pin, SET);
-	HAL_GPIO_WritePin(XLAT_GPIO_Port, XLAT_Pin, RESET);
-
-#ifdef DEBUG_LED_DRIVERS
-	/* Communicate error flags over SWO. */
-	printf("\nThermal Error Flags\n");
-	printf("R: %u\n", red_thermal_error_flag);
-	printf("G: %u\n", green_thermal_error_flag);
-	printf("B: %u\n", blue_thermal_error_flag);
-	printf("\nLOD Status Data\n");
-	printf("R: ");
-	print_binary(red_lod_flag);
-	printf("G: ");
-	print_binary(green_lod_flag);
-	printf("B: ");
-	print_binary(blue_lod_flag);
-#endif /* DEBUG_LED_DRIVERS */
-}
-
 /**
  * @brief Reads the light sensor's data over I2C, saving result in mlux_reading.
  *
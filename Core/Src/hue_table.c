@@ -0,0 +1,105 @@
+/**
+ *******************************************************************************
+ * @file hue_table.c
+ * @brief OkLCh hue wheel lookup table (generated, do not edit).
+ *
+ * Generated by Tools/generate_hue_table.py. Entries are the most
+ * saturated linear RGB colours (Q16) at evenly spaced OkLCh hues,
+ * from red through yellow, green, cyan, blue and magenta to red.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <stdint.h>
+#include "hue_table.h"
+
+const uint16_t hue_table[HUE_TABLE_LENGTH][3] = {
+		{ 65535,     0,     0 }, { 65535,   913,     0 }, { 65535,  1810,     0 },
+		{ 65535,  2695,     0 }, { 65535,  3566,     0 }, { 65535,  4427,     0 },
+		{ 65535,  5277,     0 }, { 65535,  6117,     0 }, { 65535,  6950,     0 },
+		{ 65535,  7775,     0 }, { 65535,  8595,     0 }, { 65535,  9409,     0 },
+		{ 65535, 10218,     0 }, { 65535, 11025,     0 }, { 65535, 11829,     0 },
+		{ 65535, 12631,     0 }, { 65535, 13433,     0 }, { 65535, 14235,     0 },
+		{ 65535, 15039,     0 }, { 65535, 15844,     0 }, { 65535, 16653,     0 },
+		{ 65535, 17466,     0 }, { 65535, 18284,     0 }, { 65535, 19108,     0 },
+		{ 65535, 19939,     0 }, { 65535, 20779,     0 }, { 65535, 21628,     0 },
+		{ 65535, 22487,     0 }, { 65535, 23358,     0 }, { 65535, 24242,     0 },
+		{ 65535, 25140,     0 }, { 65535, 26054,     0 }, { 65535, 26986,     0 },
+		{ 65535, 27937,     0 }, { 65535, 28908,     0 }, { 65535, 29902,     0 },
+		{ 65535, 30920,     0 }, { 65535, 31965,     0 }, { 65535, 33039,     0 },
+		{ 65535, 34145,     0 }, { 65535, 35285,     0 }, { 65535, 36463,     0 },
+		{ 65535, 37682,     0 }, { 65535, 38945,     0 }, { 65535, 40257,     0 },
+		{ 65535, 41621,     0 }, { 65535, 43044,     0 }, { 65535, 44531,     0 },
+		{ 65535, 46087,     0 }, { 65535, 47720,     0 }, { 65535, 49439,     0 },
+		{ 65535, 51251,     0 }, { 65535, 53167,     0 }, { 65535, 55198,     0 },
+		{ 65535, 57359,     0 }, { 65535, 59665,     0 }, { 65535, 62133,     0 },
+		{ 65535, 64785,     0 }, { 63490, 65535,     0 }, { 60709, 65535,     0 },
+		{ 57947, 65535,     0 }, { 55200, 65535,     0 }, { 52467, 65535,     0 },
+		{ 49742, 65535,     0 }, { 47023, 65535,     0 }, { 44307, 65535,     0 },
+		{ 41590, 65535,     0 }, { 38870, 65535,     0 }, { 36143, 65535,     0 },
+		{ 33407, 65535,     0 }, { 30657, 65535,     0 }, { 27891, 65535,     0 },
+		{ 25105, 65535,     0 }, { 22297, 65535,     0 }, { 19462, 65535,     0 },
+		{ 16597, 65535,     0 }, { 13698, 65535,     0 }, { 10761, 65535,     0 },
+		{  7783, 65535,     0 }, {  4760, 65535,     0 }, {  1687, 65535,     0 },
+		{     0, 65535,  1152 }, {     0, 65535,  3602 }, {     0, 65535,  5970 },
+		{     0, 65535,  8262 }, {     0, 65535, 10482 }, {     0, 65535, 12634 },
+		{     0, 65535, 14724 }, {     0, 65535, 16756 }, {     0, 65535, 18735 },
+		{     0, 65535, 20664 }, {     0, 65535, 22547 }, {     0, 65535, 24389 },
+		{     0, 65535, 26191 }, {     0, 65535, 27958 }, {     0, 65535, 29692 },
+		{     0, 65535, 31397 }, {     0, 65535, 33075 }, {     0, 65535, 34729 },
+		{     0, 65535, 36360 }, {     0, 65535, 37973 }, {     0, 65535, 39567 },
+		{     0, 65535, 41147 }, {     0, 65535, 42714 }, {     0, 65535, 44270 },
+		{     0, 65535, 45818 }, {     0, 65535, 47358 }, {     0, 65535, 48893 },
+		{     0, 65535, 50425 }, {     0, 65535, 51956 }, {     0, 65535, 53488 },
+		{     0, 65535, 55022 }, {     0, 65535, 56560 }, {     0, 65535, 58105 },
+		{     0, 65535, 59659 }, {     0, 65535, 61222 }, {     0, 65535, 62799 },
+		{     0, 65535, 64389 }, {     0, 65076, 65535 }, {     0, 63511, 65535 },
+		{     0, 62000, 65535 }, {     0, 60539, 65535 }, {     0, 59123, 65535 },
+		{     0, 57749, 65535 }, {     0, 56413, 65535 }, {     0, 55112, 65535 },
+		{     0, 53844, 65535 }, {     0, 52605, 65535 }, {     0, 51393, 65535 },
+		{     0, 50205, 65535 }, {     0, 49040, 65535 }, {     0, 47895, 65535 },
+		{     0, 46769, 65535 }, {     0, 45659, 65535 }, {     0, 44563, 65535 },
+		{     0, 43481, 65535 }, {     0, 42410, 65535 }, {     0, 41349, 65535 },
+		{     0, 40296, 65535 }, {     0, 39250, 65535 }, {     0, 38210, 65535 },
+		{     0, 37174, 65535 }, {     0, 36140, 65535 }, {     0, 35107, 65535 },
+		{     0, 34074, 65535 }, {     0, 33039, 65535 }, {     0, 32001, 65535 },
+		{     0, 30958, 65535 }, {     0, 29908, 65535 }, {     0, 28850, 65535 },
+		{     0, 27783, 65535 }, {     0, 26703, 65535 }, {     0, 25609, 65535 },
+		{     0, 24499, 65535 }, {     0, 23370, 65535 }, {     0, 22220, 65535 },
+		{     0, 21044, 65535 }, {     0, 19838, 65535 }, {     0, 18599, 65535 },
+		{     0, 17321, 65535 }, {     0, 15995, 65535 }, {     0, 14612, 65535 },
+		{     0, 13159, 65535 }, {     0, 11615, 65535 }, {     0,  9946, 65535 },
+		{     0,  8091, 65535 }, {     0,  5891, 65535 }, {     0,  2403, 65535 },
+		{   438,     0, 65535 }, {   885,     0, 65535 }, {  1348,     0, 65535 },
+		{  1828,     0, 65535 }, {  2328,     0, 65535 }, {  2846,     0, 65535 },
+		{  3386,     0, 65535 }, {  3947,     0, 65535 }, {  4530,     0, 65535 },
+		{  5139,     0, 65535 }, {  5772,     0, 65535 }, {  6433,     0, 65535 },
+		{  7123,     0, 65535 }, {  7843,     0, 65535 }, {  8596,     0, 65535 },
+		{  9382,     0, 65535 }, { 10205,     0, 65535 }, { 11067,     0, 65535 },
+		{ 11969,     0, 65535 }, { 12915,     0, 65535 }, { 13907,     0, 65535 },
+		{ 14949,     0, 65535 }, { 16042,     0, 65535 }, { 17191,     0, 65535 },
+		{ 18399,     0, 65535 }, { 19670,     0, 65535 }, { 21007,     0, 65535 },
+		{ 22415,     0, 65535 }, { 23898,     0, 65535 }, { 25461,     0, 65535 },
+		{ 27110,     0, 65535 }, { 28848,     0, 65535 }, { 30683,     0, 65535 },
+		{ 32621,     0, 65535 }, { 34666,     0, 65535 }, { 36827,     0, 65535 },
+		{ 39111,     0, 65535 }, { 41525,     0, 65535 }, { 44077,     0, 65535 },
+		{ 46777,     0, 65535 }, { 49634,     0, 65535 }, { 52657,     0, 65535 },
+		{ 55858,     0, 65535 }, { 59247,     0, 65535 }, { 62839,     0, 65535 },
+		{ 65535,     0, 64443 }, { 65535,     0, 60763 }, { 65535,     0, 57293 },
+		{ 65535,     0, 54017 }, { 65535,     0, 50925 }, { 65535,     0, 48005 },
+		{ 65535,     0, 45245 }, { 65535,     0, 42635 }, { 65535,     0, 40167 },
+		{ 65535,     0, 37831 }, { 65535,     0, 35618 }, { 65535,     0, 33522 },
+		{ 65535,     0, 31535 }, { 65535,     0, 29650 }, { 65535,     0, 27860 },
+		{ 65535,     0, 26161 }, { 65535,     0, 24546 }, { 65535,     0, 23010 },
+		{ 65535,     0, 21549 }, { 65535,     0, 20158 }, { 65535,     0, 18832 },
+		{ 65535,     0, 17568 }, { 65535,     0, 16363 }, { 65535,     0, 15212 },
+		{ 65535,     0, 14112 }, { 65535,     0, 13062 }, { 65535,     0, 12056 },
+		{ 65535,     0, 11094 }, { 65535,     0, 10173 }, { 65535,     0,  9290 },
+		{ 65535,     0,  8444 }, { 65535,     0,  7631 }, { 65535,     0,  6851 },
+		{ 65535,     0,  6102 }, { 65535,     0,  5383 }, { 65535,     0,  4690 },
+		{ 65535,     0,  4025 }, { 65535,     0,  3384 }, { 65535,     0,  2766 },
+		{ 65535,     0,  2172 }, { 65535,     0,  1599 }, { 65535,     0,  1047 },
+		{ 65535,     0,   514 }, { 65535,     0,     0 }
+};
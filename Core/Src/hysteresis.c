@@ -8,7 +8,6 @@
  *******************************************************************************
  */
 
-#include <math.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <globals.h>
@@ -16,6 +15,73 @@
 
 #define MIN_LUX 1      		// Minimum perceived brightness (1 mlux)
 #define MAX_LUX 100000		// Maximum perceived brightness (100 lux)
+#define HYSTERESIS_PERCENT 20	// Upper threshold above the lower one.
+
+#define LOG_SHIFT 16		// Fractional bits of a log2 value.
+#define LOG_TABLE_BITS 5	// log2 of the table intervals.
+#define LOG_STEP_BITS (LOG_SHIFT - LOG_TABLE_BITS)
+#define THRESHOLD_SHIFT 8	// Fractional bits of a threshold in mlux.
+
+/* log2(1 + i / 32) in Q16, i = 0 to 32. */
+static const uint32_t log2_table[(1 << LOG_TABLE_BITS) + 1] = {
+		0, 2909, 5732, 8473, 11136, 13727, 16248, 18704,
+		21098, 23433, 25711, 27936, 30109, 32234, 34312, 36346,
+		38336, 40286, 42196, 44068, 45904, 47705, 49472, 51207,
+		52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047,
+		65536 };
+
+/* 2^(i / 32) in Q16, i = 0 to 32. */
+static const uint32_t exp2_table[(1 << LOG_TABLE_BITS) + 1] = {
+		65536, 66971, 68438, 69936, 71468, 73032, 74632, 76266,
+		77936, 79642, 81386, 83169, 84990, 86851, 88752, 90696,
+		92682, 94711, 96785, 98905, 101070, 103283, 105545, 107856,
+		110218, 112631, 115098, 117618, 120194, 122825, 125515, 128263,
+		131072 };
+
+/**
+ * @brief Finds log2 of an integer from its leading bit and a table of the
+ * mantissa.
+ *
+ * @param value: The value (non-zero).
+ *
+ * @return log2(value) in Q16.
+ */
+static uint32_t fixed_log2(uint32_t value) {
+	uint32_t whole = 31 - __CLZ(value);
+
+	/* Fraction of the way from 2^whole to 2^(whole + 1), Q16. */
+	uint32_t mantissa = (whole >= LOG_SHIFT) ?
+			(value >> (whole - LOG_SHIFT)) : (value << (LOG_SHIFT - whole));
+	mantissa -= 1 << LOG_SHIFT;
+
+	uint32_t index = mantissa >> LOG_STEP_BITS;
+	uint32_t fraction = mantissa & ((1 << LOG_STEP_BITS) - 1);
+	return (whole << LOG_SHIFT) + log2_table[index]
+			+ (((log2_table[index + 1] - log2_table[index]) * fraction)
+					>> LOG_STEP_BITS);
+}
+
+/**
+ * @brief Raises 2 to a fixed point power with a table of the mantissa.
+ *
+ * @param exponent: The power in Q16, below 24.
+ *
+ * @return 2^exponent in Q8 (THRESHOLD_SHIFT).
+ */
+static uint32_t fixed_exp2(uint32_t exponent) {
+	uint32_t whole = exponent >> LOG_SHIFT;
+	uint32_t index = (exponent >> LOG_STEP_BITS) & ((1 << LOG_TABLE_BITS) - 1);
+	uint32_t fraction = exponent & ((1 << LOG_STEP_BITS) - 1);
+	uint32_t mantissa = exp2_table[index]
+			+ (((exp2_table[index + 1] - exp2_table[index]) * fraction)
+					>> LOG_STEP_BITS);
+
+	/* mantissa is Q16, so shift by whole - (16 - THRESHOLD_SHIFT). */
+	if (whole >= LOG_SHIFT - THRESHOLD_SHIFT) {
+		return mantissa << (whole - (LOG_SHIFT - THRESHOLD_SHIFT));
+	}
+	return mantissa >> ((LOG_SHIFT - THRESHOLD_SHIFT) - whole);
+}
 
 void check_for_on_off(uint32_t *hysteresis_thresholds) {
 	if (mlux_reading < hysteresis_thresholds[0]) {
@@ -38,17 +104,28 @@ void check_for_on_off(uint32_t *hysteresis_thresholds) {
 }
 
 void update_hysteresis_thresholds(uint32_t *hysteresis_thresholds) {
-	/* Define scale factor for the logarithmic mapping. */
-	double scale_factor = (log(MAX_LUX) - log(MIN_LUX)) / log(ADC_RES - 1);
+	/* Pot 3 at 0 has no logarithm; it sets both thresholds to 0 mlux. */
+	if (pot3_moving_average == 0) {
+		hysteresis_thresholds[0] = 0;
+		hysteresis_thresholds[1] = 0;
+		return;
+	}
 
-	/* Apply logarithmic mapping. */
-	double threshold = exp(
-			log(MIN_LUX) + scale_factor * log(pot3_moving_average));
+	/* Scale factor for the logarithmic mapping (Q16), found once. */
+	static uint32_t scale_factor = 0;
+	if (scale_factor == 0) {
+		scale_factor = ((uint64_t) (fixed_log2(MAX_LUX) - fixed_log2(MIN_LUX))
+				<< LOG_SHIFT) / fixed_log2(ADC_RES - 1);
+	}
 
-	/* Determine hysteresis factor. */
-	double hysteresis_factor = 0.2;
+	/* Apply logarithmic mapping in the log2 domain. */
+	uint32_t exponent = fixed_log2(MIN_LUX)
+			+ (((uint64_t) scale_factor * fixed_log2(pot3_moving_average))
+					>> LOG_SHIFT);
+	uint32_t threshold = fixed_exp2(exponent);
 
 	/* Set the hysteresis thresholds. */
-	hysteresis_thresholds[0] = (uint32_t) threshold;
-	hysteresis_thresholds[1] = (uint32_t) (threshold * (1 + hysteresis_factor));
+	hysteresis_thresholds[0] = threshold >> THRESHOLD_SHIFT;
+	hysteresis_thresholds[1] = (threshold
+			+ threshold * HYSTERESIS_PERCENT / 100) >> THRESHOLD_SHIFT;
 }
@@ -12,7 +12,9 @@
 #include "globals.h"
 #include <stdint.h>
 #include <stdio.h>
+#ifdef KELVIN_DOUBLE_INTERPOLATION
 #include <math.h>
+#endif /* KELVIN_DOUBLE_INTERPOLATION */
 
 //KelvinToRGB kelvin_table[KELVIN_TABLE_LENGTH] = {
 //    {2000, 255, 147, 41},   // Warm White
@@ -74,57 +76,116 @@ KelvinToRGB kelvin_table[] = { { 1000, 255, 56, 0 }, { 1100, 255, 71, 0 }, {
 		{ 7800, 230, 235, 255 }, { 7900, 228, 234, 255 },
 		{ 8000, 227, 233, 255 }, };
 
-void search_rgb_to_kelvin(uint32_t kelvin, KelvinToRGB *lower,
-		KelvinToRGB *higher) {
-	int i;
-	for (i = 0; i < KELVIN_TABLE_LENGTH; i++) {
-		if (kelvin <= kelvin_table[i].kelvin) {
-			break;
+_Static_assert(sizeof(kelvin_table) / sizeof(kelvin_table[0])
+		== KELVIN_TABLE_LENGTH, "KELVIN_TABLE_LENGTH is out of date");
+
+/**
+ * @brief Finds the index of the entry at or below a kelvin value.
+ *
+ * Indexes directly when the table is evenly spaced, otherwise bisects.
+ *
+ * @param kelvin: The kelvin value, between the first and last entries.
+ *
+ * @return The index of the lower entry, at most KELVIN_TABLE_LENGTH - 2.
+ */
+static uint32_t find_lower_index(uint32_t kelvin) {
+#if KELVIN_TABLE_STEP
+	uint32_t index = (kelvin - kelvin_table[0].kelvin) / KELVIN_TABLE_STEP;
+#else
+	uint32_t index = 0;
+	uint32_t top = KELVIN_TABLE_LENGTH - 1;
+	while (top - index > 1) {
+		uint32_t middle = (index + top) / 2;
+		if (kelvin_table[middle].kelvin <= kelvin) {
+			index = middle;
+		} else {
+			top = middle;
 		}
 	}
+#endif
+	return (index < KELVIN_TABLE_LENGTH - 1) ? index : KELVIN_TABLE_LENGTH - 2;
+}
 
-	// Assign the lower and higher KelvinToRGB structs
-	if (kelvin == kelvin_table[i].kelvin || i == 0) {
-		// If exact match or less than first element, return same entry twice.
-		*lower = kelvin_table[i];
-		*higher = kelvin_table[i];
-	} else if (kelvin > kelvin_table[KELVIN_TABLE_LENGTH - 1].kelvin) {
-		// If more than last element, return last enry twice.
+/**
+ * @brief Finds the table entries either side of a kelvin value.
+ *
+ * Values outside the table return the end entry twice.
+ *
+ * @param kelvin: The kelvin value to look up.
+ * @param lower: Filled with the entry at or below kelvin.
+ * @param higher: Filled with the entry above kelvin.
+ *
+ * @return Position of kelvin between lower and higher, Q15 (0 at lower).
+ */
+uint16_t search_rgb_to_kelvin(uint32_t kelvin, KelvinToRGB *lower,
+		KelvinToRGB *higher) {
+	if (kelvin <= kelvin_table[0].kelvin) {
+		*lower = kelvin_table[0];
+		*higher = kelvin_table[0];
+		return 0;
+	}
+	if (kelvin >= kelvin_table[KELVIN_TABLE_LENGTH - 1].kelvin) {
 		*lower = kelvin_table[KELVIN_TABLE_LENGTH - 1];
 		*higher = kelvin_table[KELVIN_TABLE_LENGTH - 1];
-	} else {
-		// If between two values, return adjacent entries
-		*lower = kelvin_table[i - 1];
-		*higher = kelvin_table[i];
+		return 0;
+	}
+
+	uint32_t index = find_lower_index(kelvin);
+	*lower = kelvin_table[index];
+	*higher = kelvin_table[index + 1];
+
+	/* Return an exact match the same way as the ends. */
+	uint32_t offset = kelvin - lower->kelvin;
+	if (offset == 0) {
+		*higher = *lower;
+		return 0;
 	}
+	return (offset << KELVIN_WEIGHT_SHIFT) / (higher->kelvin - lower->kelvin);
 }
 
-void pulse_for_kelvin(uint32_t kelvin, KelvinToRGB *lower, KelvinToRGB *higher,
-		uint16_t *pulse_values) {
-	uint32_t rgb_values[3];
+#ifndef KELVIN_DOUBLE_INTERPOLATION
+/**
+ * @brief Interpolates one colour between two entries, rounding halves up as
+ * round() does for the (non-negative) result.
+ *
+ * @param low: The colour value of the lower entry.
+ * @param high: The colour value of the higher entry.
+ * @param weight: Position above the lower entry, Q15.
+ *
+ * @return The interpolated colour value.
+ */
+static uint32_t interpolate_colour(int32_t low, int32_t high, uint16_t weight) {
+	int32_t scaled = (low << KELVIN_WEIGHT_SHIFT) + (int32_t) weight
+			* (high - low) + (1 << (KELVIN_WEIGHT_SHIFT - 1));
+	return scaled >> KELVIN_WEIGHT_SHIFT;
+}
+#endif /* KELVIN_DOUBLE_INTERPOLATION */
 
-	/* Interpolate RGB values. */
-	if (kelvin != lower->kelvin) {
-		rgb_values[0] = round(
-				lower->r
-						+ (double) (kelvin - lower->kelvin)
-								/ (higher->kelvin - lower->kelvin)
-								* (higher->r - lower->r));
-		rgb_values[1] = round(
-				lower->g
-						+ (double) (kelvin - lower->kelvin)
-								/ (higher->kelvin - lower->kelvin)
-								* (higher->g - lower->g));
-		rgb_values[2] = round(
-				lower->b
-						+ (double) (kelvin - lower->kelvin)
-								/ (higher->kelvin - lower->kelvin)
-								* (higher->b - lower->b));
+void rgb_for_kelvin(uint16_t weight, KelvinToRGB *lower, KelvinToRGB *higher,
+		uint32_t *rgb_values) {
+	/* Interpolate RGB values (the ends and exact matches have no weight). */
+	if (weight != 0) {
+#ifdef KELVIN_DOUBLE_INTERPOLATION
+		double fraction = (double) weight / (1 << KELVIN_WEIGHT_SHIFT);
+		rgb_values[0] = round(lower->r + fraction * (higher->r - lower->r));
+		rgb_values[1] = round(lower->g + fraction * (higher->g - lower->g));
+		rgb_values[2] = round(lower->b + fraction * (higher->b - lower->b));
+#else
+		rgb_values[0] = interpolate_colour(lower->r, higher->r, weight);
+		rgb_values[1] = interpolate_colour(lower->g, higher->g, weight);
+		rgb_values[2] = interpolate_colour(lower->b, higher->b, weight);
+#endif /* KELVIN_DOUBLE_INTERPOLATION */
 	} else {
 		rgb_values[0] = lower->r;
 		rgb_values[1] = lower->g;
 		rgb_values[2] = lower->b;
 	}
+}
+
+void pulse_for_kelvin(uint16_t weight, KelvinToRGB *lower, KelvinToRGB *higher,
+		uint16_t *pulse_values) {
+	uint32_t rgb_values[3];
+	rgb_for_kelvin(weight, lower, higher, rgb_values);
 
 	/* Convert RGB values to pulse values. */
 	pulse_values[0] = COUNTER_PERIOD - rgb_values[0] * COUNTER_PERIOD / 256;
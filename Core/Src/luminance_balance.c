@@ -0,0 +1,244 @@
+/**
+ *******************************************************************************
+ * @file luminance_balance.c
+ * @brief Luminance balance of the LED colours, fitted from the light sensor
+ * calibration.
+ *
+ * The sensor calibration shows a sweep of known colours and records the lux
+ * mean and variance of each in brightness_calibration_buffer,
+ * white_calibration_buffer and colour_calibration_buffer. The lux above the
+ * baseline is linear in the on-time of each colour, so a weighted least
+ * squares fit over every sweep gives the lux each colour makes fully on.
+ *
+ * Those are the luminance weights. The sensor only measures lux, so this is
+ * a luminance-only balance, not a colour correction: it cannot tell where
+ * the LED colours sit and cannot fix their hue. It gives each colour a gain
+ * so the three share the luminance of a requested linear sRGB colour the way
+ * the Rec. 709 primaries do, scaled so white drives its strongest colour
+ * fully on. The live pipeline applies it with one multiply per colour.
+ *
+ * The fit runs in single precision (in hardware on the M4F) once per
+ * calibration. Tools/fit_luminance_balance.py does the same fit on the host
+ * from a DEBUG_CALIBRATIONS dump.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include "globals.h"
+#include "colour_control.h"
+#include "luminance_balance.h"
+#include "kelvin_to_rgb.h"
+#include "debug_flags.h"
+
+#define MIN_DETERMINANT 1e-9f	///< Smaller determinants are singular.
+
+/* Luminance share of each linear sRGB primary, the space requests are in. */
+static const float rec709_luminance[3] = { 0.2126f, 0.7152f, 0.0722f };
+
+uint16_t luminance_gains[3] = { LUMINANCE_GAIN_ONE, LUMINANCE_GAIN_ONE,
+		LUMINANCE_GAIN_ONE };
+uint16_t luminance_weights[3] = { LUMINANCE_WEIGHT_RED, LUMINANCE_WEIGHT_GREEN,
+		LUMINANCE_WEIGHT_BLUE };
+uint8_t luminance_balance_fitted = 0;	///< 1 once a fit has succeeded.
+
+/**
+ * @brief The on-time (0 to 1) of each colour at one brightness sweep step.
+ *
+ * Must match brightness_calibration() in state_machine.c.
+ *
+ * @param increment: The sweep step, 0 to NUM_CAL_INCS.
+ * @param drive: Array to fill with the on-times (R, G, B).
+ *
+ * @return None.
+ */
+static void brightness_drive(int increment, float *drive) {
+	drive[0] = (float) increment / NUM_CAL_INCS;
+	drive[1] = drive[0];
+	drive[2] = drive[0];
+}
+
+/**
+ * @brief The on-time (0 to 1) of each colour at one white sweep step.
+ *
+ * Must match white_calibration() in state_machine.c.
+ *
+ * @param increment: The sweep step, 0 to NUM_CAL_INCS.
+ * @param drive: Array to fill with the on-times (R, G, B).
+ *
+ * @return None.
+ */
+static void white_drive(int increment, float *drive) {
+	uint16_t kelvin_increment = (kelvin_table[KELVIN_TABLE_LENGTH - 1].kelvin
+			- kelvin_table[0].kelvin) / NUM_CAL_INCS;
+	uint32_t kelvin = kelvin_table[0].kelvin + increment * kelvin_increment;
+
+	KelvinToRGB lower;
+	KelvinToRGB higher;
+	uint32_t rgb_values[3];
+	uint16_t weight = search_rgb_to_kelvin(kelvin, &lower, &higher);
+	rgb_for_kelvin(weight, &lower, &higher, rgb_values);
+	for (int channel = 0; channel < 3; channel++) {
+		drive[channel] = rgb_values[channel] / 256.0f;
+	}
+}
+
+/**
+ * @brief The on-time (0 to 1) of each colour at one colour sweep step.
+ *
+ * Must match colour_calibration() in state_machine.c: even steps around
+ * the hue wheel.
+ *
+ * @param increment: The sweep step, 0 to NUM_CAL_INCS - 1.
+ * @param drive: Array to fill with the on-times (R, G, B).
+ *
+ * @return None.
+ */
+static void colour_drive(int increment, float *drive) {
+	uint32_t colour[3];
+	hue_colour(increment * ADC_RES / NUM_CAL_INCS, COLOUR_ONE, colour);
+	for (int channel = 0; channel < 3; channel++) {
+		drive[channel] = (float) colour[channel] / COLOUR_ONE;
+	}
+}
+
+/**
+ * @brief Adds one sweep to the least squares normal equations.
+ *
+ * Each step is weighted by the inverse of its lux variance so noisy
+ * readings count for less.
+ *
+ * @param buffer: The sweep's calibration buffer (baseline, steps, baseline).
+ * @param steps: Number of steps between the baselines.
+ * @param drive: Gives the on-times for a step.
+ * @param normal: The normal matrix (sum of w * d * d^T) to add to.
+ * @param right: The right hand side (sum of w * d * lux) to add to.
+ *
+ * @return None.
+ */
+static void accumulate_sweep(uint32_t buffer[][2], int steps,
+		void (*drive)(int, float*), float normal[3][3], float *right) {
+	float baseline = ((float) buffer[0][0] + (float) buffer[steps + 1][0])
+			/ 2.0f;
+
+	for (int step = 0; step < steps; step++) {
+		float on_times[3];
+		drive(step, on_times);
+		float lux = (float) buffer[step + 1][0] - baseline;
+		float weight = 1.0f / ((float) buffer[step + 1][1] + 1.0f);
+
+		for (int row = 0; row < 3; row++) {
+			for (int column = 0; column < 3; column++) {
+				normal[row][column] += weight * on_times[row] * on_times[column];
+			}
+			right[row] += weight * on_times[row] * lux;
+		}
+	}
+}
+
+static float determinant(float m[3][3]) {
+	return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+			- m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+			+ m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+/**
+ * @brief Solves m * result = v for a 3x3 matrix (Cramer's rule).
+ *
+ * @param m: The matrix.
+ * @param v: The right hand side.
+ * @param result: Array to fill with the solution.
+ *
+ * @return 1 if solved, 0 if the matrix is singular.
+ */
+static uint8_t solve(float m[3][3], const float *v, float *result) {
+	float whole = determinant(m);
+	if ((whole < MIN_DETERMINANT) && (whole > -MIN_DETERMINANT)) {
+		return 0;
+	}
+	for (int column = 0; column < 3; column++) {
+		float replaced[3][3];
+		for (int row = 0; row < 3; row++) {
+			for (int i = 0; i < 3; i++) {
+				replaced[row][i] = (i == column) ? v[row] : m[row][i];
+			}
+		}
+		result[column] = determinant(replaced) / whole;
+	}
+	return 1;
+}
+
+/**
+ * @brief Fits the luminance weights and gains to the sensor calibration
+ * buffers.
+ *
+ * Leaves the previous values in place if the fit fails.
+ *
+ * @return BALANCE_OK, or why the fit failed.
+ */
+BalanceStatus fit_luminance_balance(void) {
+	float normal[3][3] = { { 0 } };
+	float right[3] = { 0 };
+	accumulate_sweep(brightness_calibration_buffer, NUM_CAL_INCS + 1,
+			brightness_drive, normal, right);
+	accumulate_sweep(white_calibration_buffer, NUM_CAL_INCS + 1, white_drive,
+			normal, right);
+	accumulate_sweep(colour_calibration_buffer, NUM_CAL_INCS, colour_drive,
+			normal, right);
+
+	/* Lux of each colour fully on. */
+	float luminance[3];
+	if (!solve(normal, right, luminance)) {
+		return BALANCE_SINGULAR;
+	}
+	if ((luminance[0] <= 0.0f) || (luminance[1] <= 0.0f)
+			|| (luminance[2] <= 0.0f)) {
+		return BALANCE_NO_SIGNAL;
+	}
+	float total = luminance[0] + luminance[1] + luminance[2];
+
+	/* Gain that gives each colour its primary's share of the luminance. */
+	float gains[3];
+	float peak = 0.0f;
+	for (int channel = 0; channel < 3; channel++) {
+		gains[channel] = rec709_luminance[channel] * total / luminance[channel];
+		peak = (gains[channel] > peak) ? gains[channel] : peak;
+	}
+
+	/* Scale so white (1, 1, 1) keeps full drive on its strongest colour. */
+	for (int channel = 0; channel < 3; channel++) {
+		float gain = gains[channel] / peak * LUMINANCE_GAIN_ONE + 0.5f;
+		luminance_gains[channel] = (gain > LUMINANCE_GAIN_ONE) ?
+				LUMINANCE_GAIN_ONE : (uint16_t) gain;
+		float weight = luminance[channel] / total
+				* (1UL << LUMINANCE_WEIGHT_SHIFT) + 0.5f;
+		luminance_weights[channel] = (weight > UINT16_MAX) ?
+				UINT16_MAX : (uint16_t) weight;
+	}
+
+#ifdef DEBUG_CALIBRATIONS
+	printf("\nLuminance gains (Q%u): %u, %u, %u\n", LUMINANCE_GAIN_SHIFT,
+			luminance_gains[0], luminance_gains[1], luminance_gains[2]);
+	printf("Luminance weights (Q%u): %u, %u, %u\n", LUMINANCE_WEIGHT_SHIFT,
+			luminance_weights[0], luminance_weights[1], luminance_weights[2]);
+#endif /* DEBUG_CALIBRATIONS */
+	luminance_balance_fitted = 1;
+	return BALANCE_OK;
+}
+
+/**
+ * @brief Scales a requested colour by the luminance gains.
+ *
+ * @param colour: Q16 colour (R, G, B), replaced with the balanced colour.
+ *
+ * @return None.
+ */
+void apply_luminance_balance(uint32_t *colour) {
+	for (int channel = 0; channel < 3; channel++) {
+		colour[channel] = (colour[channel] * luminance_gains[channel])
+				>> LUMINANCE_GAIN_SHIFT;
+	}
+}
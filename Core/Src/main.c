@@ -24,8 +24,16 @@
 #include <stdint.h>
 #include "globals.h"
 #include "LED_driver_config.h"
+#include "LED_shift_engine.h"
+#include "LED_bcm.h"
+#include "LED_fault_scanner.h"
+#include "LED_framebuffer.h"
+#include "LED_animation.h"
+#include "LED_pwm.h"
 #include "state_machine.h"
 #include "colour_control.h"
+#include "hysteresis.h"
+#include "derived_values.h"
 #include "external_interrupts.h"
 #include "timers.h"
 #include <stdio.h>
@@ -97,6 +105,7 @@ uint8_t blue_thermal_error_flag = 0;
 uint16_t red_lod_flag = 0;
 uint16_t green_lod_flag = 0;
 uint16_t blue_lod_flag = 0;
+volatile LEDFaultFlag led_fault_flag = FAULTS_UNCHANGED;
 
 volatile uint32_t mlux_reading = 0xFFFFFFFF;
 
@@ -182,6 +191,12 @@ int main(void) {
 
 	initialise_button_states();
 
+	initialise_shift_engine();
+	initialise_bcm();
+	initialise_pwm_commit();
+	generate_white_table();
+	generate_gain_tables();
+
 	uint8_t led_init_config[16] = { SET };
 
 	if (initialise_LED_drivers(led_init_config) != LED_DRIVER_OK) {
@@ -205,9 +220,9 @@ int main(void) {
 	}
 
 #ifdef DEBUG_INIT
-	printf("\nCHECKING FOR LED DRIVER ERRORS\n");
+	printf("\nLED DRIVER FAULT SCAN REQUESTED\n");
 #endif /* DEBUG_INIT */
-	determine_led_errors();
+	request_led_fault_scan();
 
 	HAL_ADC_Start(&hadc1);
 	HAL_ADC_Start_DMA(&hadc2, (uint32_t*) adc2_dma_buffer, NUM_DMA_CHANNELS);
@@ -224,6 +239,27 @@ int main(void) {
 	printf("\nLED PWM STARTED\n");
 #endif /* DEBUG_INIT */
 
+	/*
+	 * A drifting TIM15 still lights green, but its BLANK edges are no longer
+	 * staggered from red and blue. Keep running, but show a red long and
+	 * single pulse first (aborted calibrations use a double). The LEDs are
+	 * lit for it, as the main loop would leave them off in STANDBY.
+	 */
+	PwmSyncReport sync_report;
+	PwmSyncStatus sync_status = check_pwm_sync(&sync_report);
+#ifdef DEBUG_INIT
+	printf("PWM SYNC CHECK %s: GREEN LAG %u, ERROR %d TO %d\n",
+			(sync_status == PWM_SYNC_OK) ? "SUCCESSFUL" : "FAILED",
+			sync_report.expected_lag, sync_report.min_error,
+			sync_report.max_error);
+#endif /* DEBUG_INIT */
+	if (sync_status != PWM_SYNC_OK) {
+		framebuffer_set_masks(LED_MASK_ALL, LED_MASK_ALL, LED_MASK_ALL);
+		play_animation(&red_long_pulse_animation);
+		play_animation(&red_single_pulse_animation);
+		wait_for_animation();
+	}
+
 #ifdef DEBUG_INIT
 	printf("\nINITIALISATION PROCESS COMPLETE\n");
 	printf("ENTERING MAIN WHILE LOOP...\n\n");
@@ -237,7 +273,6 @@ int main(void) {
 	/* Infinite loop */
 	/* USER CODE BEGIN WHILE */
 
-	uint16_t pulse_values[3];
 	uint32_t hysteresis_thresholds[2];
 
 	while (1) {
@@ -249,12 +284,8 @@ int main(void) {
 
 		if (potentiometer_flag == NEW_READING_READY) {
 //		  printf("%u    %u    %u\n", pot1_moving_average, pot2_moving_average, pot3_moving_average);
-			/* Set pulse value according to brightness potentiometer. */
-			calculate_pulse_values(pulse_values);
-			set_pulse_values(pulse_values);
-
-			/* Compute new hysteresis thresholds. */
-			update_hysteresis_thresholds(hysteresis_thresholds);
+			/* Recompute the pulse values and thresholds whose inputs moved. */
+			update_derived_values(hysteresis_thresholds);
 
 			/* Reset potentiometer flag. */
 			potentiometer_flag = WAITING_FOR_READING;
@@ -262,6 +293,23 @@ int main(void) {
 
 		check_for_on_off(hysteresis_thresholds);
 
+		/* Switch the LEDs off once a fade into STANDBY has finished. */
+		update_standby_masks();
+
+		/* Lay any notification animation over this tick's output. */
+		service_animation();
+
+		/* Push this tick's LED changes to the hardware in one step. */
+		flush_framebuffer();
+
+		/* Run the next slice of the LED driver fault scan. */
+		service_led_fault_scan();
+
+		if (led_fault_flag == FAULTS_CHANGED) {
+			report_led_faults();
+			led_fault_flag = FAULTS_UNCHANGED;
+		}
+
 //	  /* To test HAL_GetTick: */
 //	  uint32_t time = HAL_GetTick();
 //	  printf("%lu\n", time);
@@ -9,12 +9,19 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include "state_machine.h"
 #include "globals.h"
 #include "colour_control.h"
+#include "luminance_balance.h"
+#include "derived_values.h"
 #include "external_interrupts.h"
 #include "debug_flags.h"
 #include "LED_driver_config.h"
+#include "LED_fault_scanner.h"
+#include "LED_framebuffer.h"
+#include "LED_animation.h"
+#include "LED_bcm.h"
 #include "kelvin_to_rgb.h"
 #include "stdlib.h"
 
@@ -74,12 +81,9 @@ void update_state(EventType event) {
 void handle_standby(EventType event) {
 	switch (event) {
 	case AMBIENT_LIGHT_TURN_ON:
-		/* Turn the LEDs back on. */
-		uint8_t led_init_config[16];
-		for (int i = 0; i < 16; i++) {
-			led_init_config[i] = SET;
-		}
-		initialise_LED_drivers(led_init_config);
+		/* Turn the LEDs back on and fade up from dark. */
+		framebuffer_set_masks(LED_MASK_ALL, LED_MASK_ALL, LED_MASK_ALL);
+		start_pwm_fade(STANDBY_FADE_TIME, FADE_EASE_IN);
 		previous_state = STANDBY;
 		current_state = colour_mode;
 #ifdef DEBUG_STATE_MACHINE
@@ -114,7 +118,7 @@ void handle_standby(EventType event) {
 		break;
 
 	case POT_3_BUTTON_PRESS:
-		determine_led_errors();
+		request_led_fault_scan();
 		break;
 
 	default:
@@ -123,6 +127,17 @@ void handle_standby(EventType event) {
 	}
 }
 
+/**
+ * @brief Switches the LEDs off once the fade into STANDBY has finished.
+ *
+ * @return None.
+ */
+void update_standby_masks(void) {
+	if ((current_state == STANDBY) && !pwm_fade_running()) {
+		framebuffer_set_masks(LED_MASK_NONE, LED_MASK_NONE, LED_MASK_NONE);
+	}
+}
+
 /**
  * @brief Handles the event processing when the state is WHITE_LIGHT.
  *
@@ -134,6 +149,7 @@ void handle_white_light(EventType event) {
 	switch (event) {
 	case POT_2_BUTTON_PRESS:
 		/* Change Pot 2 to select from an RGB colour spectrum. */
+		start_pwm_fade(COLOUR_FADE_TIME, FADE_EASE_IN_OUT);
 		colour_mode = RGB_LIGHT;
 		current_state = colour_mode;
 #ifdef DEBUG_STATE_MACHINE
@@ -165,9 +181,8 @@ void handle_white_light(EventType event) {
 		break;
 
 	case AMBIENT_LIGHT_TURN_OFF:
-		/* Turn the LEDs completely off. */
-		uint8_t led_init_config[16] = { RESET };
-		initialise_LED_drivers(led_init_config);
+		/* Fade out, the LEDs are switched off once it ends. */
+		start_pwm_fade(STANDBY_FADE_TIME, FADE_EASE_OUT);
 		previous_state = WHITE_LIGHT;
 		current_state = STANDBY;
 #ifdef DEBUG_STATE_MACHINE
@@ -176,7 +191,7 @@ void handle_white_light(EventType event) {
 		break;
 
 	case POT_3_BUTTON_PRESS:
-		determine_led_errors();
+		request_led_fault_scan();
 		break;
 
 	default:
@@ -196,6 +211,7 @@ void handle_RGB_light(EventType event) {
 	switch (event) {
 	case POT_2_BUTTON_PRESS:
 		/* Change Pot 2 to select from a white colour spectrum. */
+		start_pwm_fade(COLOUR_FADE_TIME, FADE_EASE_IN_OUT);
 		colour_mode = WHITE_LIGHT;
 		current_state = colour_mode;
 #ifdef DEBUG_STATE_MACHINE
@@ -227,9 +243,8 @@ void handle_RGB_light(EventType event) {
 		break;
 
 	case AMBIENT_LIGHT_TURN_OFF:
-		/* Turn the LEDs completely off. */
-		uint8_t led_init_config[16] = { RESET };
-		initialise_LED_drivers(led_init_config);
+		/* Fade out, the LEDs are switched off once it ends. */
+		start_pwm_fade(STANDBY_FADE_TIME, FADE_EASE_OUT);
 		previous_state = RGB_LIGHT;
 		current_state = STANDBY;
 #ifdef DEBUG_STATE_MACHINE
@@ -238,7 +253,7 @@ void handle_RGB_light(EventType event) {
 		break;
 
 	case POT_3_BUTTON_PRESS:
-		determine_led_errors();
+		request_led_fault_scan();
 		break;
 
 	default:
@@ -266,7 +281,7 @@ void update_pot_cal_substate(EventType event) {
 		printf("Current substate: POT_CALIBRATION_START\n");
 #endif /* DEBUG_STATE_MACHINE */
 
-		double_pulse();
+		play_animation(&double_pulse_animation);
 		pot_cal_substate = POT_1_LOWER;
 #ifdef DEBUG_STATE_MACHINE
 		printf("New substate: POT_1_LOWER\n");
@@ -279,7 +294,7 @@ void update_pot_cal_substate(EventType event) {
 #endif /* DEBUG_STATE_MACHINE */
 		if (event == POT_1_BUTTON_PRESS) {
 			pot1_calibration_buffer[0] = (uint16_t) HAL_ADC_GetValue(&hadc1);
-			single_pulse();
+			play_animation(&single_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 			printf("POT_1_LOWER calibrated.\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -289,8 +304,8 @@ void update_pot_cal_substate(EventType event) {
 #endif /* DEBUG_STATE_MACHINE */
 		} else if (event == POT_1_BUTTON_HOLD) {
 			pot_calibration_flag = CALIBRATION_ABORTED;
-			red_long_pulse();
-			red_double_pulse();
+			play_animation(&red_long_pulse_animation);
+			play_animation(&red_double_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 			printf("\nPOTENTIOMETER CALIBRATION ABORTED\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -318,7 +333,7 @@ void update_pot_cal_substate(EventType event) {
 #endif /* DEBUG_STATE_MACHINE */
 		if (event == POT_1_BUTTON_PRESS) {
 			pot1_calibration_buffer[1] = (uint16_t) HAL_ADC_GetValue(&hadc1);
-			single_pulse();
+			play_animation(&single_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 			printf("POT_1_UPPER calibrated.\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -328,8 +343,8 @@ void update_pot_cal_substate(EventType event) {
 #endif /* DEBUG_STATE_MACHINE */
 		} else if (event == POT_1_BUTTON_HOLD) {
 			pot_calibration_flag = CALIBRATION_ABORTED;
-			red_long_pulse();
-			red_double_pulse();
+			play_animation(&red_long_pulse_animation);
+			play_animation(&red_double_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 			printf("\nPOTENTIOMETER CALIBRATION ABORTED\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -357,7 +372,7 @@ void update_pot_cal_substate(EventType event) {
 #endif /* DEBUG_STATE_MACHINE */
 		if (event == POT_2_BUTTON_PRESS) {
 			pot2_calibration_buffer[0] = adc2_dma_buffer[1];
-			single_pulse();
+			play_animation(&single_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 			printf("POT_2_LOWER calibrated.\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -367,8 +382,8 @@ void update_pot_cal_substate(EventType event) {
 #endif /* DEBUG_STATE_MACHINE */
 		} else if (event == POT_1_BUTTON_HOLD) {
 			pot_calibration_flag = CALIBRATION_ABORTED;
-			red_long_pulse();
-			red_double_pulse();
+			play_animation(&red_long_pulse_animation);
+			play_animation(&red_double_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 			printf("\nPOTENTIOMETER CALIBRATION ABORTED\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -396,7 +411,7 @@ void update_pot_cal_substate(EventType event) {
 #endif /* DEBUG_STATE_MACHINE */
 		if (event == POT_2_BUTTON_PRESS) {
 			pot2_calibration_buffer[1] = adc2_dma_buffer[1];
-			single_pulse();
+			play_animation(&single_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 			printf("POT_2_UPPER calibrated.\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -406,8 +421,8 @@ void update_pot_cal_substate(EventType event) {
 #endif /* DEBUG_STATE_MACHINE */
 		} else if (event == POT_1_BUTTON_HOLD) {
 			pot_calibration_flag = CALIBRATION_ABORTED;
-			red_long_pulse();
-			red_double_pulse();
+			play_animation(&red_long_pulse_animation);
+			play_animation(&red_double_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 			printf("\nPOTENTIOMETER CALIBRATION ABORTED\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -435,7 +450,7 @@ void update_pot_cal_substate(EventType event) {
 #endif /* DEBUG_STATE_MACHINE */
 		if (event == POT_3_BUTTON_PRESS) {
 			pot3_calibration_buffer[0] = adc2_dma_buffer[0];
-			single_pulse();
+			play_animation(&single_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 			printf("POT_3_LOWER calibrated.\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -445,8 +460,8 @@ void update_pot_cal_substate(EventType event) {
 #endif /* DEBUG_STATE_MACHINE */
 		} else if (event == POT_1_BUTTON_HOLD) {
 			pot_calibration_flag = CALIBRATION_ABORTED;
-			red_long_pulse();
-			red_double_pulse();
+			play_animation(&red_long_pulse_animation);
+			play_animation(&red_double_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 			printf("\nPOTENTIOMETER CALIBRATION ABORTED\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -474,13 +489,13 @@ void update_pot_cal_substate(EventType event) {
 #endif /* DEBUG_STATE_MACHINE */
 		if (event == POT_3_BUTTON_PRESS) {
 			pot3_calibration_buffer[1] = adc2_dma_buffer[0];
-			single_pulse();
+			play_animation(&single_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 			printf("POT_3_UPPER calibrated.\n");
 #endif /* DEBUG_CALIBRATIONS */
-			HAL_Delay(1000);
-			long_pulse();
-			double_pulse();
+			play_animation(&notification_pause_animation);
+			play_animation(&long_pulse_animation);
+			play_animation(&double_pulse_animation);
 			pot_cal_substate = POT_CALIBRATION_START;
 #ifdef DEBUG_STATE_MACHINE
 			printf("New substate: POT_CALIBRATION_START\n");
@@ -516,8 +531,8 @@ void update_pot_cal_substate(EventType event) {
 #endif /* DEBUG_CALIBRATIONS */
 		} else if (event == POT_1_BUTTON_HOLD) {
 			pot_calibration_flag = CALIBRATION_ABORTED;
-			red_long_pulse();
-			red_double_pulse();
+			play_animation(&red_long_pulse_animation);
+			play_animation(&red_double_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 			printf("\nPOTENTIOMETER CALIBRATION ABORTED\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -563,16 +578,23 @@ void update_led_cal_substate(EventType event) {
 	/* Handle special state of LED_CALIBRATION_START. */
 	if (led_cal_substate == LED_CALIBRATION_START) {
 		/* Notification pulses for the beginning of the calibration process. */
-		double_pulse();
+		play_animation(&double_pulse_animation);
 		led_calibration_flag = CALIBRATION_IN_PROGRESS;
 #ifdef DEBUG_CALIBRATIONS
 		printf("\nSTARTING LED CALIBRATION PROCESS\n\n");
 #endif /* DEBUG_CALIBRATIONS */
 
-		/* Turn the first LED on. */
-		uint8_t led_init_config[16] = { RESET };
-		led_init_config[led_cal_substate] = SET;
-		initialise_LED_drivers(led_init_config);
+		/* Stop BCM and blank the LEDs while the drivers are written. */
+		framebuffer_set_levels(NULL);
+		framebuffer_set_masks(LED_MASK_NONE, LED_MASK_NONE, LED_MASK_NONE);
+		flush_framebuffer();
+
+		/* Measure the LEDs uncorrected, then turn the first LED on. */
+		uint8_t dot_correction[3][NUM_LEDS];
+		memset(dot_correction, DOT_CORRECTION_MAX, sizeof(dot_correction));
+		configure_dot_correction(dot_correction);
+		uint16_t led_mask = 1 << led_cal_substate;
+		framebuffer_set_masks(led_mask, led_mask, led_mask);
 
 		/* Increment to the next substate. */
 		led_cal_substate++;
@@ -593,13 +615,12 @@ void update_led_cal_substate(EventType event) {
 		led_calibration_buffer[led_cal_substate - 1][2] = adc2_dma_buffer[0];
 
 		/* Notification pulse for data capture. */
-		single_pulse();
+		play_animation(&single_pulse_animation);
 
 		if (led_cal_substate < LED_16) {
 			/* Turn the next LED on. */
-			uint8_t led_init_config[16] = { RESET };
-			led_init_config[led_cal_substate] = SET;
-			initialise_LED_drivers(led_init_config);
+			uint16_t led_mask = 1 << led_cal_substate;
+			framebuffer_set_masks(led_mask, led_mask, led_mask);
 
 			/* Increment to the next substate. */
 			led_cal_substate++;
@@ -607,17 +628,34 @@ void update_led_cal_substate(EventType event) {
 			printf("New substate: %s\n", substate_names[led_cal_substate]);
 #endif /* DEBUG_STATE_MACHINE */
 		} else {
-			/* Turn all of the LEDs on again. */
-			uint8_t led_init_config[16];
-			for (int i = 0; i < 16; i++) {
-				led_init_config[i] = SET;
+			/* Write the captured data to the drivers' dot correction. */
+			uint8_t dot_correction[3][NUM_LEDS];
+			calculate_dot_correction(led_calibration_buffer, dot_correction);
+			LED_Driver_Status dot_status = configure_dot_correction(
+					dot_correction);
+
+			/* Even the LEDs out with BCM where the drivers could not. */
+			if (dot_status != LED_DRIVER_OK) {
+				uint8_t levels[3][NUM_LEDS];
+				bcm_levels_from_dot_correction(dot_correction,
+						get_failed_LED_chains(), levels);
+				framebuffer_set_levels(levels);
 			}
-			initialise_LED_drivers(led_init_config);
+
+			/* Turn all of the LEDs on again. */
+			framebuffer_set_masks(LED_MASK_ALL, LED_MASK_ALL, LED_MASK_ALL);
+			flush_framebuffer();
 
 			/* Notification pulses for the end of the calibration process. */
-			HAL_Delay(1000);
-			long_pulse();
-			double_pulse();
+			play_animation(&notification_pause_animation);
+			if (dot_status != LED_DRIVER_OK) {
+				play_animation(&red_single_pulse_animation);
+#ifdef DEBUG_CALIBRATIONS
+				printf("\nERROR: Dot correction verification failed.\n");
+#endif /* DEBUG_CALIBRATIONS */
+			}
+			play_animation(&long_pulse_animation);
+			play_animation(&double_pulse_animation);
 
 			/* Reset the substate. */
 			led_cal_substate = LED_CALIBRATION_START;
@@ -638,7 +676,11 @@ void update_led_cal_substate(EventType event) {
 #endif /* DEBUG_STATE_MACHINE */
 
 			/* Set led_calibration_flag. */
-			led_calibration_flag = CALIBRATION_DATA_READY;
+			if (dot_status == LED_DRIVER_OK) {
+				led_calibration_flag = CALIBRATION_DATA_PROCESSED;
+			} else {
+				led_calibration_flag = CALIBRATION_DATA_READY;
+			}
 #ifdef DEBUG_CALIBRATIONS
 			printf("\nLED CALIBRATION COMPLETED SUCCESSFULLY!\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -656,8 +698,8 @@ void update_led_cal_substate(EventType event) {
 #endif /* DEBUG_CALIBRATIONS */
 		}
 	} else if (event == POT_2_BUTTON_HOLD) {
-		red_long_pulse();
-		red_double_pulse();
+		play_animation(&red_long_pulse_animation);
+		play_animation(&red_double_pulse_animation);
 
 		/* Set led_calibration_flag. */
 		led_calibration_flag = CALIBRATION_ABORTED;
@@ -686,8 +728,12 @@ void update_led_cal_substate(EventType event) {
 }
 
 int sensor_calibration_process(void) {
+	/* The sweeps write pulses directly, so recompute the output afterwards. */
+	invalidate_derived_values();
+
 	/* Flash white LEDs twice to indicate start of calibration. */
-	double_pulse();
+	play_animation(&double_pulse_animation);
+	wait_for_animation();
 
 	/* Set sensor_calibration_flag. */
 	sensor_calibration_flag = CALIBRATION_IN_PROGRESS;
@@ -710,9 +756,9 @@ int sensor_calibration_process(void) {
 		}
 		/* Check for abort. */
 		else if (result == -2) {
-			HAL_Delay(1000);
-			red_long_pulse();
-			red_double_pulse();
+			play_animation(&notification_pause_animation);
+			play_animation(&red_long_pulse_animation);
+			play_animation(&red_double_pulse_animation);
 
 			/* Set sensor_calibration_flag. */
 			sensor_calibration_flag = CALIBRATION_ABORTED;
@@ -723,9 +769,9 @@ int sensor_calibration_process(void) {
 		}
 	}
 	if (attempt == max_attempts) {
-		HAL_Delay(1000);
-		red_long_pulse();
-		red_double_pulse();
+		play_animation(&notification_pause_animation);
+		play_animation(&red_long_pulse_animation);
+		play_animation(&red_double_pulse_animation);
 
 		/* Set sensor_calibration_flag. */
 		sensor_calibration_flag = CALIBRATION_ABORTED;
@@ -744,9 +790,9 @@ int sensor_calibration_process(void) {
 		}
 		/* Check for abort. */
 		else if (result == -2) {
-			HAL_Delay(1000);
-			red_long_pulse();
-			red_double_pulse();
+			play_animation(&notification_pause_animation);
+			play_animation(&red_long_pulse_animation);
+			play_animation(&red_double_pulse_animation);
 
 			/* Set sensor_calibration_flag. */
 			sensor_calibration_flag = CALIBRATION_ABORTED;
@@ -757,9 +803,9 @@ int sensor_calibration_process(void) {
 		}
 	}
 	if (attempt == max_attempts) {
-		HAL_Delay(1000);
-		red_long_pulse();
-		red_double_pulse();
+		play_animation(&notification_pause_animation);
+		play_animation(&red_long_pulse_animation);
+		play_animation(&red_double_pulse_animation);
 
 		/* Set sensor_calibration_flag. */
 		sensor_calibration_flag = CALIBRATION_ABORTED;
@@ -778,9 +824,9 @@ int sensor_calibration_process(void) {
 		}
 		/* Check for abort. */
 		else if (result == -2) {
-			HAL_Delay(1000);
-			red_long_pulse();
-			red_double_pulse();
+			play_animation(&notification_pause_animation);
+			play_animation(&red_long_pulse_animation);
+			play_animation(&red_double_pulse_animation);
 
 			/* Set sensor_calibration_flag. */
 			sensor_calibration_flag = CALIBRATION_ABORTED;
@@ -791,9 +837,9 @@ int sensor_calibration_process(void) {
 		}
 	}
 	if (attempt == max_attempts) {
-		HAL_Delay(1000);
-		red_long_pulse();
-		red_double_pulse();
+		play_animation(&notification_pause_animation);
+		play_animation(&red_long_pulse_animation);
+		play_animation(&red_double_pulse_animation);
 
 		/* Set sensor_calibration_flag. */
 		sensor_calibration_flag = CALIBRATION_ABORTED;
@@ -804,12 +850,21 @@ int sensor_calibration_process(void) {
 	}
 
 	/* Notification pulses for the end of the calibration process. */
-	HAL_Delay(1000);
-	long_pulse();
-	double_pulse();
+	play_animation(&notification_pause_animation);
+	play_animation(&long_pulse_animation);
+	play_animation(&double_pulse_animation);
 
 	/* Set sensor_calibration_flag */
 	sensor_calibration_flag = CALIBRATION_DATA_READY;
+
+	/* Fit the luminance balance, then rebuild the white light colours. */
+	if (fit_luminance_balance() != BALANCE_OK) {
+#ifdef DEBUG_CALIBRATIONS
+		printf("\nLUMINANCE BALANCE FIT FAILED, KEEPING PREVIOUS\n");
+#endif /* DEBUG_CALIBRATIONS */
+	}
+	generate_white_table();
+	generate_gain_tables();
 #ifdef DEBUG_CALIBRATIONS
 	printf("\nLIGHT SENSOR CALIBRATION COMPLETED SUCCESSFULLY!\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -861,18 +916,16 @@ int sensor_calibration_process(void) {
 
 int baseline_calibration(uint32_t buffer[][2], int array_index) {
 	/* Turn the LEDs completely off and collect data. */
-	uint8_t led_init_config[16] = { RESET };
-	initialise_LED_drivers(led_init_config);
+	framebuffer_set_masks(LED_MASK_NONE, LED_MASK_NONE, LED_MASK_NONE);
+	flush_framebuffer();
 #ifdef DEBUG_CALIBRATIONS
 	printf("LEDS OFF\n");
 #endif /* DEBUG_CALIBRATIONS */
 	int result = collect_calibration_data(buffer, array_index);
 
 	/* Turn the LEDs back on. */
-	for (int i = 0; i < 16; i++) {
-		led_init_config[i] = SET;
-	}
-	initialise_LED_drivers(led_init_config);
+	framebuffer_set_masks(LED_MASK_ALL, LED_MASK_ALL, LED_MASK_ALL);
+	flush_framebuffer();
 
 	/* Check for data capture failure. */
 	if (result == -1) {
@@ -908,7 +961,8 @@ int brightness_calibration(uint32_t buffer[][2]) {
 		uint16_t pulse_value = COUNTER_PERIOD
 				- brightness * COUNTER_PERIOD / NUM_CAL_INCS;
 		uint16_t pulse_values[3] = { pulse_value, pulse_value, pulse_value };
-		set_pulse_values(pulse_values);
+		framebuffer_set_pulses(pulse_values);
+		flush_framebuffer();
 #ifdef DEBUG_CALIBRATIONS
 		printf("PULSE = %u\n", pulse_value);
 #endif /* DEBUG_CALIBRATIONS */
@@ -939,7 +993,7 @@ int brightness_calibration(uint32_t buffer[][2]) {
 	int threshold = buffer[0][0] / 50;
 	int difference = buffer[0][0] - buffer[array_index][0];
 	if (abs(difference) > threshold) {
-		red_single_pulse();
+		play_animation(&red_single_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 		printf("\nERROR: Baseline changed over brightness calibration.\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -968,65 +1022,28 @@ int colour_calibration(uint32_t buffer[][2]) {
 	}
 	array_index += 1;
 
-	/* Increment through the colours and collect data. */
-	uint8_t segment_length = NUM_CAL_INCS / 6;
+	/* Step around the hue wheel (shared with RGB_LIGHT) and collect data. */
 	uint16_t pulse_values[3];
 	for (uint16_t colour = 0; colour < NUM_CAL_INCS; colour++) {
-		uint16_t segment = colour / segment_length;
-		uint16_t segment_position = colour % segment_length;
-		uint16_t value = (COUNTER_PERIOD * segment_position) / segment_length;
-
-		/* Calculate the RGB colour vector. */
-		switch (segment) {
-		case 0:
-			pulse_values[0] = COUNTER_PERIOD;
-			pulse_values[1] = value;
-			pulse_values[2] = 0;
-			break;
-
-		case 1:
-			pulse_values[0] = (COUNTER_PERIOD - value);
-			pulse_values[1] = COUNTER_PERIOD;
-			pulse_values[2] = 0;
-			break;
+		uint32_t rgb_colour[3];
+		hue_colour(colour * ADC_RES / NUM_CAL_INCS, COLOUR_ONE, rgb_colour);
 
-		case 2:
-			pulse_values[0] = 0;
-			pulse_values[1] = COUNTER_PERIOD;
-			pulse_values[2] = value;
-			break;
-
-		case 3:
-			pulse_values[0] = 0;
-			pulse_values[1] = (COUNTER_PERIOD - value);
-			pulse_values[2] = COUNTER_PERIOD;
-			break;
-
-		case 4:
-			pulse_values[0] = value;
-			pulse_values[1] = 0;
-			pulse_values[2] = COUNTER_PERIOD;
-			break;
-
-		case 5:
-			pulse_values[0] = COUNTER_PERIOD;
-			pulse_values[1] = 0;
-			pulse_values[2] = (COUNTER_PERIOD - value);
-			break;
+		/* Convert the on-times to pulses, inverted as BLANK is active low. */
+		for (int channel = 0; channel < 3; channel++) {
+			pulse_values[channel] = COUNTER_PERIOD
+					- ((rgb_colour[channel] * COUNTER_PERIOD) >> COLOUR_SHIFT);
 		}
 
 #ifdef DEBUG_CALIBRATIONS
-		printf("RGB PULSE VECTOR = (%4u, %4u, %4u)\n", pulse_values[0],
-				pulse_values[1], pulse_values[2]);
+		printf("RGB PULSE VECTOR = (%4u, %4u, %4u)\n",
+				COUNTER_PERIOD - pulse_values[0],
+				COUNTER_PERIOD - pulse_values[1],
+				COUNTER_PERIOD - pulse_values[2]);
 #endif /* DEBUG_CALIBRATIONS */
 
-		/* Invert pulse values as BLANK is active low. */
-		pulse_values[0] = COUNTER_PERIOD - pulse_values[0];
-		pulse_values[1] = COUNTER_PERIOD - pulse_values[1];
-		pulse_values[2] = COUNTER_PERIOD - pulse_values[2];
-
 		/* Set LED colours. */
-		set_pulse_values(pulse_values);
+		framebuffer_set_pulses(pulse_values);
+		flush_framebuffer();
 
 		result = collect_calibration_data(buffer, array_index);
 		/* Check for data capture failure. */
@@ -1055,7 +1072,7 @@ int colour_calibration(uint32_t buffer[][2]) {
 	int threshold = buffer[0][0] / 50;
 	int difference = buffer[0][0] - buffer[array_index][0];
 	if (abs(difference) > threshold) {
-		red_single_pulse();
+		play_animation(&red_single_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 		printf("\nERROR: Baseline changed over colour calibration.\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -1089,15 +1106,17 @@ int white_calibration(uint32_t buffer[][2]) {
 	uint16_t kelvin_increment = kelvin_range / NUM_CAL_INCS;
 
 	uint16_t kelvin;
+	uint16_t weight;
 	KelvinToRGB lower;
 	KelvinToRGB higher;
 	uint16_t pulse_values[3];
 
 	for (int i = 0; i <= NUM_CAL_INCS; i++) {
 		kelvin = kelvin_table[0].kelvin + i * kelvin_increment;
-		search_rgb_to_kelvin(kelvin, &lower, &higher);
-		pulse_for_kelvin(kelvin, &lower, &higher, pulse_values);
-		set_pulse_values(pulse_values);
+		weight = search_rgb_to_kelvin(kelvin, &lower, &higher);
+		pulse_for_kelvin(weight, &lower, &higher, pulse_values);
+		framebuffer_set_pulses(pulse_values);
+		flush_framebuffer();
 #ifdef DEBUG_CALIBRATIONS
 		printf("TEMPERATURE: %u\n", kelvin);
 #endif /* DEBUG_CALIBRATIONS */
@@ -1129,7 +1148,7 @@ int white_calibration(uint32_t buffer[][2]) {
 	int difference = buffer[0][0] - buffer[array_index][0];
 	if (abs(difference) > threshold) {
 		return -1;
-		red_single_pulse();
+		play_animation(&red_single_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 		printf("\nERROR: Baseline changed over white calibration.\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -1141,6 +1160,9 @@ int white_calibration(uint32_t buffer[][2]) {
 }
 
 int collect_calibration_data(uint32_t buffer[][2], int array_index) {
+	/* Let any notification play out so it does not light the measurement. */
+	wait_for_animation();
+
 	/* Discard conversion currently in progress. */
 	light_sensor_flag = WAITING;
 	while (light_sensor_flag != NEW_READY) {
@@ -1188,7 +1210,7 @@ int collect_calibration_data(uint32_t buffer[][2], int array_index) {
 		buffer[array_index][1] = variance;
 	} else {
 		/* Notify user of failure. */
-		red_single_pulse();
+		play_animation(&red_single_pulse_animation);
 #ifdef DEBUG_CALIBRATIONS
 		printf("\nERROR: Data collection failed due to excessive variance.\n");
 #endif /* DEBUG_CALIBRATIONS */
@@ -59,6 +59,10 @@ extern DMA_HandleTypeDef hdma_adc2;
 extern I2C_HandleTypeDef hi2c2;
 extern TIM_HandleTypeDef htim2;
 /* USER CODE BEGIN EV */
+extern DMA_HandleTypeDef hdma_shift_port_b;
+extern TIM_HandleTypeDef htim6;
+extern TIM_HandleTypeDef htim3;
+extern DMA_HandleTypeDef hdma_tim3_up;
 
 /* USER CODE END EV */
 
@@ -269,5 +273,32 @@ void DMA2_Channel1_IRQHandler(void) {
 }
 
 /* USER CODE BEGIN 1 */
+/**
+ * @brief This function handles DMA1 channel7 global interrupt (LED shifts).
+ */
+void DMA1_Channel7_IRQHandler(void) {
+	HAL_DMA_IRQHandler(&hdma_shift_port_b);
+}
+
+/**
+ * @brief This function handles TIM6 global interrupt (BCM bit-planes).
+ */
+void TIM6_DAC_IRQHandler(void) {
+	HAL_TIM_IRQHandler(&htim6);
+}
+
+/**
+ * @brief This function handles TIM3 global interrupt (PWM dithering).
+ */
+void TIM3_IRQHandler(void) {
+	HAL_TIM_IRQHandler(&htim3);
+}
+
+/**
+ * @brief This function handles DMA1 channel3 global interrupt (PWM bursts).
+ */
+void DMA1_Channel3_IRQHandler(void) {
+	HAL_DMA_IRQHandler(&hdma_tim3_up);
+}
 
 /* USER CODE END 1 */
@@ -14,12 +14,18 @@
 #include "globals.h"
 #include "colour_control.h"
 #include "timers.h"
+#include "LED_bcm.h"
+#include "LED_pwm.h"
 #include "debug_flags.h"
 
 /**
  * @brief Reads the potentiometers and updates their moving averages.
  *
- * @param htim: pointer to the timer instance (TIM2)
+ * Also advances the BCM bit-planes on TIM6 updates and writes the pulse
+ * values on TIM3 periods (from the update interrupt or the burst's DMA
+ * interrupt, see LED_pwm.c).
+ *
+ * @param htim: pointer to the timer instance (TIM2, TIM3 or TIM6)
  *
  * @return None.
  */
@@ -61,5 +67,11 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
 
 		/* Set flag to indicate that new moving averages are available. */
 		potentiometer_flag = NEW_READING_READY;
+	} else if (htim->Instance == TIM6) {
+		/* Latch the next BCM bit-plane. */
+		advance_bcm_plane();
+	} else if (htim->Instance == TIM3) {
+		/* Write the next period's pulse values. */
+		pwm_period_elapsed();
 	}
 }
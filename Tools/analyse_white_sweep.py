@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""
+Reports how fast the white light colour moves per colour pot (pot 2) count.
+
+In WHITE_LIGHT the colour pot selects a colour temperature between the
+ends of kelvin_table, hottest at 0. generate_white_table() in
+Core/Src/colour_control.c spaces the table evenly in mireds; the previous
+firmware mapped the pot linearly onto kelvin. For each mapping this tool
+splits the pot travel into bands and prints, per ADC count:
+
+    K/count       change in colour temperature
+    mired/count   change in mireds (1e6 / K)
+    duv/count     distance moved along the Planckian locus in CIE 1960 uv,
+                  x 1e4, a rough measure of the visible colour change
+
+An even sweep has a steady duv/count across the bands. The mired mapping
+follows the firmware's integer maths (1/16 mired steps, 257 table entries
+interpolated over 16 counts). Run from the repository root:
+
+    python3 Tools/analyse_white_sweep.py [--bands 8]
+"""
+
+import argparse
+import math
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from generate_kelvin_table import kelvin_to_xyz, read_kelvin_table  # noqa
+
+ADC_RES_BITS = 12       # Must match ADC_RES_BITS in Core/Inc/globals.h.
+ADC_RES = 1 << ADC_RES_BITS
+WHITE_TABLE_BITS = 8    # Must match WHITE_TABLE_BITS in colour_control.h.
+MIRED_SCALE = 16000000  # Must match MIRED_SCALE in colour_control.c.
+
+
+def linear_kelvin(pot, min_kelvin, max_kelvin):
+    """Kelvin for a pot reading with the old kelvin-linear mapping."""
+    return max_kelvin - ((pot * (max_kelvin - min_kelvin)) >> ADC_RES_BITS)
+
+
+def mired_kelvin(pot, min_kelvin, max_kelvin):
+    """Kelvin for a pot reading with the firmware's mired-linear table."""
+    min_mired = MIRED_SCALE // max_kelvin
+    max_mired = MIRED_SCALE // min_kelvin
+    step_bits = ADC_RES_BITS - WHITE_TABLE_BITS
+
+    def entry(index):
+        mired = min_mired + (((index << step_bits) * (max_mired - min_mired))
+                             >> ADC_RES_BITS)
+        return (MIRED_SCALE + mired // 2) // mired
+
+    # The firmware interpolates colours rather than kelvin between entries,
+    # which is close enough here as the entries are only ~16 counts apart.
+    index = pot >> step_bits
+    fraction = (pot & ((1 << step_bits) - 1)) / (1 << step_bits)
+    return entry(index) + (entry(index + 1) - entry(index)) * fraction
+
+
+def locus_uv(kelvin):
+    x, y, z = kelvin_to_xyz(kelvin)
+    denominator = x + 15 * y + 3 * z
+    return 4 * x / denominator, 6 * y / denominator
+
+
+def report(name, mapping, min_kelvin, max_kelvin, bands):
+    kelvins = [mapping(pot, min_kelvin, max_kelvin) for pot in range(ADC_RES)]
+    cache = {}
+
+    def uv(kelvin):
+        key = round(kelvin, 1)
+        if key not in cache:
+            cache[key] = locus_uv(key)
+        return cache[key]
+
+    print(f"\n{name}")
+    print("  pot range       kelvin range     K/count  mired/count  "
+          "duv/count x1e4")
+    rates = []
+    band_size = ADC_RES // bands
+    for band in range(bands):
+        first = band * band_size
+        last = first + band_size - 1
+        counts = last - first
+        k_first, k_last = kelvins[first], kelvins[last]
+        mireds = abs(1e6 / k_last - 1e6 / k_first)
+        (u1, v1), (u2, v2) = uv(k_first), uv(k_last)
+        duv = math.hypot(u2 - u1, v2 - v1) * 1e4 / counts
+        rates.append(duv)
+        print(f"  {first:4d}-{last:4d}  {k_first:7.0f}-{k_last:7.0f} K  "
+              f"{abs(k_last - k_first) / counts:8.3f}  {mireds / counts:11.4f}"
+              f"  {duv:14.4f}")
+    print(f"  duv/count spread (largest / smallest band): "
+          f"{max(rates) / min(rates):.2f}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("--bands", type=int, default=8,
+                        help="number of pot bands to report (default 8)")
+    args = parser.parse_args()
+    if not 1 <= args.bands <= ADC_RES // 2:
+        print("error: bands out of range", file=sys.stderr)
+        return 1
+
+    kelvins = sorted(read_kelvin_table())
+    min_kelvin, max_kelvin = kelvins[0], kelvins[-1]
+    print(f"kelvin_table spans {min_kelvin} K to {max_kelvin} K "
+          f"over {ADC_RES} pot counts")
+    report("Kelvin-linear (previous)", linear_kelvin, min_kelvin, max_kelvin,
+           args.bands)
+    report("Mired-linear (firmware)", mired_kelvin, min_kelvin, max_kelvin,
+           args.bands)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""
+Fits the luminance balance to a captured sensor calibration dump.
+
+With DEBUG_CALIBRATIONS defined, sensor_calibration_process() prints the
+lux mean and variance of every brightness, white and colour sweep step over
+SWO. This reads that output and runs the same fit as
+fit_luminance_balance() in Core/Src/luminance_balance.c:
+
+  1. Weighted least squares of (lux - baseline) against the on-time of each
+     colour over all three sweeps gives the lux of each colour fully on.
+  2. Each colour gets the gain that gives it its Rec. 709 primary's share
+     of the luminance, scaled so white drives its strongest colour fully
+     on. The sensor only measures lux, so the hue is not corrected.
+
+It prints the gains (Q14) and luminance weights (Q16) as C initialisers
+for luminance_gains and luminance_weights:
+
+    python3 Tools/fit_luminance_balance.py swo_capture.txt
+"""
+
+import argparse
+import os
+import re
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from generate_kelvin_table import read_kelvin_table, solve  # noqa
+
+NUM_CAL_INCS = 24           # Must match NUM_CAL_INCS in Core/Inc/globals.h.
+ADC_RES_BITS = 12           # Must match ADC_RES_BITS in Core/Inc/globals.h.
+ADC_RES = 1 << ADC_RES_BITS
+HUE_TABLE_BITS = 8          # Must match HUE_TABLE_BITS in hue_table.h.
+KELVIN_WEIGHT_SHIFT = 15    # Must match kelvin_to_rgb.h.
+HUE_SOURCE = "Core/Src/hue_table.c"
+LUMINANCE_GAIN_SHIFT = 14   # Must match luminance_balance.h.
+LUMINANCE_WEIGHT_SHIFT = 16
+REC709_LUMINANCE = (0.2126, 0.7152, 0.0722)
+
+SECTIONS = ("Brightness calibration:", "White light calibration:",
+            "Colour light calibration:")
+READING = re.compile(r"mean = (\d+),\s*variance = (\d+)")
+
+
+def parse_dump(text):
+    """Returns the (mean, variance) rows of each sweep, baselines included."""
+    sweeps = []
+    for title in SECTIONS:
+        start = text.rindex(title) + len(title)
+        rows = []
+        for line in text[start:].splitlines():
+            match = READING.search(line)
+            if match:
+                rows.append((int(match.group(1)), int(match.group(2))))
+                if line.strip().startswith("Final baseline"):
+                    break
+        sweeps.append(rows)
+    return sweeps
+
+
+def brightness_drive(increment):
+    level = increment / NUM_CAL_INCS
+    return [level, level, level]
+
+
+def white_drive(increment, table):
+    """Mirrors white_calibration() and rgb_for_kelvin()."""
+    kelvins = sorted(table)
+    kelvin = kelvins[0] + increment * ((kelvins[-1] - kelvins[0])
+                                       // NUM_CAL_INCS)
+    lower = max(k for k in kelvins if k <= kelvin)
+    if lower == kelvin or lower == kelvins[-1]:
+        rgb = table[lower]
+    else:
+        higher = min(k for k in kelvins if k > kelvin)
+        weight = ((kelvin - lower) << KELVIN_WEIGHT_SHIFT) // (higher - lower)
+        rgb = [(low * (1 << KELVIN_WEIGHT_SHIFT) + weight * (high - low)
+                + (1 << (KELVIN_WEIGHT_SHIFT - 1))) >> KELVIN_WEIGHT_SHIFT
+               for low, high in zip(table[lower], table[higher])]
+    return [value / 256 for value in rgb]
+
+
+def read_hue_table():
+    with open(HUE_SOURCE) as file:
+        source = file.read()
+    body = source[source.index("hue_table[HUE_TABLE_LENGTH][3] ="):]
+    return [[int(v) for v in entry] for entry in
+            re.findall(r"\{\s*(\d+),\s*(\d+),\s*(\d+)\s*\}", body)]
+
+
+def colour_drive(increment, hue_table):
+    """Mirrors colour_calibration() and hue_colour() at full saturation."""
+    position = increment * ADC_RES // NUM_CAL_INCS
+    step_bits = ADC_RES_BITS - HUE_TABLE_BITS
+    index = position >> step_bits
+    fraction = position & ((1 << step_bits) - 1)
+    below, above = hue_table[index], hue_table[index + 1]
+    return [(low + (((high - low) * fraction) >> step_bits)) / 65536
+            for low, high in zip(below, above)]
+
+
+def fit(sweeps, table):
+    normal = [[0.0] * 3 for _ in range(3)]
+    right = [0.0] * 3
+    hue_table = read_hue_table()
+    drives = (brightness_drive, lambda i: white_drive(i, table),
+              lambda i: colour_drive(i, hue_table))
+    for rows, drive in zip(sweeps, drives):
+        baseline = (rows[0][0] + rows[-1][0]) / 2
+        for step, (mean, variance) in enumerate(rows[1:-1]):
+            on_times = drive(step)
+            weight = 1 / (variance + 1)
+            for r in range(3):
+                for c in range(3):
+                    normal[r][c] += weight * on_times[r] * on_times[c]
+                right[r] += weight * on_times[r] * (mean - baseline)
+
+    luminance = solve(normal, right)
+    if min(luminance) <= 0:
+        raise ValueError(f"a colour gave no light: {luminance}")
+    total = sum(luminance)
+
+    gains = [share * total / value
+             for share, value in zip(REC709_LUMINANCE, luminance)]
+    peak = max(gains)
+
+    def fixed(value, shift, low, high):
+        value = value * (1 << shift)
+        value = int(value + (0.5 if value >= 0 else -0.5))
+        return max(low, min(high, value))
+
+    q_gains = [fixed(v / peak, LUMINANCE_GAIN_SHIFT, 0,
+                     1 << LUMINANCE_GAIN_SHIFT) for v in gains]
+    weights = [fixed(v / total, LUMINANCE_WEIGHT_SHIFT, 0, 65535)
+               for v in luminance]
+    return luminance, q_gains, weights
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("dump", help="captured DEBUG_CALIBRATIONS output")
+    args = parser.parse_args()
+
+    with open(args.dump) as file:
+        sweeps = parse_dump(file.read())
+    expected = (NUM_CAL_INCS + 3, NUM_CAL_INCS + 3, NUM_CAL_INCS + 2)
+    for title, rows, count in zip(SECTIONS, sweeps, expected):
+        if len(rows) != count:
+            print(f"error: {title} has {len(rows)} readings, expected {count}",
+                  file=sys.stderr)
+            return 1
+
+    try:
+        luminance, gains, weights = fit(sweeps, read_kelvin_table())
+    except (ValueError, ZeroDivisionError) as error:
+        print(f"error: fit failed: {error}", file=sys.stderr)
+        return 1
+
+    print("/* Lux fully on: R %.1f, G %.1f, B %.1f */" % tuple(luminance))
+    print("uint16_t luminance_gains[3] = { %d, %d, %d };" % tuple(gains))
+    print("uint16_t luminance_weights[3] = { %d, %d, %d };" % tuple(weights))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
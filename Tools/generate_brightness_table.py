@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""
+Generates Core/Src/brightness_table.c, the CIE L* brightness lookup table.
+
+The brightness pot (pot 1) dims the LEDs: 0 is full brightness and
+ADC_RES - 1 is off. Each entry holds the relative luminance for that pot
+position as a Q16 fraction, found by mapping the pot linearly onto lightness
+(L* = 100 at 0, L* = 0 at ADC_RES - 1) and converting L* back to luminance:
+
+    Y = ((L* + 16) / 116) ** 3    for L* > 8
+    Y = L* / 903.3                otherwise
+
+The firmware scales the Q16 on-time of each colour by the entry, with
+brightness_gain() adding the top bit back so that 65535 is exactly unity.
+
+The table is checked for monotonicity and against the analytic curve before
+it is written, and again as compiled by Tools/host_tests. Run from the
+repository root after changing ADC_RES:
+
+    python3 Tools/generate_brightness_table.py
+"""
+
+import argparse
+import sys
+
+ADC_RES = 4096          # Must match ADC_RES in Core/Inc/globals.h.
+Q16_ONE = 65535         # Largest value that fits in a uint16_t.
+VALUES_PER_LINE = 8
+OUTPUT = "Core/Src/brightness_table.c"
+
+
+def lightness_to_luminance(lightness):
+    """Inverse of the CIE 1976 lightness function (L* 0-100 -> Y 0-1)."""
+    if lightness > 8.0:
+        return ((lightness + 16.0) / 116.0) ** 3
+    return lightness / 903.3
+
+
+def relative_luminance(pot):
+    """Luminance (0-1) the LEDs should have at a pot position."""
+    lightness = 100.0 * (1.0 - pot / (ADC_RES - 1))
+    return lightness_to_luminance(lightness)
+
+
+def build_table():
+    return [round(relative_luminance(pot) * Q16_ONE) for pot in range(ADC_RES)]
+
+
+def check_table(table):
+    """Returns a list of problems (empty if the table is good)."""
+    problems = []
+    for pot in range(1, ADC_RES):
+        if table[pot] > table[pot - 1]:
+            problems.append(f"not monotonic at pot {pot}")
+    if table[0] != Q16_ONE or table[-1] != 0:
+        problems.append("end points are not full scale and zero")
+    max_error = max(abs(table[pot] / Q16_ONE - relative_luminance(pot))
+                    for pot in range(ADC_RES))
+    # Rounding to Q16 can be off by at most half a step.
+    if max_error > 0.5 / Q16_ONE + 1e-12:
+        problems.append(f"max error {max_error:.3g} exceeds half a Q16 step")
+    return problems
+
+
+def render(table):
+    lines = [
+        "/**",
+        " " + "*" * 79,
+        " * @file brightness_table.c",
+        " * @brief CIE L* brightness lookup table (generated, do not edit).",
+        " *",
+        " * Generated by Tools/generate_brightness_table.py. Entry n is the",
+        " * relative luminance (Q16) for a brightness pot reading of n.",
+        " *",
+        " * @author Erwin Bauernschmitt",
+        " * @date 16/10/2026",
+        " " + "*" * 79,
+        " */",
+        "",
+        "#include <stdint.h>",
+        '#include "globals.h"',
+        '#include "brightness_table.h"',
+        "",
+        "const uint16_t brightness_table[ADC_RES] = {",
+    ]
+    for start in range(0, len(table), VALUES_PER_LINE):
+        chunk = table[start:start + VALUES_PER_LINE]
+        lines.append("\t\t" + ", ".join(f"{value:5d}" for value in chunk) + ",")
+    lines[-1] = lines[-1].rstrip(",")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("--check", action="store_true",
+                        help="verify the committed table is up to date")
+    args = parser.parse_args()
+
+    table = build_table()
+    problems = check_table(table)
+    if problems:
+        for problem in problems:
+            print(f"error: {problem}", file=sys.stderr)
+        return 1
+
+    source = render(table)
+    if args.check:
+        with open(OUTPUT) as file:
+            if file.read() != source:
+                print(f"error: {OUTPUT} is out of date", file=sys.stderr)
+                return 1
+        print(f"{OUTPUT} is up to date")
+        return 0
+
+    with open(OUTPUT, "w") as file:
+        file.write(source)
+    print(f"wrote {OUTPUT} ({len(table)} entries)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
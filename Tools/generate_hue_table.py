@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""
+Generates Core/Src/hue_table.c, the RGB_LIGHT hue wheel lookup table.
+
+The colour pot (pot 2) picks a fully saturated colour in RGB_LIGHT. A plain
+HSV wheel ramps one channel at a time in six equal segments, which spends
+a sixth of the travel on yellow-greens that look much alike and rushes
+through the reds and oranges. Instead,
+the entries here are evenly spaced in OkLCh hue (the hue angle of Oklab,
+Ottosson 2020), so each step of the pot turns the colour by about the same
+visible amount.
+
+Every entry is on the saturated edge of the linear sRGB cube (largest
+channel fully on, smallest off), i.e. the most saturated colour with that
+hue. The edge is sampled finely, its Oklab hue is unwrapped starting at
+red, and the table is read off by interpolating that hue for
+HUE_TABLE_LENGTH evenly spaced angles. Just short of pure blue the Oklab
+hue turns back by about 0.15 degrees; that stretch is flattened with a
+running maximum so the hue can be inverted. Entry 0 and the last entry are
+both red, so the firmware can interpolate across the whole wheel.
+
+Values are linear Q16 on-times. Brightness across the wheel is left to the
+constant luminance gains in colour_control.c. Run from the repository root
+after changing HUE_TABLE_BITS:
+
+    python3 Tools/generate_hue_table.py
+"""
+
+import argparse
+import math
+import sys
+
+HUE_TABLE_BITS = 8      # Must match HUE_TABLE_BITS in Core/Inc/hue_table.h.
+HUE_TABLE_LENGTH = (1 << HUE_TABLE_BITS) + 1
+Q16_ONE = 65535         # Largest value that fits in a uint16_t.
+EDGE_SAMPLES = 6 * 4096
+VALUES_PER_LINE = 3
+OUTPUT = "Core/Src/hue_table.c"
+
+
+def linear_srgb_to_oklab(r, g, b):
+    l = 0.4122214708 * r + 0.5363325363 * g + 0.0514459929 * b
+    m = 0.2119034982 * r + 0.6806995451 * g + 0.1073969566 * b
+    s = 0.0883024619 * r + 0.2817188376 * g + 0.6299787005 * b
+    l, m, s = (math.copysign(abs(v) ** (1 / 3), v) for v in (l, m, s))
+    return (0.2104542553 * l + 0.7936177850 * m - 0.0040720468 * s,
+            1.9779984951 * l - 2.4285922050 * m + 0.4505937099 * s,
+            0.0259040371 * l + 0.7827717662 * m - 0.8086757660 * s)
+
+
+def saturated_edge(position):
+    """Linear RGB on the saturated cube edge, position 0-6 (HSV hue / 60)."""
+    segment = int(position) % 6
+    ramp = position - int(position)
+    return ((1, ramp, 0), (1 - ramp, 1, 0), (0, 1, ramp),
+            (0, 1 - ramp, 1), (ramp, 0, 1), (1, 0, 1 - ramp))[segment]
+
+
+def oklab_hue(rgb):
+    _, a, b = linear_srgb_to_oklab(*rgb)
+    return math.atan2(b, a)
+
+
+def build_table():
+    # Unwrapped OkLCh hue along the edge, from red all the way round.
+    positions = [6 * i / EDGE_SAMPLES for i in range(EDGE_SAMPLES + 1)]
+    hues = []
+    for position in positions:
+        hue = oklab_hue(saturated_edge(position % 6))
+        if hues:
+            while hue < hues[-1] - math.pi:
+                hue += 2 * math.pi
+            hue = max(hue, hues[-1])
+        hues.append(hue)
+
+    table = []
+    sample = 0
+    for entry in range(HUE_TABLE_LENGTH):
+        target = hues[0] + 2 * math.pi * entry / (HUE_TABLE_LENGTH - 1)
+        while sample < EDGE_SAMPLES - 1 and hues[sample + 1] < target:
+            sample += 1
+        span = hues[sample + 1] - hues[sample]
+        fraction = 0.0 if span == 0 else \
+            min(1.0, max(0.0, (target - hues[sample]) / span))
+        position = positions[sample] + fraction * (6 / EDGE_SAMPLES)
+        rgb = saturated_edge(position % 6)
+        table.append([round(value * Q16_ONE) for value in rgb])
+    return table, hues
+
+
+def check_table(table, hues):
+    """Returns a list of problems (empty if the table is good)."""
+    problems = []
+    if any(later < earlier for earlier, later in zip(hues, hues[1:])):
+        problems.append("OkLCh hue is not monotonic along the cube edge")
+    if abs(hues[-1] - hues[0] - 2 * math.pi) > 1e-9:
+        problems.append("the edge does not turn exactly once")
+    if table[0] != table[-1] or table[0] != [Q16_ONE, 0, 0]:
+        problems.append("the wheel does not start and end on red")
+    for entry, rgb in enumerate(table):
+        if max(rgb) != Q16_ONE or min(rgb) != 0:
+            problems.append(f"entry {entry} is not fully saturated")
+    # Adjacent entries should be an even hue step apart.
+    step = 2 * math.pi / (HUE_TABLE_LENGTH - 1)
+    for entry in range(1, HUE_TABLE_LENGTH):
+        turn = (oklab_hue([v / Q16_ONE for v in table[entry]])
+                - oklab_hue([v / Q16_ONE for v in table[entry - 1]]))
+        turn = (turn + math.pi) % (2 * math.pi) - math.pi
+        if abs(turn - step) > 0.05 * step:
+            problems.append(f"uneven hue step before entry {entry}")
+    return problems
+
+
+def render(table):
+    lines = [
+        "/**",
+        " " + "*" * 79,
+        " * @file hue_table.c",
+        " * @brief OkLCh hue wheel lookup table (generated, do not edit).",
+        " *",
+        " * Generated by Tools/generate_hue_table.py. Entries are the most",
+        " * saturated linear RGB colours (Q16) at evenly spaced OkLCh hues,",
+        " * from red through yellow, green, cyan, blue and magenta to red.",
+        " *",
+        " * @author Erwin Bauernschmitt",
+        " * @date 16/10/2026",
+        " " + "*" * 79,
+        " */",
+        "",
+        "#include <stdint.h>",
+        '#include "hue_table.h"',
+        "",
+        "const uint16_t hue_table[HUE_TABLE_LENGTH][3] = {",
+    ]
+    entries = ["{ " + ", ".join(f"{value:5d}" for value in rgb) + " }"
+               for rgb in table]
+    for start in range(0, len(entries), VALUES_PER_LINE):
+        lines.append("\t\t" + ", ".join(entries[start:start + VALUES_PER_LINE])
+                     + ",")
+    lines[-1] = lines[-1].rstrip(",")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("--check", action="store_true",
+                        help="verify the committed table is up to date")
+    args = parser.parse_args()
+
+    table, hues = build_table()
+    problems = check_table(table, hues)
+    if problems:
+        for problem in problems:
+            print(f"error: {problem}", file=sys.stderr)
+        return 1
+
+    source = render(table)
+    if args.check:
+        with open(OUTPUT) as file:
+            if file.read() != source:
+                print(f"error: {OUTPUT} is out of date", file=sys.stderr)
+                return 1
+        print(f"{OUTPUT} is up to date")
+        return 0
+
+    with open(OUTPUT, "w") as file:
+        file.write(source)
+    print(f"wrote {OUTPUT} ({len(table)} entries)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
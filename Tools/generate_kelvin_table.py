@@ -0,0 +1,251 @@
+#!/usr/bin/env python3
+"""
+Generates a colour temperature table from the Planckian locus.
+
+Each entry is the RGB colour of a black body at one temperature. The
+black body spectrum (Planck's law) is integrated against the CIE 1931 2°
+colour matching functions to give XYZ, which is converted to RGB with a
+matrix built from the chromaticities of the three primaries and the white
+point. The colour matching functions use the multi-lobe Gaussian fit of
+Wyman, Sloan and Shirley (2013), which is within the spread of the
+tabulated data and needs no data file.
+
+Negative (out of gamut) channels are clipped to zero and each colour is
+normalised so its largest channel is full scale, matching kelvin_table in
+Core/Src/kelvin_to_rgb.c. By default the values are sRGB encoded like that
+table; --linear keeps them proportional to light output, which is what the
+BLANK duty of an LED channel is.
+
+The default primaries are sRGB. For our LEDs pass their measured
+chromaticities, e.g.:
+
+    python3 Tools/generate_kelvin_table.py \\
+        --primaries 0.700,0.295,0.170,0.700,0.135,0.050 --linear
+
+The table is written to stdout (or --output) as a const C array, either
+in the KelvinToRGB layout or packed as uint8_t/uint16_t triples:
+
+    python3 Tools/generate_kelvin_table.py --min 1000 --max 8000 --step 100
+
+--compare checks the generated colours against kelvin_table and reports
+the largest difference per channel; with --tolerance it fails if any
+difference is larger.
+"""
+
+import argparse
+import math
+import re
+import sys
+
+KELVIN_SOURCE = "Core/Src/kelvin_to_rgb.c"
+SRGB_PRIMARIES = (0.64, 0.33, 0.30, 0.60, 0.15, 0.06)
+D65_WHITE = (0.3127, 0.3290)
+WAVELENGTH_START = 360  # nm
+WAVELENGTH_END = 830    # nm
+WAVELENGTH_STEP = 1     # nm
+PLANCK_C2 = 1.4387769e-2  # Second radiation constant in m K.
+ENTRIES_PER_LINE = 4
+
+
+def lobe(wavelength, mean, lower_width, upper_width):
+    """Piecewise Gaussian with different widths either side of the mean."""
+    width = lower_width if wavelength < mean else upper_width
+    return math.exp(-0.5 * ((wavelength - mean) / width) ** 2)
+
+
+def colour_matching(wavelength):
+    """CIE 1931 2° x, y and z bar at a wavelength in nm (multi-lobe fit)."""
+    x = (1.056 * lobe(wavelength, 599.8, 37.9, 31.0)
+         + 0.362 * lobe(wavelength, 442.0, 16.0, 26.7)
+         - 0.065 * lobe(wavelength, 501.1, 20.4, 26.2))
+    y = (0.821 * lobe(wavelength, 568.8, 46.9, 40.5)
+         + 0.286 * lobe(wavelength, 530.9, 16.3, 31.1))
+    z = (1.217 * lobe(wavelength, 437.0, 11.8, 36.0)
+         + 0.681 * lobe(wavelength, 459.0, 26.0, 13.8))
+    return x, y, z
+
+
+def black_body(wavelength, kelvin):
+    """Relative spectral radiance of a black body (constant factor dropped)."""
+    metres = wavelength * 1e-9
+    return 1.0 / (metres ** 5 * math.expm1(PLANCK_C2 / (metres * kelvin)))
+
+
+def kelvin_to_xyz(kelvin):
+    """XYZ of a black body, normalised to Y = 1."""
+    total = [0.0, 0.0, 0.0]
+    for wavelength in range(WAVELENGTH_START, WAVELENGTH_END + 1,
+                            WAVELENGTH_STEP):
+        power = black_body(wavelength, kelvin)
+        for i, value in enumerate(colour_matching(wavelength)):
+            total[i] += power * value
+    return [value / total[1] for value in total]
+
+
+def xy_to_xyz(x, y):
+    return [x / y, 1.0, (1.0 - x - y) / y]
+
+
+def solve(matrix, vector):
+    """Solves matrix * result = vector for a 3x3 matrix (Cramer's rule)."""
+    def determinant(m):
+        return (m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+                - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+                + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]))
+    whole = determinant(matrix)
+    result = []
+    for column in range(3):
+        replaced = [row[:] for row in matrix]
+        for row in range(3):
+            replaced[row][column] = vector[row]
+        result.append(determinant(replaced) / whole)
+    return result
+
+
+def xyz_to_rgb_matrix(primaries, white):
+    """Inverse of the RGB -> XYZ matrix for the given chromaticities."""
+    columns = [xy_to_xyz(primaries[i], primaries[i + 1]) for i in (0, 2, 4)]
+    to_xyz = [[columns[c][r] for c in range(3)] for r in range(3)]
+    scale = solve(to_xyz, xy_to_xyz(*white))
+    to_xyz = [[to_xyz[r][c] * scale[c] for c in range(3)] for r in range(3)]
+    unit = ([1.0, 0.0, 0.0], [0.0, 1.0, 0.0], [0.0, 0.0, 1.0])
+    inverse_columns = [solve(to_xyz, e) for e in unit]
+    return [[inverse_columns[c][r] for c in range(3)] for r in range(3)]
+
+
+def srgb_encode(value):
+    if value <= 0.0031308:
+        return 12.92 * value
+    return 1.055 * value ** (1.0 / 2.4) - 0.055
+
+
+def kelvin_to_rgb(kelvin, matrix, linear):
+    """RGB (0-1, largest channel 1) of a black body."""
+    xyz = kelvin_to_xyz(kelvin)
+    rgb = [max(0.0, sum(matrix[r][c] * xyz[c] for c in range(3)))
+           for r in range(3)]
+    peak = max(rgb)
+    rgb = [value / peak for value in rgb]
+    if not linear:
+        rgb = [srgb_encode(value) for value in rgb]
+    return rgb
+
+
+def build_table(args):
+    matrix = xyz_to_rgb_matrix(args.primaries, args.white)
+    full_scale = (1 << args.bits) - 1
+    table = []
+    for kelvin in range(args.min, args.max + 1, args.step):
+        rgb = kelvin_to_rgb(kelvin, matrix, args.linear)
+        table.append((kelvin, [round(value * full_scale) for value in rgb]))
+    return table
+
+
+def render(table, args):
+    if args.layout == "struct":
+        lines = [f"const KelvinToRGB {args.name}[] = {{"]
+        entries = [f"{{ {kelvin}, {r}, {g}, {b} }}"
+                   for kelvin, (r, g, b) in table]
+    else:
+        kind = "uint8_t" if args.bits <= 8 else "uint16_t"
+        lines = [f"/* {args.min} K to {args.max} K in {args.step} K steps. */",
+                 f"const {kind} {args.name}[][3] = {{"]
+        entries = [f"{{ {r}, {g}, {b} }}" for _, (r, g, b) in table]
+    for start in range(0, len(entries), ENTRIES_PER_LINE):
+        lines.append("\t\t" + ", ".join(entries[start:start + ENTRIES_PER_LINE])
+                     + ",")
+    lines[-1] = lines[-1].rstrip(",")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def read_kelvin_table():
+    """The live (uncommented) kelvin_table entries in KELVIN_SOURCE."""
+    with open(KELVIN_SOURCE) as file:
+        source = file.read()
+    body = source[source.index("KelvinToRGB kelvin_table[] ="):]
+    body = body[:body.index(";")]
+    entries = re.findall(r"\{\s*(\d+),\s*(\d+),\s*(\d+),\s*(\d+)\s*\}", body)
+    return {int(k): [int(r), int(g), int(b)] for k, r, g, b in entries}
+
+
+def compare(table, args):
+    """Prints the largest difference per channel; returns 1 if too large."""
+    current = read_kelvin_table()
+    scale = 255 / ((1 << args.bits) - 1)
+    worst = [(0, None)] * 3
+    for kelvin, rgb in table:
+        if kelvin not in current:
+            continue
+        for channel in range(3):
+            difference = abs(rgb[channel] * scale - current[kelvin][channel])
+            if difference > worst[channel][0]:
+                worst[channel] = (difference, kelvin)
+    for name, (difference, kelvin) in zip("RGB", worst):
+        where = f" at {kelvin} K" if kelvin is not None else ""
+        print(f"{name}: max difference {difference:.1f}/255{where}")
+    if args.tolerance is not None and \
+            any(difference > args.tolerance for difference, _ in worst):
+        print(f"error: difference exceeds {args.tolerance}", file=sys.stderr)
+        return 1
+    return 0
+
+
+def numbers(count):
+    def parse(text):
+        values = tuple(float(value) for value in text.split(","))
+        if len(values) != count:
+            raise argparse.ArgumentTypeError(f"expected {count} values")
+        return values
+    return parse
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("--min", type=int, default=1000,
+                        help="first temperature in K (default 1000)")
+    parser.add_argument("--max", type=int, default=8000,
+                        help="last temperature in K (default 8000)")
+    parser.add_argument("--step", type=int, default=100,
+                        help="temperature step in K (default 100)")
+    parser.add_argument("--primaries", type=numbers(6),
+                        default=SRGB_PRIMARIES,
+                        help="xr,yr,xg,yg,xb,yb chromaticities (default sRGB)")
+    parser.add_argument("--white", type=numbers(2), default=D65_WHITE,
+                        help="x,y of the white point (default D65)")
+    parser.add_argument("--linear", action="store_true",
+                        help="emit linear light values instead of sRGB")
+    parser.add_argument("--bits", type=int, default=8, choices=range(1, 17),
+                        metavar="{1..16}", help="bits per channel (default 8)")
+    parser.add_argument("--layout", choices=("struct", "packed"),
+                        default="struct",
+                        help="KelvinToRGB entries or packed triples")
+    parser.add_argument("--name", default="kelvin_table",
+                        help="name of the emitted array")
+    parser.add_argument("--output", help="file to write (default stdout)")
+    parser.add_argument("--compare", action="store_true",
+                        help=f"compare against kelvin_table in {KELVIN_SOURCE}")
+    parser.add_argument("--tolerance", type=float,
+                        help="largest allowed --compare difference (of 255)")
+    args = parser.parse_args()
+
+    if args.min <= 0 or args.max < args.min or args.step <= 0:
+        print("error: need 0 < min <= max and step > 0", file=sys.stderr)
+        return 1
+
+    table = build_table(args)
+    if args.compare:
+        return compare(table, args)
+
+    source = render(table, args)
+    if args.output:
+        with open(args.output, "w") as file:
+            file.write(source)
+        print(f"wrote {args.output} ({len(table)} entries)", file=sys.stderr)
+    else:
+        sys.stdout.write(source)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,158 @@
+/**
+ *******************************************************************************
+ * @file host_hal.c
+ * @brief Fake peripherals and HAL functions for the host tests.
+ *
+ * The HAL calls succeed without doing anything, except where a test needs to
+ * see their effect on the fake registers: a TIM3 DMA burst writes its buffer
+ * to CCR1 to CCR3 straight away (as if the update event had happened), and a
+ * generated update event resets the counter.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "stm32f3xx_hal.h"
+#include "host_test.h"
+
+GPIO_TypeDef host_gpioa;
+GPIO_TypeDef host_gpiob;
+TIM_TypeDef host_tim2;
+TIM_TypeDef host_tim3;
+TIM_TypeDef host_tim4;
+TIM_TypeDef host_tim6;
+TIM_TypeDef host_tim15;
+DMA_Channel_TypeDef host_dma1_channels[7];
+TIM_HandleTypeDef htim3;
+TIM_HandleTypeDef htim15;
+uint32_t SystemCoreClock = 16000000;
+uint32_t host_primask = 0;
+uint32_t host_tick = 0;
+int host_failures = 0;
+
+void Error_Handler(void) {
+	printf("Error_Handler() called\n");
+	exit(1);
+}
+
+uint32_t HAL_GetTick(void) {
+	return host_tick;
+}
+
+void HAL_Delay(uint32_t delay) {
+	host_tick += delay;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type irqn, uint32_t preempt, uint32_t sub) {
+	(void) irqn;
+	(void) preempt;
+	(void) sub;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type irqn) {
+	(void) irqn;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type irqn) {
+	(void) irqn;
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma) {
+	(void) hdma;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t src,
+		uint32_t dst, uint32_t length) {
+	(void) hdma;
+	(void) src;
+	(void) dst;
+	(void) length;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t src,
+		uint32_t dst, uint32_t length) {
+	return HAL_DMA_Start(hdma, src, dst, length);
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma) {
+	(void) hdma;
+	return HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma) {
+	(void) hdma;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim) {
+	htim->Instance->PSC = htim->Init.Prescaler;
+	htim->Instance->ARR = htim->Init.Period;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim) {
+	htim->Instance->DIER |= TIM_IT_UPDATE;
+	htim->Instance->CR1 |= 1;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim) {
+	htim->Instance->DIER &= ~(uint32_t) TIM_IT_UPDATE;
+	htim->Instance->CR1 &= ~1U;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_OC_ConfigChannel(TIM_HandleTypeDef *htim,
+		TIM_OC_InitTypeDef *config, uint32_t channel) {
+	__HAL_TIM_SET_COMPARE(htim, channel, config->Pulse);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim,
+		TIM_OC_InitTypeDef *config, uint32_t channel) {
+	return HAL_TIM_OC_ConfigChannel(htim, config, channel);
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim,
+		TIM_MasterConfigTypeDef *config) {
+	(void) htim;
+	(void) config;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_SlaveConfigSynchro(TIM_HandleTypeDef *htim,
+		TIM_SlaveConfigTypeDef *config) {
+	(void) htim;
+	(void) config;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_DMABurst_WriteStart(TIM_HandleTypeDef *htim,
+		uint32_t base, uint32_t source, const uint32_t *buffer,
+		uint32_t length) {
+	(void) base;
+	(void) source;
+	(void) length;
+	htim->Instance->CCR1 = buffer[0];
+	htim->Instance->CCR2 = buffer[1];
+	htim->Instance->CCR3 = buffer[2];
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_DMABurst_WriteStop(TIM_HandleTypeDef *htim,
+		uint32_t source) {
+	(void) htim;
+	(void) source;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_GenerateEvent(TIM_HandleTypeDef *htim,
+		uint32_t source) {
+	(void) source;
+	htim->Instance->CNT = 0;
+	return HAL_OK;
+}
@@ -0,0 +1,66 @@
+/**
+ *******************************************************************************
+ * @file host_test.h
+ * @brief Checks shared by the host tests.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+extern int host_failures;
+extern uint32_t host_tick;
+
+/**
+ * @brief Records a failure (and prints where) if a condition is false.
+ *
+ * Tests keep going after a failure so one run shows all of them.
+ */
+#define CHECK(condition, ...) \
+	do { \
+		if (!(condition)) { \
+			host_failures++; \
+			printf("%s:%d: FAILED: ", __FILE__, __LINE__); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+		} \
+	} while (0)
+
+/**
+ * @brief Prints the outcome of a test program.
+ *
+ * @param name: Name of the test.
+ *
+ * @return The exit status (0 if every check passed).
+ */
+static inline int finish_test(const char *name) {
+	if (host_failures) {
+		printf("%s: %d check(s) FAILED\n", name, host_failures);
+		return 1;
+	}
+	printf("%s: passed\n", name);
+	return 0;
+}
+
+/**
+ * @brief Reads a monotonic clock for the host benchmarks.
+ *
+ * Host timings only compare two versions on the same machine; the target has
+ * no double FPU, so the gap there is larger.
+ *
+ * @return The time in ns.
+ */
+static inline uint64_t host_time_ns(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+#endif /* HOST_TEST_H */
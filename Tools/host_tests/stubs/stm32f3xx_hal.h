@@ -0,0 +1,319 @@
+/**
+ *******************************************************************************
+ * @file stm32f3xx_hal.h
+ * @brief Host stand-in for the STM32F3 HAL used by the host tests.
+ *
+ * Only what the firmware modules under test use is declared. Peripherals are
+ * plain structs in host memory (see host_hal.c), so register writes can be
+ * read back by the tests. The timers used here are all 16 bits wide, and the
+ * fake registers are too, so a value that does not fit wraps as it would on
+ * the target.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#ifndef HOST_STM32F3XX_HAL_H
+#define HOST_STM32F3XX_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Status and pin types ------------------------------------------------------*/
+
+typedef enum {
+	HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef enum {
+	GPIO_PIN_RESET, GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef enum {
+	EXTI9_5_IRQn, EXTI15_10_IRQn, TIM3_IRQn, TIM6_DAC_IRQn,
+	DMA1_Channel3_IRQn, DMA1_Channel7_IRQn
+} IRQn_Type;
+
+#define GPIO_PIN_0 ((uint16_t) 0x0001)
+#define GPIO_PIN_1 ((uint16_t) 0x0002)
+#define GPIO_PIN_2 ((uint16_t) 0x0004)
+#define GPIO_PIN_3 ((uint16_t) 0x0008)
+#define GPIO_PIN_4 ((uint16_t) 0x0010)
+#define GPIO_PIN_5 ((uint16_t) 0x0020)
+#define GPIO_PIN_6 ((uint16_t) 0x0040)
+#define GPIO_PIN_7 ((uint16_t) 0x0080)
+#define GPIO_PIN_8 ((uint16_t) 0x0100)
+#define GPIO_PIN_9 ((uint16_t) 0x0200)
+#define GPIO_PIN_10 ((uint16_t) 0x0400)
+#define GPIO_PIN_11 ((uint16_t) 0x0800)
+#define GPIO_PIN_12 ((uint16_t) 0x1000)
+#define GPIO_PIN_13 ((uint16_t) 0x2000)
+#define GPIO_PIN_14 ((uint16_t) 0x4000)
+#define GPIO_PIN_15 ((uint16_t) 0x8000)
+
+/* Fake peripherals ----------------------------------------------------------*/
+
+typedef struct {
+	volatile uint32_t IDR;
+	volatile uint32_t ODR;
+	volatile uint32_t BSRR;
+} GPIO_TypeDef;
+
+typedef struct {
+	volatile uint32_t CR1;
+	volatile uint32_t DIER;
+	volatile uint32_t SR;
+	volatile uint16_t CNT;
+	volatile uint16_t PSC;
+	volatile uint16_t ARR;
+	volatile uint16_t CCR1;
+	volatile uint16_t CCR2;
+	volatile uint16_t CCR3;
+	volatile uint16_t CCR4;
+} TIM_TypeDef;
+
+typedef struct {
+	volatile uint32_t CCR;
+} DMA_Channel_TypeDef;
+
+extern GPIO_TypeDef host_gpioa;
+extern GPIO_TypeDef host_gpiob;
+extern TIM_TypeDef host_tim2;
+extern TIM_TypeDef host_tim3;
+extern TIM_TypeDef host_tim4;
+extern TIM_TypeDef host_tim6;
+extern TIM_TypeDef host_tim15;
+extern DMA_Channel_TypeDef host_dma1_channels[7];
+extern uint32_t SystemCoreClock;
+
+#define GPIOA (&host_gpioa)
+#define GPIOB (&host_gpiob)
+#define TIM2 (&host_tim2)
+#define TIM3 (&host_tim3)
+#define TIM4 (&host_tim4)
+#define TIM6 (&host_tim6)
+#define TIM15 (&host_tim15)
+#define DMA1_Channel1 (&host_dma1_channels[0])
+#define DMA1_Channel3 (&host_dma1_channels[2])
+#define DMA1_Channel4 (&host_dma1_channels[3])
+#define DMA1_Channel5 (&host_dma1_channels[4])
+#define DMA1_Channel7 (&host_dma1_channels[6])
+
+/* Handles -------------------------------------------------------------------*/
+
+typedef struct {
+	uint32_t Direction;
+	uint32_t PeriphInc;
+	uint32_t MemInc;
+	uint32_t PeriphDataAlignment;
+	uint32_t MemDataAlignment;
+	uint32_t Mode;
+	uint32_t Priority;
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef {
+	DMA_Channel_TypeDef *Instance;
+	DMA_InitTypeDef Init;
+	void *Parent;
+	void (*XferCpltCallback)(struct __DMA_HandleTypeDef *hdma);
+} DMA_HandleTypeDef;
+
+typedef struct {
+	uint32_t Prescaler;
+	uint32_t CounterMode;
+	uint32_t Period;
+	uint32_t ClockDivision;
+	uint32_t RepetitionCounter;
+	uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+	TIM_TypeDef *Instance;
+	TIM_Base_InitTypeDef Init;
+	DMA_HandleTypeDef *hdma[7];
+} TIM_HandleTypeDef;
+
+typedef struct {
+	uint32_t OCMode;
+	uint32_t Pulse;
+	uint32_t OCPolarity;
+	uint32_t OCNPolarity;
+	uint32_t OCFastMode;
+	uint32_t OCIdleState;
+	uint32_t OCNIdleState;
+} TIM_OC_InitTypeDef;
+
+typedef struct {
+	uint32_t MasterOutputTrigger;
+	uint32_t MasterOutputTrigger2;
+	uint32_t MasterSlaveMode;
+} TIM_MasterConfigTypeDef;
+
+typedef struct {
+	uint32_t SlaveMode;
+	uint32_t InputTrigger;
+	uint32_t TriggerPolarity;
+	uint32_t TriggerPrescaler;
+	uint32_t TriggerFilter;
+} TIM_SlaveConfigTypeDef;
+
+typedef struct __ADC_HandleTypeDef ADC_HandleTypeDef;
+typedef struct __I2C_HandleTypeDef I2C_HandleTypeDef;
+
+/* Constants (values only need to be distinct) -------------------------------*/
+
+#define DMA_MEMORY_TO_PERIPH 0
+#define DMA_PERIPH_TO_MEMORY 1
+#define DMA_PINC_DISABLE 0
+#define DMA_MINC_ENABLE 1
+#define DMA_PDATAALIGN_HALFWORD 1
+#define DMA_PDATAALIGN_WORD 2
+#define DMA_MDATAALIGN_HALFWORD 1
+#define DMA_MDATAALIGN_WORD 2
+#define DMA_NORMAL 0
+#define DMA_PRIORITY_MEDIUM 1
+#define DMA_PRIORITY_HIGH 2
+#define DMA_FLAG_TC7 (1 << 25)
+
+#define TIM_CHANNEL_1 0x0
+#define TIM_CHANNEL_2 0x4
+#define TIM_CHANNEL_3 0x8
+#define TIM_CHANNEL_4 0xC
+#define TIM_COUNTERMODE_UP 0
+#define TIM_CLOCKDIVISION_DIV1 0
+#define TIM_AUTORELOAD_PRELOAD_DISABLE 0
+#define TIM_AUTORELOAD_PRELOAD_ENABLE 1
+#define TIM_OCMODE_TIMING 0
+#define TIM_OCMODE_PWM1 6
+#define TIM_OCMODE_PWM2 7
+#define TIM_OCPOLARITY_HIGH 0
+#define TIM_OCFAST_DISABLE 0
+#define TIM_TRGO_UPDATE 2
+#define TIM_TRGO_OC2REF 5
+#define TIM_MASTERSLAVEMODE_DISABLE 0
+#define TIM_SLAVEMODE_RESET 4
+#define TIM_TS_ITR1 1
+#define TIM_DMABASE_CCR1 13
+#define TIM_DMABURSTLENGTH_3TRANSFERS 2
+#define TIM_EVENTSOURCE_UPDATE 1
+
+#define TIM_FLAG_UPDATE (1 << 0)
+#define TIM_FLAG_CC1 (1 << 1)
+#define TIM_FLAG_CC2 (1 << 2)
+#define TIM_FLAG_CC3 (1 << 3)
+#define TIM_IT_UPDATE (1 << 0)
+#define TIM_DMA_UPDATE (1 << 8)
+#define TIM_DMA_CC1 (1 << 9)
+#define TIM_DMA_CC2 (1 << 10)
+#define TIM_DMA_CC3 (1 << 11)
+#define TIM_DMA_ID_UPDATE 0
+
+/* Register macros -----------------------------------------------------------*/
+
+#define __HAL_LINKDMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__) \
+	do { \
+		(__HANDLE__)->__PPP_DMA_FIELD__ = &(__DMA_HANDLE__); \
+		(__DMA_HANDLE__).Parent = (__HANDLE__); \
+	} while (0)
+
+#define __HAL_DMA_GET_FLAG(__HANDLE__, __FLAG__) \
+	(((__HANDLE__)->Instance->CCR & (__FLAG__)) != 0)
+
+#define __HAL_RCC_DMA1_CLK_ENABLE() do { } while (0)
+#define __HAL_RCC_TIM4_CLK_ENABLE() do { } while (0)
+#define __HAL_RCC_TIM6_CLK_ENABLE() do { } while (0)
+
+#define __HAL_TIM_ENABLE(__HANDLE__) ((__HANDLE__)->Instance->CR1 |= 1)
+#define __HAL_TIM_DISABLE(__HANDLE__) ((__HANDLE__)->Instance->CR1 &= ~1U)
+#define __HAL_TIM_ENABLE_IT(__HANDLE__, __IT__) \
+	((__HANDLE__)->Instance->DIER |= (__IT__))
+#define __HAL_TIM_ENABLE_DMA(__HANDLE__, __DMA__) \
+	((__HANDLE__)->Instance->DIER |= (__DMA__))
+#define __HAL_TIM_DISABLE_DMA(__HANDLE__, __DMA__) \
+	((__HANDLE__)->Instance->DIER &= ~(uint32_t) (__DMA__))
+#define __HAL_TIM_CLEAR_FLAG(__HANDLE__, __FLAG__) \
+	((__HANDLE__)->Instance->SR &= ~(uint32_t) (__FLAG__))
+#define __HAL_TIM_SET_COUNTER(__HANDLE__, __COUNTER__) \
+	((__HANDLE__)->Instance->CNT = (__COUNTER__))
+#define __HAL_TIM_GET_COUNTER(__HANDLE__) ((__HANDLE__)->Instance->CNT)
+#define __HAL_TIM_SET_PRESCALER(__HANDLE__, __PRESC__) \
+	((__HANDLE__)->Instance->PSC = (__PRESC__))
+#define __HAL_TIM_SET_AUTORELOAD(__HANDLE__, __AUTORELOAD__) \
+	do { \
+		(__HANDLE__)->Instance->ARR = (__AUTORELOAD__); \
+		(__HANDLE__)->Init.Period = (__AUTORELOAD__); \
+	} while (0)
+#define __HAL_TIM_GET_AUTORELOAD(__HANDLE__) ((__HANDLE__)->Instance->ARR)
+#define __HAL_TIM_SET_COMPARE(__HANDLE__, __CHANNEL__, __COMPARE__) \
+	(((__CHANNEL__) == TIM_CHANNEL_1) ? \
+			((__HANDLE__)->Instance->CCR1 = (__COMPARE__)) : \
+	((__CHANNEL__) == TIM_CHANNEL_2) ? \
+			((__HANDLE__)->Instance->CCR2 = (__COMPARE__)) : \
+	((__CHANNEL__) == TIM_CHANNEL_3) ? \
+			((__HANDLE__)->Instance->CCR3 = (__COMPARE__)) : \
+			((__HANDLE__)->Instance->CCR4 = (__COMPARE__)))
+#define __HAL_TIM_GET_COMPARE(__HANDLE__, __CHANNEL__) \
+	(((__CHANNEL__) == TIM_CHANNEL_1) ? ((__HANDLE__)->Instance->CCR1) : \
+	((__CHANNEL__) == TIM_CHANNEL_2) ? ((__HANDLE__)->Instance->CCR2) : \
+	((__CHANNEL__) == TIM_CHANNEL_3) ? ((__HANDLE__)->Instance->CCR3) : \
+			((__HANDLE__)->Instance->CCR4))
+
+/* Core intrinsics -----------------------------------------------------------*/
+
+extern uint32_t host_primask;
+
+static inline uint32_t __get_PRIMASK(void) {
+	return host_primask;
+}
+
+static inline void __set_PRIMASK(uint32_t primask) {
+	host_primask = primask;
+}
+
+static inline void __disable_irq(void) {
+	host_primask = 1;
+}
+
+static inline void __enable_irq(void) {
+	host_primask = 0;
+}
+
+#define __CLZ (uint8_t) __builtin_clz
+
+/* HAL functions (host_hal.c) ------------------------------------------------*/
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay);
+void HAL_NVIC_SetPriority(IRQn_Type irqn, uint32_t preempt, uint32_t sub);
+void HAL_NVIC_EnableIRQ(IRQn_Type irqn);
+void HAL_NVIC_DisableIRQ(IRQn_Type irqn);
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t src,
+		uint32_t dst, uint32_t length);
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t src,
+		uint32_t dst, uint32_t length);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_OC_ConfigChannel(TIM_HandleTypeDef *htim,
+		TIM_OC_InitTypeDef *config, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim,
+		TIM_OC_InitTypeDef *config, uint32_t channel);
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim,
+		TIM_MasterConfigTypeDef *config);
+HAL_StatusTypeDef HAL_TIM_SlaveConfigSynchro(TIM_HandleTypeDef *htim,
+		TIM_SlaveConfigTypeDef *config);
+HAL_StatusTypeDef HAL_TIM_DMABurst_WriteStart(TIM_HandleTypeDef *htim,
+		uint32_t base, uint32_t source, const uint32_t *buffer,
+		uint32_t length);
+HAL_StatusTypeDef HAL_TIM_DMABurst_WriteStop(TIM_HandleTypeDef *htim,
+		uint32_t source);
+HAL_StatusTypeDef HAL_TIM_GenerateEvent(TIM_HandleTypeDef *htim,
+		uint32_t source);
+
+#endif /* HOST_STM32F3XX_HAL_H */
@@ -0,0 +1,180 @@
+/**
+ *******************************************************************************
+ * @file test_animation.c
+ * @brief Host check of the keyframe animation queue against a virtual clock.
+ *
+ * advance_animation() is stepped through queued sequences, and the pulse
+ * values are checked either side of every keyframe boundary. The runs
+ * cover an empty queue, empty sequences, zero-duration keyframes (never
+ * shown), late ticks that skip whole keyframes and a clock that wraps.
+ * Boundaries must fall at the sum of the durations whatever the tick times.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "host_test.h"
+#include "globals.h"
+#include "LED_animation.h"
+#include "LED_framebuffer.h"
+#include "LED_pwm.h"
+
+#define HALF (ANIMATION_LEVEL_FULL / 2)
+#define LIVE ANIMATION_LEVEL_LIVE
+
+/* LED_animation.c lays its output over the framebuffer, which is not built. */
+void framebuffer_set_overlay(uint32_t *pulse_values) {
+}
+
+LED_Driver_Status flush_framebuffer(void) {
+	return LED_DRIVER_OK;
+}
+
+static const AnimationKeyframe first_keyframes[] = {
+		{ { ANIMATION_LEVEL_FULL, ANIMATION_LEVEL_OFF, HALF }, 100 },
+		{ { ANIMATION_LEVEL_OFF, ANIMATION_LEVEL_FULL, ANIMATION_LEVEL_OFF },
+				0 },
+		{ { LIVE, HALF, LIVE }, 50 } };
+static const AnimationKeyframe last_keyframes[] = {
+		{ { HALF, HALF, HALF }, 20 },
+		{ { ANIMATION_LEVEL_FULL, ANIMATION_LEVEL_FULL, ANIMATION_LEVEL_FULL },
+				0 } };
+static const AnimationKeyframe zero_keyframes[] = {
+		{ { ANIMATION_LEVEL_FULL, ANIMATION_LEVEL_FULL, ANIMATION_LEVEL_FULL },
+				0 } };
+
+static const AnimationSequence first = { first_keyframes, 3 };
+static const AnimationSequence empty = { NULL, 0 };
+static const AnimationSequence zero = { zero_keyframes, 1 };
+static const AnimationSequence last = { last_keyframes, 2 };
+
+/**
+ * @brief The pulse value a keyframe level should show as.
+ *
+ * @param level: Q15 on-time, or ANIMATION_LEVEL_LIVE.
+ *
+ * @return The Q8 pulse value, or FRAMEBUFFER_NO_OVERLAY.
+ */
+static uint32_t expected_pulse(uint16_t level) {
+	if (level == LIVE) {
+		return FRAMEBUFFER_NO_OVERLAY;
+	}
+	return PULSE_TO_Q8(COUNTER_PERIOD)
+			- (uint32_t) ((uint64_t) PULSE_TO_Q8(COUNTER_PERIOD) * level
+					/ ANIMATION_LEVEL_FULL);
+}
+
+/**
+ * @brief Advances to a time and checks the keyframe shown (or none).
+ *
+ * @param now: The virtual time in ms.
+ * @param keyframe: The keyframe expected, NULL if the queue should be done.
+ *
+ * @return None.
+ */
+static void check_at(uint32_t now, const AnimationKeyframe *keyframe) {
+	uint32_t pulses[3] = { 1, 2, 3 };
+	uint8_t showing = advance_animation(now, pulses);
+
+	if (keyframe == NULL) {
+		CHECK(!showing, "%u ms: still showing an animation", now);
+		CHECK(pulses[0] == 1 && pulses[1] == 2 && pulses[2] == 3,
+				"%u ms: pulses written with no animation", now);
+		CHECK(!animation_running(), "%u ms: animation_running() after the end",
+				now);
+		return;
+	}
+	CHECK(showing, "%u ms: no animation showing", now);
+	for (int colour = 0; colour < 3; colour++) {
+		uint32_t expected = expected_pulse(keyframe->levels[colour]);
+		CHECK(pulses[colour] == expected, "%u ms colour %d: pulse %u, "
+				"expected %u", now, colour, pulses[colour], expected);
+	}
+}
+
+/* Nothing queued: nothing shown and the pulses left alone. */
+static void test_empty_queue(void) {
+	CHECK(!animation_running(), "animation_running() with an empty queue");
+	check_at(0, NULL);
+	check_at(12345, NULL);
+
+	/* Queues holding only empty or zero-length sequences show nothing. */
+	play_animation(&empty);
+	play_animation(&zero);
+	CHECK(animation_running(), "queued sequences not running");
+	check_at(500, NULL);
+}
+
+/* Ticks at and either side of every boundary, starting at start. */
+static void test_boundaries(uint32_t start) {
+	play_animation(&first);
+	play_animation(&empty);
+	play_animation(&zero);
+	play_animation(&last);
+
+	check_at(start, &first_keyframes[0]);
+	check_at(start + 1, &first_keyframes[0]);
+	check_at(start + 99, &first_keyframes[0]);
+	/* The zero-duration keyframe is stepped over at its own boundary. */
+	check_at(start + 100, &first_keyframes[2]);
+	check_at(start + 149, &first_keyframes[2]);
+	/* The empty and zero sequences are skipped; last starts at 150 ms. */
+	check_at(start + 150, &last_keyframes[0]);
+	check_at(start + 169, &last_keyframes[0]);
+	/* last ends with a zero-duration keyframe, so it ends at 170 ms. */
+	check_at(start + 170, NULL);
+	check_at(start + 171, NULL);
+}
+
+/* A late tick skips whole keyframes but keeps later boundaries in place. */
+static void test_late_ticks(uint32_t start) {
+	play_animation(&first);
+	play_animation(&last);
+
+	/* A queue starts at the tick that first sees it. */
+	check_at(start, &first_keyframes[0]);
+	check_at(start + 160, &last_keyframes[0]);
+	check_at(start + 169, &last_keyframes[0]);
+	check_at(start + 170, NULL);
+
+	/* One tick past the whole queue ends it. */
+	play_animation(&first);
+	play_animation(&last);
+	check_at(start + 1000, &first_keyframes[0]);
+	check_at(start + 5000, NULL);
+}
+
+/* The queue holds one sequence fewer than its length. */
+static void test_queue_full(void) {
+	for (int i = 0; i < ANIMATION_QUEUE_LENGTH - 1; i++) {
+		CHECK(play_animation(&last), "sequence %d not queued", i);
+	}
+	CHECK(!play_animation(&last), "sequence queued past a full queue");
+
+	uint32_t now = 0;
+	for (int i = 0; i < ANIMATION_QUEUE_LENGTH - 1; i++) {
+		check_at(now, &last_keyframes[0]);
+		now += 20;
+	}
+	check_at(now, NULL);
+}
+
+int main(void) {
+	htim3.Instance = TIM3;
+	htim15.Instance = TIM15;
+	initialise_pwm_commit();
+
+	test_empty_queue();
+	test_boundaries(1000);
+	/* The same, with the HAL tick wrapping part way through. */
+	test_boundaries(UINT32_MAX - 120);
+	test_late_ticks(2000);
+	test_queue_full();
+
+	set_pwm_profile(PWM_PROFILE_16_BIT);
+	test_boundaries(3000);
+	return finish_test("test_animation");
+}
@@ -0,0 +1,314 @@
+/**
+ *******************************************************************************
+ * @file test_bcm_duty.c
+ * @brief Host simulation of the BCM engine against the BLANK PWM.
+ *
+ * TIM6 updates are stepped by hand: at each one the preloaded ARR is taken as
+ * the length of the next slot and advance_bcm_plane() is run as the ISR. The
+ * frames it queues are latched a shift frame later, and each LED's on-time is
+ * integrated against red's BLANK waveform (PWM mode 1 on a free-running TIM3)
+ * over a whole BCM cycle. It must come to exactly level / BCM_MAX_LEVEL of
+ * what the BLANK PWM alone gives, for any phase between the two timers.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "LED_bcm.h"
+#include "LED_pwm.h"
+#include "LED_shift_engine.h"
+#include "LED_driver_config.h"
+
+static uint16_t latched_next[3];	///< Words of the last queued frame.
+static int frames_queued = 0;
+static int busy_updates = 0;		///< Queues to refuse before accepting.
+
+ShiftEngineStatus queue_shift_frame(uint16_t red_mask, uint16_t green_mask,
+		uint16_t blue_mask, ShiftCompleteCallback callback) {
+	if (busy_updates) {
+		busy_updates--;
+		return SHIFT_ENGINE_BUSY;
+	}
+	latched_next[0] = red_mask;
+	latched_next[1] = green_mask;
+	latched_next[2] = blue_mask;
+	frames_queued++;
+	return SHIFT_ENGINE_OK;
+}
+
+void wait_for_shift_engine(void) {
+}
+
+void invalidate_LED_masks(void) {
+}
+
+/**
+ * @brief Counts the TIM3 counts in [0, time) with BLANK low (LED lit).
+ *
+ * @param time: End of the window in TIM3 counts from its last reset.
+ * @param pulse: Red pulse value (BLANK high below it).
+ * @param length: Counts per PWM period (period + 1).
+ *
+ * @return The lit counts.
+ */
+static uint64_t lit_counts(uint64_t time, uint32_t pulse, uint32_t length) {
+	uint64_t partial = time % length;
+	return (time / length) * (length - pulse)
+			+ ((partial > pulse) ? partial - pulse : 0);
+}
+
+/**
+ * @brief Runs one BCM cycle and integrates each LED's lit time.
+ *
+ * @param levels: Level of each LED per colour.
+ * @param pulse: BLANK pulse value.
+ * @param phase: TIM3 count at the first TIM6 update.
+ * @param latency: Counts from a TIM6 update to its frame being latched.
+ * @param busy_at: Update at which the shift engine is busy, or -1.
+ * @param lit: Filled with the lit counts of each LED over the cycle.
+ *
+ * @return The length of the cycle in counts.
+ */
+static uint64_t simulate_cycle(uint8_t levels[3][NUM_LEDS], uint32_t pulse,
+		uint32_t phase, uint32_t latency, int busy_at,
+		uint64_t lit[3][NUM_LEDS]) {
+	uint32_t length = (uint32_t) COUNTER_PERIOD + 1;
+	uint16_t latched[3] = { 0 };
+	uint64_t first_latch = 0;
+	uint64_t last_latch = 0;
+	uint64_t time = phase;
+
+	stop_bcm();
+	set_bcm_levels(levels);
+	frames_queued = 0;
+	busy_updates = 0;
+	memset(lit, 0, sizeof(uint64_t) * 3 * NUM_LEDS);
+	if (start_bcm() != BCM_OK) {
+		CHECK(0, "start_bcm() failed");
+		return 0;
+	}
+	CHECK(host_tim6.PSC == active_pwm_profile->prescaler,
+			"TIM6 prescaler %u, TIM3 %u", host_tim6.PSC,
+			active_pwm_profile->prescaler);
+
+	/* The cycle runs from the plane 0 latch to the next plane 0 latch. */
+	for (int update = 0; frames_queued <= BCM_BITS; update++) {
+		uint32_t slot = (uint32_t) host_tim6.ARR + 1;	/* Loaded now. */
+		int queued = frames_queued;
+		busy_updates = (update == busy_at);
+		advance_bcm_plane();
+
+		if (frames_queued != queued) {
+			uint64_t latch = time + latency;
+			if (queued == 0) {
+				first_latch = latch;
+			} else {
+				uint64_t on = lit_counts(latch, pulse, length)
+						- lit_counts(last_latch, pulse, length);
+				for (int chain = 0; chain < 3; chain++) {
+					for (int led = 0; led < NUM_LEDS; led++) {
+						if ((latched[chain] >> led) & 1) {
+							lit[chain][led] += on;
+						}
+					}
+				}
+			}
+			memcpy(latched, latched_next, sizeof(latched));
+			last_latch = latch;
+		}
+		time += slot;
+	}
+	return last_latch - first_latch;
+}
+
+static void random_levels(uint8_t levels[3][NUM_LEDS]) {
+	for (int chain = 0; chain < 3; chain++) {
+		for (int led = 0; led < NUM_LEDS; led++) {
+			levels[chain][led] = rand() % (BCM_MAX_LEVEL + 1);
+		}
+	}
+	levels[0][0] = 0;
+	levels[0][1] = BCM_MAX_LEVEL;
+}
+
+static void test_profiles(void) {
+	CHECK(bcm_profile_supported(&pwm_profiles[BCM_PWM_PROFILE]),
+			"BCM_PWM_PROFILE cannot run BCM");
+	CHECK(bcm_profile_supported(&pwm_profiles[PWM_PROFILE_FAST]),
+			"the fast profile should run BCM");
+	CHECK(bcm_profile_supported(&pwm_profiles[PWM_PROFILE_12_BIT]),
+			"the 12-bit profile should run BCM");
+	CHECK(!bcm_profile_supported(&pwm_profiles[PWM_PROFILE_STANDARD]),
+			"the standard profile cycles below BCM_MIN_CYCLE_RATE");
+	CHECK(!bcm_profile_supported(&pwm_profiles[PWM_PROFILE_16_BIT]),
+			"the 16-bit profile overflows TIM6");
+
+	set_pwm_profile(PWM_PROFILE_STANDARD);
+	stop_bcm();
+	CHECK(start_bcm() == BCM_PROFILE_UNSUPPORTED && !bcm_running(),
+			"BCM started under an unsupported profile");
+}
+
+/* Every LED's on-time must be exactly its share of the BLANK on-time. */
+static void test_duty(PwmProfileId profile) {
+	static uint64_t lit[3][NUM_LEDS];
+	uint8_t levels[3][NUM_LEDS];
+
+	set_pwm_profile(profile);
+	uint32_t length = (uint32_t) COUNTER_PERIOD + 1;
+	uint32_t shift_counts = SHIFT_FRAME_LENGTH * (SHIFT_TIMER_PRESCALER + 1)
+			* (SHIFT_TIMER_PERIOD + 1) / (active_pwm_profile->prescaler + 1);
+
+	for (int trial = 0; trial < 200; trial++) {
+		uint32_t pulse = rand() % length;
+		uint32_t phase = rand() % length;
+		random_levels(levels);
+
+		uint64_t cycle = simulate_cycle(levels, pulse, phase, shift_counts, -1,
+				lit);
+		CHECK(cycle == (uint64_t) BCM_MAX_LEVEL * BCM_BASE_PERIODS * length,
+				"profile %d: cycle of %llu counts", profile,
+				(unsigned long long) cycle);
+		for (int chain = 0; chain < 3; chain++) {
+			for (int led = 0; led < NUM_LEDS; led++) {
+				uint64_t expected = (uint64_t) levels[chain][led]
+						* BCM_BASE_PERIODS * (length - pulse);
+				CHECK(lit[chain][led] == expected,
+						"profile %d, pulse %u, phase %u: level %u lit %llu "
+						"counts, expected %llu", profile, pulse, phase,
+						levels[chain][led], (unsigned long long) lit[chain][led],
+						(unsigned long long) expected);
+			}
+		}
+	}
+}
+
+/* A busy shift engine delays the plane by a slot instead of losing it. */
+static void test_busy_retry(void) {
+	static uint64_t lit[3][NUM_LEDS];
+	uint8_t levels[3][NUM_LEDS];
+
+	set_pwm_profile(BCM_PWM_PROFILE);
+	uint32_t length = (uint32_t) COUNTER_PERIOD + 1;
+	random_levels(levels);
+
+	for (int busy_at = 1; busy_at < BCM_BITS; busy_at++) {
+		uint32_t missed = get_bcm_missed_planes();
+		uint64_t cycle = simulate_cycle(levels, 0, 0, 0, busy_at, lit);
+		CHECK(get_bcm_missed_planes() == missed + 1, "missed plane not counted");
+
+		/* The plane before is shown for one extra slot of the retried one. */
+		uint64_t slot = (uint64_t) BCM_BASE_PERIODS * length << busy_at;
+		CHECK(cycle == (uint64_t) BCM_MAX_LEVEL * BCM_BASE_PERIODS * length
+				+ slot, "busy at %d: cycle of %llu counts", busy_at,
+				(unsigned long long) cycle);
+		for (int chain = 0; chain < 3; chain++) {
+			for (int led = 0; led < NUM_LEDS; led++) {
+				uint64_t expected = (uint64_t) levels[chain][led]
+						* BCM_BASE_PERIODS * length;
+				if ((levels[chain][led] >> (busy_at - 1)) & 1) {
+					expected += slot;
+				}
+				CHECK(lit[chain][led] == expected,
+						"busy at %d: level %u lit %llu counts, expected %llu",
+						busy_at, levels[chain][led],
+						(unsigned long long) lit[chain][led],
+						(unsigned long long) expected);
+			}
+		}
+	}
+}
+
+/* A hold waits for the cycle to end, latches every lit LED and stops TIM6. */
+static void test_hold(void) {
+	uint8_t levels[3][NUM_LEDS];
+	uint16_t lit[3] = { LED_MASK_NONE, LED_MASK_NONE, LED_MASK_NONE };
+	uint16_t masks[3];
+
+	set_pwm_profile(BCM_PWM_PROFILE);
+	random_levels(levels);
+	for (int chain = 0; chain < 3; chain++) {
+		for (int led = 0; led < NUM_LEDS; led++) {
+			if (levels[chain][led]) {
+				lit[chain] |= (1 << led);
+			}
+		}
+	}
+	stop_bcm();
+	set_bcm_levels(levels);
+	busy_updates = 0;
+	start_bcm();
+
+	advance_bcm_plane();
+	advance_bcm_plane();
+	hold_bcm();
+	frames_queued = 0;
+	for (int update = 0; (update < 2 * BCM_BITS) && (host_tim6.CR1 & 1);
+			update++) {
+		CHECK(!get_bcm_held_masks(masks), "held before the cycle ended");
+		advance_bcm_plane();
+	}
+	CHECK(frames_queued == BCM_BITS - 1, "held after %d frames, expected %d",
+			frames_queued, BCM_BITS - 1);
+	CHECK(!(host_tim6.CR1 & 1) && bcm_running(), "TIM6 not stopped by a hold");
+	CHECK(get_bcm_held_masks(masks) && !memcmp(masks, lit, sizeof(lit))
+			&& !memcmp(latched_next, lit, sizeof(lit)),
+			"the hold did not latch every lit LED");
+
+	/* New levels must not wait on the stopped ISR. */
+	set_bcm_levels(levels);
+	release_bcm();
+	CHECK(!get_bcm_held_masks(masks) && (host_tim6.CR1 & 1),
+			"TIM6 not restarted by a release");
+	advance_bcm_plane();
+	uint16_t planes[BCM_BITS][3];
+	build_bcm_planes(levels, planes);
+	CHECK(!memcmp(latched_next, planes[0], sizeof(latched_next)),
+			"the release did not restart at plane 0");
+	stop_bcm();
+}
+
+static void test_dot_correction_levels(void) {
+	uint8_t dot_correction[3][NUM_LEDS];
+	uint8_t levels[3][NUM_LEDS];
+
+	for (int chain = 0; chain < 3; chain++) {
+		for (int led = 0; led < NUM_LEDS; led++) {
+			dot_correction[chain][led] = led * DOT_CORRECTION_MAX
+					/ (NUM_LEDS - 1);
+		}
+	}
+	bcm_levels_from_dot_correction(dot_correction, LED_CHAIN_GREEN, levels);
+	CHECK(levels[1][0] == 0 && levels[1][NUM_LEDS - 1] == BCM_MAX_LEVEL,
+			"dot correction end points map to %u and %u", levels[1][0],
+			levels[1][NUM_LEDS - 1]);
+	for (int led = 0; led < NUM_LEDS; led++) {
+		CHECK(levels[0][led] == BCM_MAX_LEVEL
+				&& levels[2][led] == BCM_MAX_LEVEL,
+				"chain left out of the set was dimmed");
+		if (led > 0) {
+			CHECK(levels[1][led] >= levels[1][led - 1],
+					"levels not monotonic in the dot correction");
+		}
+	}
+}
+
+int main(void) {
+	srand(1);
+	htim3.Instance = TIM3;
+	htim15.Instance = TIM15;
+	initialise_bcm();
+
+	test_profiles();
+	test_duty(PWM_PROFILE_FAST);
+	test_duty(PWM_PROFILE_12_BIT);
+	test_busy_retry();
+	test_hold();
+	test_dot_correction_levels();
+	return finish_test("test_bcm_duty");
+}
@@ -0,0 +1,63 @@
+/**
+ *******************************************************************************
+ * @file test_brightness_table.c
+ * @brief Host check of the compiled CIE L* brightness table.
+ *
+ * Repeats the checks Tools/generate_brightness_table.py makes before writing
+ * the table, but against what was compiled. The table must fall
+ * monotonically from full scale (65535, the largest uint16_t) at pot 0 to
+ * zero at ADC_RES - 1. Every entry must be within half a step of that scale
+ * of the analytic luminance, which is what rounding can cost.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include "host_test.h"
+#include "globals.h"
+#include "brightness_table.h"
+
+/* As in Tools/generate_brightness_table.py. */
+#define Q16_ONE 65535
+#define MAX_ERROR (0.5 / Q16_ONE + 1e-12)
+
+/* Inverse of the CIE 1976 lightness function (L* 0-100 -> Y 0-1). */
+static double lightness_to_luminance(double lightness) {
+	if (lightness > 8.0) {
+		return pow((lightness + 16.0) / 116.0, 3);
+	}
+	return lightness / 903.3;
+}
+
+/* Luminance (0-1) the LEDs should have at a pot position. */
+static double relative_luminance(uint32_t pot) {
+	double lightness = 100.0 * (1.0 - (double) pot / (ADC_RES - 1));
+	return lightness_to_luminance(lightness);
+}
+
+int main(void) {
+	CHECK(brightness_table[0] == Q16_ONE, "brightness_table[0] is %u",
+			brightness_table[0]);
+	CHECK(brightness_table[ADC_RES - 1] == 0, "brightness_table[%d] is %u",
+			ADC_RES - 1, brightness_table[ADC_RES - 1]);
+
+	double max_error = 0.0;
+	for (uint32_t pot = 0; pot < ADC_RES; pot++) {
+		if (pot > 0) {
+			CHECK(brightness_table[pot] <= brightness_table[pot - 1],
+					"not monotonic at pot %u: %u after %u", pot,
+					brightness_table[pot], brightness_table[pot - 1]);
+		}
+		double error = fabs((double) brightness_table[pot] / Q16_ONE
+				- relative_luminance(pot));
+		CHECK(error <= MAX_ERROR, "pot %u: %u is %.3g from the curve", pot,
+				brightness_table[pot], error);
+		max_error = fmax(max_error, error);
+	}
+	printf("largest error %.3g (%.2f of a step)\n", max_error,
+			max_error * Q16_ONE);
+	return finish_test("test_brightness_table");
+}
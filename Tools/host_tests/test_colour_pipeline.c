@@ -0,0 +1,470 @@
+/**
+ *******************************************************************************
+ * @file test_colour_pipeline.c
+ * @brief Golden-output check and benchmark of calculate_pulse_values().
+ *
+ * The calibration modes and STANDBY still show the same colours as the
+ * pipeline before it moved to Q16 fixed point, so they are checked against
+ * that code (kept below as it was). The old pipeline truncated to whole
+ * counts, so the new Q8 output must be at or above it by at most a count.
+ *
+ * WHITE_LIGHT and RGB_LIGHT have since taken their colours from the mired
+ * spaced white table, the OkLCh hue wheel and the constant luminance gains,
+ * so the same steps are modelled in double and the fixed-point output must
+ * stay within COLOUR_TOLERANCE Q16 steps of the on-time.
+ *
+ * Every mode is swept over pot 2 at both brightness end points and between,
+ * under every PWM profile. Full brightness must give exactly the colour
+ * (brightness_table holds 65535 for it) and the dimmest setting fully off.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "globals.h"
+#include "colour_control.h"
+#include "luminance_balance.h"
+#include "kelvin_to_rgb.h"
+#include "brightness_table.h"
+#include "hue_table.h"
+#include "LED_pwm.h"
+
+/* Error allowed against the double model, in Q16 steps of the on-time. */
+#define COLOUR_TOLERANCE 4
+
+/* As in colour_control.c. */
+#define WHITE_TABLE_STEP_BITS (ADC_RES_BITS - WHITE_TABLE_BITS)
+#define HUE_TABLE_STEP_BITS (ADC_RES_BITS - HUE_TABLE_BITS)
+#define MIRED_SCALE 16000000UL
+
+#define BENCH_CALLS 200000
+
+volatile uint16_t pot1_moving_average = 0;
+volatile uint16_t pot2_moving_average = 0;
+volatile uint16_t pot3_moving_average = 0;
+State current_state = STANDBY;
+PotCalibrationSubstate pot_cal_substate = POT_CALIBRATION_START;
+uint32_t brightness_calibration_buffer[1 + (NUM_CAL_INCS + 1) + 1][2];
+uint32_t white_calibration_buffer[1 + (NUM_CAL_INCS + 1) + 1][2];
+uint32_t colour_calibration_buffer[1 + NUM_CAL_INCS + 1][2];
+
+static const char *const profile_names[NUM_PWM_PROFILES] = { "standard",
+		"fast", "12-bit", "16-bit" };
+
+/*
+ * The pipeline before the move to Q16 fixed point, for the golden output and
+ * the benchmark.
+ */
+
+static void old_apply_brightness(uint16_t *pulse_counts,
+		uint32_t *pulse_values) {
+	uint32_t gain = brightness_table[pot1_moving_average];
+	for (int colour = 0; colour < 3; colour++) {
+		uint32_t on_time = COUNTER_PERIOD - pulse_counts[colour];
+		pulse_values[colour] = PULSE_TO_Q8(COUNTER_PERIOD)
+				- ((on_time * gain)
+						>> (BRIGHTNESS_TABLE_SHIFT - PWM_FRACTION_BITS));
+	}
+}
+
+static void old_calculate_pulse_counts(uint16_t *pulse_values) {
+	switch (current_state) {
+	case STANDBY:
+		break;
+
+	case WHITE_LIGHT: {
+		uint32_t min_kelvin = kelvin_table[0].kelvin;
+		uint32_t max_kelvin = kelvin_table[KELVIN_TABLE_LENGTH - 1].kelvin;
+		uint32_t kelvin_range = max_kelvin - min_kelvin;
+		uint32_t kelvin = max_kelvin
+				- (uint32_t) ((uint64_t) pot2_moving_average * kelvin_range
+						/ ADC_RES);
+		kelvin = (uint16_t) kelvin;
+
+		KelvinToRGB lower;
+		KelvinToRGB higher;
+		uint16_t weight = search_rgb_to_kelvin(kelvin, &lower, &higher);
+		pulse_for_kelvin(weight, &lower, &higher, pulse_values);
+		break;
+	}
+
+	case RGB_LIGHT: {
+		uint32_t colour = (ADC_RES - 1) - pot2_moving_average;
+		uint32_t segment_length = ADC_RES / 6;
+		uint32_t segment = colour / segment_length;
+		uint32_t segment_position = colour % segment_length;
+		uint32_t value = (COUNTER_PERIOD * segment_position) / segment_length;
+
+		switch (segment) {
+		case 0:
+			pulse_values[0] = COUNTER_PERIOD;
+			pulse_values[1] = value;
+			pulse_values[2] = 0;
+			break;
+		case 1:
+			pulse_values[0] = (COUNTER_PERIOD - value);
+			pulse_values[1] = COUNTER_PERIOD;
+			pulse_values[2] = 0;
+			break;
+		case 2:
+			pulse_values[0] = 0;
+			pulse_values[1] = COUNTER_PERIOD;
+			pulse_values[2] = value;
+			break;
+		case 3:
+			pulse_values[0] = 0;
+			pulse_values[1] = (COUNTER_PERIOD - value);
+			pulse_values[2] = COUNTER_PERIOD;
+			break;
+		case 4:
+			pulse_values[0] = value;
+			pulse_values[1] = 0;
+			pulse_values[2] = COUNTER_PERIOD;
+			break;
+		case 5:
+			pulse_values[0] = COUNTER_PERIOD;
+			pulse_values[1] = 0;
+			pulse_values[2] = (COUNTER_PERIOD - value);
+			break;
+		case 6:
+			pulse_values[0] = COUNTER_PERIOD;
+			pulse_values[1] = 0;
+			pulse_values[2] = 0;
+		}
+
+		pulse_values[0] = COUNTER_PERIOD - pulse_values[0];
+		pulse_values[1] = COUNTER_PERIOD - pulse_values[1];
+		pulse_values[2] = COUNTER_PERIOD - pulse_values[2];
+		break;
+	}
+
+	case POT_CALIBRATION:
+		if ((pot_cal_substate == POT_1_LOWER)
+				|| (pot_cal_substate == POT_1_UPPER)) {
+			pulse_values[0] = (pot1_moving_average * COUNTER_PERIOD / ADC_RES);
+			pulse_values[1] = COUNTER_PERIOD;
+			pulse_values[2] = COUNTER_PERIOD;
+		} else if ((pot_cal_substate == POT_2_LOWER)
+				|| (pot_cal_substate == POT_2_UPPER)) {
+			pulse_values[0] = COUNTER_PERIOD;
+			pulse_values[1] = (pot2_moving_average * COUNTER_PERIOD / ADC_RES);
+			pulse_values[2] = COUNTER_PERIOD;
+		} else if ((pot_cal_substate == POT_3_LOWER)
+				|| (pot_cal_substate == POT_3_UPPER)) {
+			pulse_values[0] = COUNTER_PERIOD;
+			pulse_values[1] = COUNTER_PERIOD;
+			pulse_values[2] = (pot3_moving_average * COUNTER_PERIOD / ADC_RES);
+		} else {
+			pulse_values[0] = (pot1_moving_average * COUNTER_PERIOD / ADC_RES);
+			pulse_values[1] = (pot1_moving_average * COUNTER_PERIOD / ADC_RES);
+			pulse_values[2] = (pot1_moving_average * COUNTER_PERIOD / ADC_RES);
+		}
+		break;
+
+	case LED_CALIBRATION:
+		pulse_values[0] = (pot1_moving_average * COUNTER_PERIOD / ADC_RES);
+		pulse_values[1] = (pot2_moving_average * COUNTER_PERIOD / ADC_RES);
+		pulse_values[2] = (pot3_moving_average * COUNTER_PERIOD / ADC_RES);
+		break;
+	}
+}
+
+static void old_calculate_pulse_values(uint32_t *pulse_values) {
+	if (current_state == STANDBY) {
+		pulse_values[0] = PULSE_TO_Q8(PWM_PULSE_OFF);
+		pulse_values[1] = PULSE_TO_Q8(PWM_PULSE_OFF);
+		pulse_values[2] = PULSE_TO_Q8(PWM_PULSE_OFF);
+		return;
+	}
+
+	uint16_t pulse_counts[3] = { 0 };
+	old_calculate_pulse_counts(pulse_counts);
+
+	if ((current_state == WHITE_LIGHT) || (current_state == RGB_LIGHT)) {
+		old_apply_brightness(pulse_counts, pulse_values);
+	} else {
+		pulse_values[0] = PULSE_TO_Q8(pulse_counts[0]);
+		pulse_values[1] = PULSE_TO_Q8(pulse_counts[1]);
+		pulse_values[2] = PULSE_TO_Q8(pulse_counts[2]);
+	}
+}
+
+/*
+ * The current WHITE_LIGHT and RGB_LIGHT steps in double.
+ */
+
+static double model_white_table[WHITE_TABLE_LENGTH][3];
+#ifdef CONSTANT_LUMINANCE
+static double model_white_gains[WHITE_TABLE_LENGTH];
+static double model_hue_gains[WHITE_TABLE_LENGTH];
+#endif /* CONSTANT_LUMINANCE */
+
+static void model_balance(double colour[3]) {
+	for (int channel = 0; channel < 3; channel++) {
+		colour[channel] *= (double) luminance_gains[channel]
+				/ LUMINANCE_GAIN_ONE;
+	}
+}
+
+static void model_hue(uint32_t position, double colour[3]) {
+	uint32_t index = position >> HUE_TABLE_STEP_BITS;
+	double fraction = (double) (position & ((1 << HUE_TABLE_STEP_BITS) - 1))
+			/ (1 << HUE_TABLE_STEP_BITS);
+	double saturation = (double) HUE_SATURATION / COLOUR_ONE;
+	for (int channel = 0; channel < 3; channel++) {
+		double below = hue_table[index][channel];
+		double above = hue_table[index + 1][channel];
+		double pure = (below + (above - below) * fraction) / COLOUR_ONE;
+		colour[channel] = 1.0 - (1.0 - pure) * saturation;
+	}
+}
+
+static void model_interpolate(double table[][3], uint32_t pot_value,
+		double colour[3]) {
+	uint32_t index = pot_value >> WHITE_TABLE_STEP_BITS;
+	double fraction = (double) (pot_value & ((1 << WHITE_TABLE_STEP_BITS) - 1))
+			/ (1 << WHITE_TABLE_STEP_BITS);
+	for (int channel = 0; channel < 3; channel++) {
+		colour[channel] = table[index][channel]
+				+ (table[index + 1][channel] - table[index][channel]) * fraction;
+	}
+}
+
+#ifdef CONSTANT_LUMINANCE
+static double model_entry_luminance(uint8_t hue, uint32_t index) {
+	double colour[3];
+	if (hue) {
+		uint32_t pot_value = index << WHITE_TABLE_STEP_BITS;
+		pot_value = (pot_value < ADC_RES) ? pot_value : ADC_RES - 1;
+		model_hue((ADC_RES - 1) - pot_value, colour);
+	} else {
+		for (int channel = 0; channel < 3; channel++) {
+			colour[channel] = model_white_table[index][channel];
+		}
+	}
+	model_balance(colour);
+
+	double luminance = 0.0;
+	for (int channel = 0; channel < 3; channel++) {
+		luminance += (double) luminance_weights[channel]
+				/ (1UL << LUMINANCE_WEIGHT_SHIFT) * colour[channel];
+	}
+	return luminance;
+}
+
+static void model_gains(uint8_t hue, double *gains) {
+	double dimmest = INFINITY;
+	double brightest = 0.0;
+	for (uint32_t i = 0; i < WHITE_TABLE_LENGTH; i++) {
+		double luminance = model_entry_luminance(hue, i);
+		dimmest = fmin(dimmest, luminance);
+		brightest = fmax(brightest, luminance);
+	}
+	double target = fmax(dimmest,
+			brightest * CONSTANT_LUMINANCE_MIN_GAIN / COLOUR_ONE);
+	for (uint32_t i = 0; i < WHITE_TABLE_LENGTH; i++) {
+		double luminance = model_entry_luminance(hue, i);
+		gains[i] = (luminance <= target) ? 1.0 : target / luminance;
+	}
+}
+
+static double model_gain(const double *gains) {
+	uint32_t index = pot2_moving_average >> WHITE_TABLE_STEP_BITS;
+	double fraction = (double) (pot2_moving_average
+			& ((1 << WHITE_TABLE_STEP_BITS) - 1)) / (1 << WHITE_TABLE_STEP_BITS);
+	return gains[index] + (gains[index + 1] - gains[index]) * fraction;
+}
+#endif /* CONSTANT_LUMINANCE */
+
+static void build_model(void) {
+	uint32_t min_mired = MIRED_SCALE
+			/ kelvin_table[KELVIN_TABLE_LENGTH - 1].kelvin;
+	uint32_t max_mired = MIRED_SCALE / kelvin_table[0].kelvin;
+
+	for (uint32_t i = 0; i < WHITE_TABLE_LENGTH; i++) {
+		uint32_t pot_value = i << WHITE_TABLE_STEP_BITS;
+		uint32_t mired = min_mired
+				+ ((pot_value * (max_mired - min_mired)) >> ADC_RES_BITS);
+		uint32_t kelvin = (MIRED_SCALE + mired / 2) / mired;
+
+		KelvinToRGB lower;
+		KelvinToRGB higher;
+		uint32_t rgb_values[3];
+		uint16_t weight = search_rgb_to_kelvin(kelvin, &lower, &higher);
+		rgb_for_kelvin(weight, &lower, &higher, rgb_values);
+		for (int channel = 0; channel < 3; channel++) {
+			model_white_table[i][channel] = rgb_values[channel] / 256.0;
+		}
+	}
+#ifdef CONSTANT_LUMINANCE
+	model_gains(0, model_white_gains);
+	model_gains(1, model_hue_gains);
+#endif /* CONSTANT_LUMINANCE */
+}
+
+/* On-time fraction (0 to 1) of each colour in WHITE_LIGHT or RGB_LIGHT. */
+static void model_on_times(double on_times[3]) {
+	double gain = brightness_table[pot1_moving_average] / 65535.0;
+	if (current_state == WHITE_LIGHT) {
+		model_interpolate(model_white_table, pot2_moving_average, on_times);
+#ifdef CONSTANT_LUMINANCE
+		gain *= model_gain(model_white_gains);
+#endif /* CONSTANT_LUMINANCE */
+	} else {
+		model_hue((ADC_RES - 1) - pot2_moving_average, on_times);
+#ifdef CONSTANT_LUMINANCE
+		gain *= model_gain(model_hue_gains);
+#endif /* CONSTANT_LUMINANCE */
+	}
+	model_balance(on_times);
+	for (int channel = 0; channel < 3; channel++) {
+		on_times[channel] *= gain;
+	}
+}
+
+/*
+ * Checks.
+ */
+
+static double worst_error = 0.0;	///< Largest error seen, in Q16 steps.
+
+static void check_lit_mode(const char *profile) {
+	static const uint16_t brightness[] = { 0, 1, 2, ADC_RES / 4, ADC_RES / 2,
+			3 * ADC_RES / 4, ADC_RES - 2, ADC_RES - 1 };
+	static const State states[] = { WHITE_LIGHT, RGB_LIGHT };
+	double step = PULSE_TO_Q8(COUNTER_PERIOD) / (double) COLOUR_ONE;
+
+	for (unsigned s = 0; s < 2; s++) {
+		current_state = states[s];
+		for (unsigned b = 0; b < sizeof(brightness) / sizeof(brightness[0]);
+				b++) {
+			pot1_moving_average = brightness[b];
+			for (uint32_t pot = 0; pot < ADC_RES; pot++) {
+				uint32_t pulses[3];
+				double on_times[3];
+				pot2_moving_average = pot;
+				calculate_pulse_values(pulses);
+				model_on_times(on_times);
+
+				for (int channel = 0; channel < 3; channel++) {
+					double expected = PULSE_TO_Q8(COUNTER_PERIOD)
+							* (1.0 - on_times[channel]);
+					double error = fabs(pulses[channel] - expected) / step;
+					worst_error = fmax(worst_error, error);
+					CHECK(error <= COLOUR_TOLERANCE,
+							"%s state %d pots %u/%u: colour %d pulse %u, "
+							"expected %.1f", profile, current_state,
+							pot1_moving_average, pot, channel, pulses[channel],
+							expected);
+					if (pot1_moving_average == ADC_RES - 1) {
+						CHECK(pulses[channel] == PULSE_TO_Q8(COUNTER_PERIOD),
+								"%s: dimmest setting not fully off", profile);
+					}
+				}
+			}
+		}
+	}
+}
+
+static void check_calibration_modes(const char *profile) {
+	static const PotCalibrationSubstate substates[] = { POT_CALIBRATION_START,
+			POT_1_LOWER, POT_1_UPPER, POT_2_LOWER, POT_2_UPPER, POT_3_LOWER,
+			POT_3_UPPER };
+	static const State states[] = { STANDBY, LED_CALIBRATION,
+			POT_CALIBRATION };
+
+	for (unsigned s = 0; s < sizeof(states) / sizeof(states[0]); s++) {
+		current_state = states[s];
+		for (unsigned c = 0; c < sizeof(substates) / sizeof(substates[0]);
+				c++) {
+			pot_cal_substate = substates[c];
+			for (uint32_t pot = 0; pot < ADC_RES; pot++) {
+				uint32_t pulses[3];
+				uint32_t old_pulses[3];
+				pot1_moving_average = pot;
+				pot2_moving_average = (ADC_RES - 1) - pot;
+				pot3_moving_average = (pot * 7) % ADC_RES;
+				calculate_pulse_values(pulses);
+				old_calculate_pulse_values(old_pulses);
+
+				for (int channel = 0; channel < 3; channel++) {
+					CHECK((pulses[channel] >= old_pulses[channel])
+							&& (pulses[channel] - old_pulses[channel]
+									<= PULSE_TO_Q8(1)),
+							"%s state %d substate %d pot %u: colour %d pulse "
+							"%u, old pipeline %u", profile, current_state,
+							pot_cal_substate, pot, channel, pulses[channel],
+							old_pulses[channel]);
+				}
+			}
+		}
+	}
+}
+
+/* Full brightness must be exactly unity gain, the dimmest exactly zero. */
+static void check_brightness_end_points(void) {
+	CHECK(brightness_table[0] == 65535, "brightness_table[0] is %u",
+			brightness_table[0]);
+	CHECK(brightness_gain(0) == COLOUR_ONE,
+			"full brightness gain %u, not COLOUR_ONE", brightness_gain(0));
+	CHECK(brightness_gain(ADC_RES - 1) == 0, "dimmest brightness gain %u",
+			brightness_gain(ADC_RES - 1));
+	for (uint32_t pot = 1; pot < ADC_RES; pot++) {
+		CHECK(brightness_gain(pot) <= brightness_gain(pot - 1),
+				"brightness gain rises at pot %u", pot);
+	}
+}
+
+static double bench(void (*pipeline)(uint32_t*), State state) {
+	volatile uint32_t sink = 0;
+	current_state = state;
+	pot_cal_substate = POT_CALIBRATION_START;
+	uint64_t start = host_time_ns();
+	for (uint32_t call = 0; call < BENCH_CALLS; call++) {
+		uint32_t pulses[3];
+		pot1_moving_average = (call * 13) & (ADC_RES - 1);
+		pot2_moving_average = (call * 7) & (ADC_RES - 1);
+		pipeline(pulses);
+		sink += pulses[0] + pulses[1] + pulses[2];
+	}
+	(void) sink;
+	return (double) (host_time_ns() - start) / BENCH_CALLS;
+}
+
+static void benchmark(void) {
+	static const State states[] = { WHITE_LIGHT, RGB_LIGHT, LED_CALIBRATION };
+	static const char *const names[] = { "white", "rgb", "calibration" };
+
+	set_pwm_profile(PWM_PROFILE_STANDARD);
+	for (unsigned s = 0; s < sizeof(states) / sizeof(states[0]); s++) {
+		double fixed = bench(calculate_pulse_values, states[s]);
+		double old = bench(old_calculate_pulse_values, states[s]);
+		printf("calculate_pulse_values %s: fixed %.1f ns, old %.1f ns "
+				"(%.2fx)\n", names[s], fixed, old, fixed / old);
+	}
+}
+
+int main(void) {
+	htim3.Instance = TIM3;
+	htim15.Instance = TIM15;
+	initialise_pwm_commit();
+	generate_white_table();
+	generate_gain_tables();
+	build_model();
+
+	check_brightness_end_points();
+	for (int profile = 0; profile < NUM_PWM_PROFILES; profile++) {
+		set_pwm_profile(profile);
+		check_lit_mode(profile_names[profile]);
+		check_calibration_modes(profile_names[profile]);
+	}
+	printf("lit modes: largest error %.2f Q16 steps of the on-time\n",
+			worst_error);
+	benchmark();
+	return finish_test("test_colour_pipeline");
+}
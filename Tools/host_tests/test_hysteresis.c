@@ -0,0 +1,128 @@
+/**
+ *******************************************************************************
+ * @file test_hysteresis.c
+ * @brief Host check and benchmark of the fixed point hysteresis thresholds.
+ *
+ * update_hysteresis_thresholds() is run for every pot 3 value and compared
+ * with the double log()/exp() formula it replaced. At or above 100 mlux the
+ * thresholds must be within 0.4% of it; below that within one count, which
+ * is the truncation to whole mlux both versions do.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "globals.h"
+#include "hysteresis.h"
+
+/* Constants of hysteresis.c. */
+#define MIN_LUX 1
+#define MAX_LUX 100000
+#define HYSTERESIS_PERCENT 20
+
+#define RELATIVE_TOLERANCE 0.004	///< Allowed error at or above 100 mlux.
+#define BENCHMARK_PASSES 200		///< Sweeps of every pot value per timing.
+
+volatile uint16_t pot3_moving_average = 0;
+volatile uint32_t mlux_reading = 0;
+State current_state = STANDBY;
+volatile EventType event_flag = NO_EVENT;
+
+/* The double version of update_hysteresis_thresholds(). */
+static void double_hysteresis_thresholds(uint16_t pot,
+		uint32_t *hysteresis_thresholds) {
+	double scale_factor = (log(MAX_LUX) - log(MIN_LUX)) / log(ADC_RES - 1);
+	double threshold = exp(log(MIN_LUX) + scale_factor * log(pot));
+	hysteresis_thresholds[0] = (uint32_t) threshold;
+	hysteresis_thresholds[1] = (uint32_t) (threshold
+			* (1 + HYSTERESIS_PERCENT / 100.0));
+}
+
+static void test_against_double(void) {
+	uint32_t previous[2] = { 0, 0 };
+	uint32_t max_difference = 0;
+	double max_relative = 0;
+
+	for (uint32_t pot = 1; pot < ADC_RES; pot++) {
+		uint32_t thresholds[2];
+		uint32_t reference[2];
+		pot3_moving_average = pot;
+		update_hysteresis_thresholds(thresholds);
+		double_hysteresis_thresholds(pot, reference);
+
+		for (int i = 0; i < 2; i++) {
+			uint32_t difference = abs((int32_t) thresholds[i]
+					- (int32_t) reference[i]);
+			double relative = (double) difference / reference[i];
+			max_difference = (difference > max_difference) ?
+					difference : max_difference;
+			if (reference[i] >= 100) {
+				max_relative = (relative > max_relative) ?
+						relative : max_relative;
+				CHECK(relative <= RELATIVE_TOLERANCE,
+						"pot %u threshold %d: %u mlux, double gives %u", pot,
+						i, thresholds[i], reference[i]);
+			} else {
+				CHECK(difference <= 1,
+						"pot %u threshold %d: %u mlux, double gives %u", pot,
+						i, thresholds[i], reference[i]);
+			}
+			CHECK(thresholds[i] >= previous[i],
+					"pot %u threshold %d falls to %u mlux", pot, i,
+					thresholds[i]);
+			previous[i] = thresholds[i];
+		}
+		CHECK(thresholds[1] >= thresholds[0], "pot %u: upper below lower",
+				pot);
+	}
+	printf("largest difference %u mlux, %.2f%% at or above 100 mlux\n",
+			max_difference, max_relative * 100);
+
+	pot3_moving_average = 0;
+	uint32_t thresholds[2] = { 1, 1 };
+	update_hysteresis_thresholds(thresholds);
+	CHECK(thresholds[0] == 0 && thresholds[1] == 0,
+			"pot 0 gives %u/%u mlux", thresholds[0], thresholds[1]);
+}
+
+static void benchmark(void) {
+	volatile uint32_t sink = 0;
+	uint32_t thresholds[2];
+
+	uint64_t start = host_time_ns();
+	for (int pass = 0; pass < BENCHMARK_PASSES; pass++) {
+		for (uint32_t pot = 1; pot < ADC_RES; pot++) {
+			pot3_moving_average = pot;
+			update_hysteresis_thresholds(thresholds);
+			sink += thresholds[0] + thresholds[1];
+		}
+	}
+	uint64_t fixed_ns = host_time_ns() - start;
+
+	start = host_time_ns();
+	for (int pass = 0; pass < BENCHMARK_PASSES; pass++) {
+		for (uint32_t pot = 1; pot < ADC_RES; pot++) {
+			pot3_moving_average = pot;
+			double_hysteresis_thresholds(pot3_moving_average, thresholds);
+			sink += thresholds[0] + thresholds[1];
+		}
+	}
+	uint64_t double_ns = host_time_ns() - start;
+
+	double updates = (double) BENCHMARK_PASSES * (ADC_RES - 1);
+	printf("threshold update: fixed %.1f ns, double %.1f ns (%.2fx)\n",
+			fixed_ns / updates, double_ns / updates,
+			(double) fixed_ns / double_ns);
+	(void) sink;
+}
+
+int main(void) {
+	test_against_double();
+	benchmark();
+	return finish_test("test_hysteresis");
+}
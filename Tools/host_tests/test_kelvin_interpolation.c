@@ -0,0 +1,169 @@
+/**
+ *******************************************************************************
+ * @file test_kelvin_interpolation.c
+ * @brief Host check and benchmark of the integer kelvin interpolation.
+ *
+ * rgb_for_kelvin() interpolates at the Q15 weight from search_rgb_to_kelvin(),
+ * so it must give exactly the weighted value rounded half up. Against the
+ * double and round() version it replaced, which worked from the kelvin value,
+ * it may differ by one count only where a half lies between the exact and
+ * the weighted value (the weight is at most 1/32768 low).
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "kelvin_to_rgb.h"
+
+#define BENCHMARK_PASSES 200	///< Sweeps of the whole range per timing.
+
+/* The double and round() version of rgb_for_kelvin() before it took a weight. */
+static void double_rgb_for_kelvin(uint32_t kelvin, KelvinToRGB *lower,
+		KelvinToRGB *higher, uint32_t *rgb_values) {
+	if ((kelvin != lower->kelvin) && (higher->kelvin != lower->kelvin)) {
+		double fraction = (double) (kelvin - lower->kelvin)
+				/ (higher->kelvin - lower->kelvin);
+		rgb_values[0] = round(lower->r + fraction * (higher->r - lower->r));
+		rgb_values[1] = round(lower->g + fraction * (higher->g - lower->g));
+		rgb_values[2] = round(lower->b + fraction * (higher->b - lower->b));
+	} else {
+		rgb_values[0] = lower->r;
+		rgb_values[1] = lower->g;
+		rgb_values[2] = lower->b;
+	}
+}
+
+/**
+ * @brief Checks one interpolation against both references.
+ *
+ * @param kelvin: The kelvin value, between the entries.
+ * @param weight: Its Q15 weight, as search_rgb_to_kelvin() returns it.
+ * @param lower: The entry at or below kelvin.
+ * @param higher: The entry above kelvin.
+ *
+ * @return Number of channels that differ from the kelvin reference.
+ */
+static int check_interpolation(uint32_t kelvin, uint16_t weight,
+		KelvinToRGB *lower, KelvinToRGB *higher) {
+	uint32_t rgb[3];
+	uint32_t reference[3];
+	rgb_for_kelvin(weight, lower, higher, rgb);
+	double_rgb_for_kelvin(kelvin, lower, higher, reference);
+
+	int32_t lows[3] = { lower->r, lower->g, lower->b };
+	int32_t highs[3] = { higher->r, higher->g, higher->b };
+	double span = higher->kelvin - lower->kelvin;
+	int differences = 0;
+	for (int channel = 0; channel < 3; channel++) {
+		/* The weighted value rounded half up, exactly as rgb_for_kelvin. */
+		double weighted = lows[channel]
+				+ (double) weight / (1 << KELVIN_WEIGHT_SHIFT)
+						* (highs[channel] - lows[channel]);
+		CHECK(rgb[channel] == (uint32_t) floor(weighted + 0.5),
+				"%u K channel %d: %u, weight %u gives %.4f", kelvin, channel,
+				rgb[channel], weight, weighted);
+
+		int32_t difference = (int32_t) rgb[channel] - reference[channel];
+		if (difference == 0) {
+			continue;
+		}
+		differences++;
+
+		/* The weight can only move a value across the half it sits near. */
+		double exact = (span == 0) ? lows[channel] :
+				lows[channel]
+						+ (kelvin - lower->kelvin) / span
+								* (highs[channel] - lows[channel]);
+		double half = fmin(rgb[channel], reference[channel]) + 0.5;
+		CHECK(abs(difference) == 1 && half >= fmin(exact, weighted)
+				&& half <= fmax(exact, weighted),
+				"%u K between %u and %u K channel %d: %u, double gives %u",
+				kelvin, lower->kelvin, higher->kelvin, channel, rgb[channel],
+				reference[channel]);
+	}
+	return differences;
+}
+
+/* Every kelvin across the table (and past its ends). */
+static void test_table_range(void) {
+	uint32_t first = kelvin_table[0].kelvin;
+	uint32_t last = kelvin_table[KELVIN_TABLE_LENGTH - 1].kelvin;
+	int differences = 0;
+
+	for (uint32_t kelvin = first - 100; kelvin <= last + 100; kelvin++) {
+		KelvinToRGB lower;
+		KelvinToRGB higher;
+		uint16_t weight = search_rgb_to_kelvin(kelvin, &lower, &higher);
+		differences += check_interpolation(kelvin, weight, &lower, &higher);
+	}
+	printf("table: %d channel(s) differ by one at a half\n", differences);
+}
+
+/* Arbitrary pairs, with the weight worked out as search_rgb_to_kelvin(). */
+static void test_arbitrary_pairs(void) {
+	int differences = 0;
+
+	for (int trial = 0; trial < 100000; trial++) {
+		KelvinToRGB lower = { 1000 + rand() % 7000, rand() % 256, rand() % 256,
+				rand() % 256 };
+		KelvinToRGB higher = { lower.kelvin + 1 + rand() % 2000, rand() % 256,
+				rand() % 256, rand() % 256 };
+		uint32_t kelvin = lower.kelvin + rand() % (higher.kelvin - lower.kelvin);
+		uint16_t weight = ((kelvin - lower.kelvin) << KELVIN_WEIGHT_SHIFT)
+				/ (higher.kelvin - lower.kelvin);
+		differences += check_interpolation(kelvin, weight, &lower, &higher);
+	}
+	printf("arbitrary pairs: %d channel(s) differ by one at a half\n",
+			differences);
+}
+
+static void benchmark(void) {
+	uint32_t first = kelvin_table[0].kelvin;
+	uint32_t last = kelvin_table[KELVIN_TABLE_LENGTH - 1].kelvin;
+	volatile uint32_t sink = 0;
+
+	uint64_t start = host_time_ns();
+	for (int pass = 0; pass < BENCHMARK_PASSES; pass++) {
+		for (uint32_t kelvin = first; kelvin <= last; kelvin++) {
+			KelvinToRGB lower;
+			KelvinToRGB higher;
+			uint32_t rgb[3];
+			uint16_t weight = search_rgb_to_kelvin(kelvin, &lower, &higher);
+			rgb_for_kelvin(weight, &lower, &higher, rgb);
+			sink += rgb[0] + rgb[1] + rgb[2];
+		}
+	}
+	uint64_t integer_ns = host_time_ns() - start;
+
+	start = host_time_ns();
+	for (int pass = 0; pass < BENCHMARK_PASSES; pass++) {
+		for (uint32_t kelvin = first; kelvin <= last; kelvin++) {
+			KelvinToRGB lower;
+			KelvinToRGB higher;
+			uint32_t rgb[3];
+			search_rgb_to_kelvin(kelvin, &lower, &higher);
+			double_rgb_for_kelvin(kelvin, &lower, &higher, rgb);
+			sink += rgb[0] + rgb[1] + rgb[2];
+		}
+	}
+	uint64_t double_ns = host_time_ns() - start;
+
+	double lookups = (double) BENCHMARK_PASSES * (last - first + 1);
+	printf("lookup + interpolation: integer %.1f ns, double %.1f ns "
+			"(%.2fx)\n", integer_ns / lookups, double_ns / lookups,
+			(double) integer_ns / double_ns);
+	(void) sink;
+}
+
+int main(void) {
+	srand(1);
+	test_table_range();
+	test_arbitrary_pairs();
+	benchmark();
+	return finish_test("test_kelvin_interpolation");
+}
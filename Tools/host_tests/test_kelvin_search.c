@@ -0,0 +1,106 @@
+/**
+ *******************************************************************************
+ * @file test_kelvin_search.c
+ * @brief Host check of search_rgb_to_kelvin() against the old linear scan.
+ *
+ * Every kelvin from 0 to past the end of the table is looked up and compared
+ * with the scan the function replaced, along with the Q15 weight. The Makefile
+ * builds this twice: with the table's KELVIN_TABLE_STEP (direct indexing) and
+ * with KELVIN_TABLE_STEP set to 0 (bisection).
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <stdint.h>
+#include "host_test.h"
+#include "kelvin_to_rgb.h"
+
+/**
+ * @brief The linear scan search_rgb_to_kelvin() used before direct indexing.
+ *
+ * The loop stops at the last entry instead of reading past the table for
+ * values above it; the result is the same.
+ *
+ * @param kelvin: The kelvin value to look up.
+ * @param lower: Filled with the entry at or below kelvin.
+ * @param higher: Filled with the entry above kelvin.
+ *
+ * @return None.
+ */
+static void scan_rgb_to_kelvin(uint32_t kelvin, KelvinToRGB *lower,
+		KelvinToRGB *higher) {
+	int i;
+	for (i = 0; i < KELVIN_TABLE_LENGTH - 1; i++) {
+		if (kelvin <= kelvin_table[i].kelvin) {
+			break;
+		}
+	}
+
+	if (kelvin == kelvin_table[i].kelvin || i == 0) {
+		*lower = kelvin_table[i];
+		*higher = kelvin_table[i];
+	} else if (kelvin > kelvin_table[KELVIN_TABLE_LENGTH - 1].kelvin) {
+		*lower = kelvin_table[KELVIN_TABLE_LENGTH - 1];
+		*higher = kelvin_table[KELVIN_TABLE_LENGTH - 1];
+	} else {
+		*lower = kelvin_table[i - 1];
+		*higher = kelvin_table[i];
+	}
+}
+
+static int same_entry(const KelvinToRGB *a, const KelvinToRGB *b) {
+	return (a->kelvin == b->kelvin) && (a->r == b->r) && (a->g == b->g)
+			&& (a->b == b->b);
+}
+
+/* Direct indexing is only right if every entry sits on the step. */
+static void test_table_step(void) {
+	for (int i = 1; i < KELVIN_TABLE_LENGTH; i++) {
+		CHECK(kelvin_table[i].kelvin > kelvin_table[i - 1].kelvin,
+				"kelvin_table not increasing at entry %d", i);
+#if KELVIN_TABLE_STEP
+		CHECK(kelvin_table[i].kelvin
+				== kelvin_table[0].kelvin + i * KELVIN_TABLE_STEP,
+				"entry %d is %u K, KELVIN_TABLE_STEP puts it at %u K", i,
+				kelvin_table[i].kelvin,
+				kelvin_table[0].kelvin + i * KELVIN_TABLE_STEP);
+#endif /* KELVIN_TABLE_STEP */
+	}
+}
+
+static void test_against_scan(void) {
+	uint32_t last = kelvin_table[KELVIN_TABLE_LENGTH - 1].kelvin;
+
+	for (uint32_t kelvin = 0; kelvin <= last + 1000; kelvin++) {
+		KelvinToRGB lower;
+		KelvinToRGB higher;
+		KelvinToRGB scan_lower;
+		KelvinToRGB scan_higher;
+		uint16_t weight = search_rgb_to_kelvin(kelvin, &lower, &higher);
+		scan_rgb_to_kelvin(kelvin, &scan_lower, &scan_higher);
+
+		CHECK(same_entry(&lower, &scan_lower)
+				&& same_entry(&higher, &scan_higher),
+				"%u K: found %u/%u K, the scan found %u/%u K", kelvin,
+				lower.kelvin, higher.kelvin, scan_lower.kelvin,
+				scan_higher.kelvin);
+
+		uint32_t span = higher.kelvin - lower.kelvin;
+		uint32_t expected = (span == 0) ? 0 :
+				((kelvin - lower.kelvin) << KELVIN_WEIGHT_SHIFT) / span;
+		CHECK(weight == expected, "%u K: weight %u, expected %u", kelvin,
+				weight, expected);
+	}
+}
+
+int main(void) {
+	test_table_step();
+	test_against_scan();
+#if KELVIN_TABLE_STEP
+	return finish_test("test_kelvin_search (direct)");
+#else
+	return finish_test("test_kelvin_search (bisection)");
+#endif /* KELVIN_TABLE_STEP */
+}
@@ -0,0 +1,87 @@
+/**
+ *******************************************************************************
+ * @file test_pwm_dither.c
+ * @brief Host check of the sigma-delta dither of Q8 pulse values.
+ *
+ * advance_pwm_dither() is run for a number of periods per target, from every
+ * starting accumulator, and the mean compare value is compared with the Q8
+ * target. Only PWM_DITHER_BITS of the fraction are resolved, so the mean must
+ * be within one LSB of that resolution (1 / 2^PWM_DITHER_BITS counts).
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "LED_pwm.h"
+
+#define DITHER_LSB (1 << (PWM_FRACTION_BITS - PWM_DITHER_BITS))	///< In Q8.
+#define PERIODS 1000	///< Periods averaged per target (not a whole cycle).
+
+/**
+ * @brief Dithers one target on all three colours and checks the mean.
+ *
+ * @param target: Q8 pulse value.
+ * @param start: Starting value of the accumulators.
+ *
+ * @return None.
+ */
+static void check_target(uint32_t target, uint8_t start) {
+	uint32_t targets[3] = { target, target, target };
+	uint8_t accumulators[3] = { start, start, start };
+	uint64_t sums[3] = { 0 };
+	uint32_t whole = target >> PWM_FRACTION_BITS;
+
+	for (int period = 0; period < PERIODS; period++) {
+		uint16_t outputs[3];
+		advance_pwm_dither(targets, accumulators, outputs);
+		for (int colour = 0; colour < 3; colour++) {
+			/* Only the two counts either side of the target may be used. */
+			CHECK((outputs[colour] == whole) || (outputs[colour] == whole + 1),
+					"target %u: period %d output %u", target, period,
+					outputs[colour]);
+			sums[colour] += outputs[colour];
+		}
+	}
+
+	for (int colour = 0; colour < 3; colour++) {
+		int64_t mean_q8 = (int64_t) ((sums[colour] << PWM_FRACTION_BITS)
+				/ PERIODS);
+		int64_t error = mean_q8 - (int64_t) target;
+		CHECK(llabs(error) <= DITHER_LSB,
+				"target %u from %u: mean %lld/256, off by %lld/256", target,
+				start, (long long) mean_q8, (long long) error);
+	}
+}
+
+int main(void) {
+	srand(1);
+
+	/* Every fraction at the bottom of the range, start and end of a count. */
+	for (uint32_t target = 0; target < PULSE_TO_Q8(4); target++) {
+		for (uint8_t start = 0; start < (1 << PWM_DITHER_BITS); start++) {
+			check_target(target, start);
+		}
+	}
+	for (int trial = 0; trial < 2000; trial++) {
+		uint32_t target = rand() % PULSE_TO_Q8(PWM_MAX_PERIOD);
+		check_target(target, rand() % (1 << PWM_DITHER_BITS));
+	}
+
+	/* Full on and off are never dithered. */
+	uint32_t targets[3] = { 0, PULSE_TO_Q8(PWM_MAX_PERIOD),
+			PULSE_TO_Q8(PWM_PULSE_OFF) };
+	uint8_t accumulators[3] = { 0 };
+	for (int period = 0; period < PERIODS; period++) {
+		uint16_t outputs[3];
+		advance_pwm_dither(targets, accumulators, outputs);
+		CHECK(outputs[0] == 0 && outputs[1] == PWM_MAX_PERIOD
+				&& outputs[2] == PWM_PULSE_OFF,
+				"end points dithered to %u, %u, %u", outputs[0], outputs[1],
+				outputs[2]);
+	}
+	return finish_test("test_pwm_dither");
+}
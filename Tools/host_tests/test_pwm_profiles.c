@@ -0,0 +1,220 @@
+/**
+ *******************************************************************************
+ * @file test_pwm_profiles.c
+ * @brief Host check of the pulse value paths under every PWM profile.
+ *
+ * Pulse values from calculate_pulse_values() and pulse_for_kelvin() are
+ * committed and stepped through the dither ISR, and the BLANK on-time of each
+ * colour is read from the compare registers the way the timers use them: red
+ * and green in PWM mode 1, blue in PWM mode 2. The fake TIM registers are 16
+ * bits wide, so a compare value that wraps on the target wraps here too.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "globals.h"
+#include "colour_control.h"
+#include "kelvin_to_rgb.h"
+#include "LED_pwm.h"
+
+/* Dither periods averaged per check (one full dither cycle). */
+#define DITHER_PERIODS (1 << PWM_DITHER_BITS)
+
+volatile uint16_t pot1_moving_average = 0;
+volatile uint16_t pot2_moving_average = 0;
+volatile uint16_t pot3_moving_average = 0;
+State current_state = STANDBY;
+PotCalibrationSubstate pot_cal_substate = POT_CALIBRATION_START;
+uint32_t brightness_calibration_buffer[1 + (NUM_CAL_INCS + 1) + 1][2];
+uint32_t white_calibration_buffer[1 + (NUM_CAL_INCS + 1) + 1][2];
+uint32_t colour_calibration_buffer[1 + NUM_CAL_INCS + 1][2];
+
+static const char *const profile_names[NUM_PWM_PROFILES] = { "standard",
+		"fast", "12-bit", "16-bit" };
+
+/* TIM3 or TIM15 counts per period with BLANK low in PWM mode 1. */
+static uint32_t mode_1_lit(uint32_t compare, uint32_t length) {
+	return (compare >= length) ? 0 : length - compare;
+}
+
+/* TIM3 counts per period with BLANK low in PWM mode 2. */
+static uint32_t mode_2_lit(uint32_t compare, uint32_t length) {
+#ifdef PWM_BLUE_TRAILING
+	return (compare >= length) ? length : compare;
+#else
+	return mode_1_lit(compare, length);
+#endif /* PWM_BLUE_TRAILING */
+}
+
+/* Reads the lit counts of the current compare registers (R, G, B). */
+static void read_lit(uint32_t lit[3]) {
+	uint32_t length = (uint32_t) host_tim3.ARR + 1;
+	lit[0] = mode_1_lit(host_tim3.CCR3, length);
+	lit[1] = mode_1_lit(host_tim15.CCR1, length);
+	lit[2] = mode_2_lit(host_tim3.CCR1, length);
+}
+
+/* Commits pulse values and sums the lit counts over a dither cycle. */
+static void show_pulses(uint32_t pulse_values[3], uint32_t lit[3]) {
+	set_pulse_values(pulse_values);
+	lit[0] = lit[1] = lit[2] = 0;
+	for (int period = 0; period < DITHER_PERIODS; period++) {
+		uint32_t counts[3];
+		pwm_period_elapsed();
+		read_lit(counts);
+		for (int colour = 0; colour < 3; colour++) {
+			lit[colour] += counts[colour];
+		}
+	}
+}
+
+/**
+ * @brief Checks the shown on-time of Q8 pulse values.
+ *
+ * A pulse of 0 must be lit for the whole period and PWM_PULSE_OFF for none
+ * of it; anything between to within a count over the dither cycle.
+ */
+static void check_pulses(const char *what, uint32_t pulse_values[3]) {
+	uint32_t length = (uint32_t) COUNTER_PERIOD + 1;
+	uint32_t lit[3];
+	show_pulses(pulse_values, lit);
+
+	for (int colour = 0; colour < 3; colour++) {
+		uint32_t pulse = pulse_values[colour];
+		CHECK(pulse <= PULSE_TO_Q8(COUNTER_PERIOD)
+				|| pulse == PULSE_TO_Q8(PWM_PULSE_OFF),
+				"%s: colour %d pulse %u out of range (period %u)", what,
+				colour, pulse, COUNTER_PERIOD);
+
+		int64_t expected = (pulse >= PULSE_TO_Q8(PWM_PULSE_OFF)) ? 0 :
+				(int64_t) DITHER_PERIODS * length
+						- (((int64_t) pulse * DITHER_PERIODS)
+								>> PWM_FRACTION_BITS);
+		int64_t error = (int64_t) lit[colour] - expected;
+		uint8_t exact = (pulse == 0) || (expected == 0);
+		CHECK(exact ? (error == 0) : (llabs(error) <= 1),
+				"%s: colour %d pulse %u lit %u counts, expected %lld", what,
+				colour, pulse, lit[colour], (long long) expected);
+	}
+}
+
+static void check_colour_states(const char *profile) {
+	static const State states[] = { STANDBY, WHITE_LIGHT, RGB_LIGHT,
+			LED_CALIBRATION, POT_CALIBRATION };
+	static const uint16_t pots[] = { 0, 1, ADC_RES / 2, ADC_RES - 2,
+			ADC_RES - 1 };
+	char what[64];
+
+	for (unsigned s = 0; s < sizeof(states) / sizeof(states[0]); s++) {
+		current_state = states[s];
+		for (unsigned i = 0; i < sizeof(pots) / sizeof(pots[0]); i++) {
+			for (unsigned j = 0; j < sizeof(pots) / sizeof(pots[0]); j++) {
+				uint32_t pulse_values[3];
+				pot1_moving_average = pots[i];
+				pot2_moving_average = pots[j];
+				pot3_moving_average = pots[(i + j) % 5];
+				calculate_pulse_values(pulse_values);
+				snprintf(what, sizeof(what), "%s state %d pots %u/%u",
+						profile, states[s], pots[i], pots[j]);
+				check_pulses(what, pulse_values);
+			}
+		}
+	}
+}
+
+static void check_kelvin(const char *profile) {
+	uint32_t first = kelvin_table[0].kelvin;
+	uint32_t last = kelvin_table[KELVIN_TABLE_LENGTH - 1].kelvin;
+	char what[64];
+
+	for (uint32_t kelvin = first; kelvin <= last; kelvin += 37) {
+		KelvinToRGB lower;
+		KelvinToRGB higher;
+		uint16_t pulses[3];
+		uint16_t weight = search_rgb_to_kelvin(kelvin, &lower, &higher);
+		pulse_for_kelvin(weight, &lower, &higher, pulses);
+
+		uint32_t pulse_values[3] = { PULSE_TO_Q8(pulses[0]),
+				PULSE_TO_Q8(pulses[1]), PULSE_TO_Q8(pulses[2]) };
+		snprintf(what, sizeof(what), "%s %u K", profile, kelvin);
+		check_pulses(what, pulse_values);
+	}
+}
+
+/* Switching profile must keep full on, off and the duty of what is shown. */
+static void check_rescale(PwmProfileId from) {
+	static const uint32_t fractions[] = { 0, 1, 128, 255, 256 };
+
+	for (int to = 0; to < NUM_PWM_PROFILES; to++) {
+		for (unsigned f = 0; f < sizeof(fractions) / sizeof(fractions[0]);
+				f++) {
+			set_pwm_profile(from);
+			uint32_t old_length = (uint32_t) COUNTER_PERIOD + 1;
+			uint32_t pulse = (fractions[f] * COUNTER_PERIOD) >> 8;
+			uint32_t pulse_values[3] = { PULSE_TO_Q8(pulse),
+					PULSE_TO_Q8(PWM_PULSE_OFF), PULSE_TO_Q8(0) };
+			set_pulse_values(pulse_values);
+			pwm_period_elapsed();
+
+			uint32_t before[3];
+			uint32_t after[3];
+			read_lit(before);
+			set_pwm_profile(to);
+			read_lit(after);
+
+			uint32_t new_length = (uint32_t) COUNTER_PERIOD + 1;
+			CHECK(after[1] == 0, "%s to %s: off green lit %u counts",
+					profile_names[from], profile_names[to], after[1]);
+			CHECK(after[2] == new_length,
+					"%s to %s: full blue lit %u of %u counts",
+					profile_names[from], profile_names[to], after[2],
+					new_length);
+
+			/* Pulse values scale period to period (full scale to full scale). */
+			uint64_t old_pulse = old_length - before[0];
+			uint64_t expected = new_length
+					- (old_pulse * (new_length - 1) + (old_length - 1) / 2)
+							/ (old_length - 1);
+			CHECK(llabs((int64_t) after[0] - (int64_t) expected) <= 1,
+					"%s to %s: red lit %u counts, expected %llu",
+					profile_names[from], profile_names[to], after[0],
+					(unsigned long long) expected);
+
+			/* The Q8 path the framebuffer uses. */
+			uint32_t q8 = rescale_pulse_value(pulse_values[0],
+					pwm_profiles[from].period, pwm_profiles[to].period);
+			CHECK(q8 <= PULSE_TO_Q8(pwm_profiles[to].period),
+					"%s to %s: rescaled pulse %u above the period",
+					profile_names[from], profile_names[to], q8);
+			CHECK(rescale_pulse_value(PULSE_TO_Q8(PWM_PULSE_OFF),
+					pwm_profiles[from].period, pwm_profiles[to].period)
+					== PULSE_TO_Q8(PWM_PULSE_OFF),
+					"%s to %s: off not kept off", profile_names[from],
+					profile_names[to]);
+		}
+	}
+}
+
+int main(void) {
+	htim3.Instance = TIM3;
+	htim15.Instance = TIM15;
+	initialise_pwm_commit();
+	generate_white_table();
+	generate_gain_tables();
+
+	for (int profile = 0; profile < NUM_PWM_PROFILES; profile++) {
+		CHECK(pwm_profiles[profile].period <= PWM_MAX_PERIOD,
+				"%s profile period %u leaves no room for PWM_PULSE_OFF",
+				profile_names[profile], pwm_profiles[profile].period);
+		set_pwm_profile(profile);
+		check_colour_states(profile_names[profile]);
+		check_kelvin(profile_names[profile]);
+		check_rescale(profile);
+	}
+	return finish_test("test_pwm_profiles");
+}
@@ -0,0 +1,235 @@
+/**
+ *******************************************************************************
+ * @file test_shift_frame.c
+ * @brief Host check of the shift engine's encoded frames and SOUT decoding.
+ *
+ * Each frame is replayed into a pin trace the way TIM4 and the DMA channels
+ * play it out: per step the GPIOA word is written, SOUT is sampled, then the
+ * GPIOB word is written. The trace drives a model of the three driver chains
+ * (a shift register per chain that moves on each rising SCLK edge and latches
+ * on XLAT), and the samples are decoded with the engine's own functions.
+ *
+ * @author Erwin Bauernschmitt
+ * @date 16/10/2026
+ *******************************************************************************
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "main.h"
+#include "LED_shift_engine.h"
+
+#define MAX_BITS SHIFT_DOT_CORRECTION_BITS
+
+/**
+ * @brief Model of one driver chain's shift and latch registers.
+ *
+ * bits[0] is the bit SOUT presents, so it is the first one shifted out.
+ */
+typedef struct {
+	uint8_t bits[MAX_BITS];
+	uint8_t latched[MAX_BITS];
+	int length;
+} ChainModel;
+
+static const uint16_t sin_pins[3] = { SIN_R_Pin, SIN_G_Pin, SIN_B_Pin };
+static const uint16_t sout_pins[3] = { SOUT_R_Pin, SOUT_G_Pin, SOUT_B_Pin };
+static GPIO_TypeDef *const sin_ports[3] = { GPIOB, GPIOB, GPIOA };
+static GPIO_TypeDef *const sout_ports[3] = { GPIOA, GPIOB, GPIOB };
+
+/* Applies a BSRR word to a port's output state. */
+static void write_bsrr(GPIO_TypeDef *port, uint32_t bsrr) {
+	CHECK((bsrr & (bsrr >> 16) & 0xFFFF) == 0,
+			"BSRR word %08x both sets and resets a pin", bsrr);
+	port->ODR = (port->ODR & ~(bsrr >> 16)) | (bsrr & 0xFFFF);
+}
+
+static uint8_t pin(GPIO_TypeDef *port, uint16_t pin_mask) {
+	return (port->ODR & pin_mask) != 0;
+}
+
+/* Loads a chain with old contents, first bit out first. */
+static void load_chain(ChainModel *chain, const uint8_t *bits, int length) {
+	chain->length = length;
+	memcpy(chain->bits, bits, length);
+}
+
+/**
+ * @brief Plays a frame into the chain models, checking the pin sequence.
+ *
+ * @param frame: The encoded frame.
+ * @param chains: The three chain models.
+ * @param capture: Filled with the samples taken in each step.
+ * @param mode: The MODE level the frame should hold.
+ *
+ * @return None.
+ */
+static void play_frame(const ShiftFrame *frame, ChainModel chains[3],
+		ShiftCapture *capture, uint8_t mode) {
+	int length = SHIFT_FRAME_STEPS(frame->bits);
+	int latches = 0;
+
+	/* Start from the opposite MODE and junk on the data lines. */
+	GPIOA->ODR = SIN_B_Pin;
+	GPIOB->ODR = (mode ? 0 : MODE_Pin) | SIN_R_Pin | SCLK_Pin;
+
+	for (int step = 0; step < length; step++) {
+		uint8_t sclk = pin(GPIOB, SCLK_Pin);
+		uint8_t xlat = pin(GPIOB, XLAT_Pin);
+
+		write_bsrr(GPIOA, frame->port_a[step]);
+
+		/* CC2/CC3 sample SOUT mid-step. */
+		GPIOA->IDR = GPIOA->ODR;
+		GPIOB->IDR = GPIOB->ODR;
+		for (int c = 0; c < 3; c++) {
+			if (chains[c].bits[0]) {
+				sout_ports[c]->IDR |= sout_pins[c];
+			} else {
+				sout_ports[c]->IDR &= ~(uint32_t) sout_pins[c];
+			}
+		}
+		capture->port_a[step] = GPIOA->IDR;
+		capture->port_b[step] = GPIOB->IDR;
+
+		write_bsrr(GPIOB, frame->port_b[step]);
+
+		CHECK(pin(GPIOB, MODE_Pin) == mode, "MODE %u at step %d",
+				pin(GPIOB, MODE_Pin), step);
+
+		/* Expected shape: start, (data, SCLK) per bit, XLAT high, XLAT low. */
+		if (step == 0) {
+			CHECK(!pin(GPIOB, SCLK_Pin) && !pin(GPIOB, XLAT_Pin),
+					"SCLK/XLAT not low in the start step");
+		} else if (step < length - 2) {
+			int data_step = ((step - 1) % SHIFT_STEPS_PER_BIT) == 0;
+			CHECK(pin(GPIOB, SCLK_Pin) == !data_step, "SCLK wrong at step %d",
+					step);
+			CHECK(!pin(GPIOB, XLAT_Pin), "XLAT high at step %d", step);
+		} else if (step == length - 2) {
+			CHECK(!pin(GPIOB, SCLK_Pin) && pin(GPIOB, XLAT_Pin),
+					"XLAT pulse missing");
+		} else {
+			CHECK(!pin(GPIOB, SCLK_Pin) && !pin(GPIOB, XLAT_Pin),
+					"XLAT not returned low");
+		}
+
+		/* The data must be steady across the SCLK rising edge. */
+		if (!sclk && pin(GPIOB, SCLK_Pin)) {
+			CHECK(frame->port_a[step] == 0,
+					"SIN_B written in the SCLK step %d", step);
+			for (int c = 0; c < 3; c++) {
+				memmove(chains[c].bits, chains[c].bits + 1,
+						chains[c].length - 1);
+				chains[c].bits[chains[c].length - 1] = pin(sin_ports[c],
+						sin_pins[c]);
+			}
+		}
+		if (!xlat && pin(GPIOB, XLAT_Pin)) {
+			latches++;
+			for (int c = 0; c < 3; c++) {
+				memcpy(chains[c].latched, chains[c].bits, chains[c].length);
+			}
+		}
+	}
+	CHECK(latches == 1, "%d XLAT pulses in a frame", latches);
+}
+
+/* Splits a word into bits, MSB first. */
+static void word_bits(uint32_t word, int length, uint8_t *bits) {
+	for (int i = 0; i < length; i++) {
+		bits[i] = (word >> (length - 1 - i)) & 1;
+	}
+}
+
+/* Splits dot correction values into bits, OUT15 first, MSB first. */
+static void dot_correction_bits(uint8_t values[NUM_LEDS], uint8_t *bits) {
+	for (int led = NUM_LEDS - 1; led >= 0; led--) {
+		word_bits(values[led], DOT_CORRECTION_BITS,
+				bits + (NUM_LEDS - 1 - led) * DOT_CORRECTION_BITS);
+	}
+}
+
+static void test_on_off_frames(void) {
+	static ShiftFrame frame;
+	static ShiftCapture capture;
+	ChainModel chains[3];
+
+	for (int trial = 0; trial < 1000; trial++) {
+		uint16_t old_words[3];
+		uint16_t new_words[3];
+		for (int c = 0; c < 3; c++) {
+			uint8_t bits[SHIFT_BITS_PER_CHAIN];
+			old_words[c] = rand();
+			new_words[c] = (trial == 0) ? LED_MASK_ALL : rand();
+			word_bits(old_words[c], SHIFT_BITS_PER_CHAIN, bits);
+			load_chain(&chains[c], bits, SHIFT_BITS_PER_CHAIN);
+		}
+
+		encode_shift_frame(new_words[0], new_words[1], new_words[2], &frame);
+		CHECK(frame.bits == SHIFT_BITS_PER_CHAIN, "frame.bits %u", frame.bits);
+		CHECK(SHIFT_FRAME_STEPS(frame.bits) == SHIFT_FRAME_LENGTH,
+				"on/off frame length");
+		play_frame(&frame, chains, &capture, 0);
+
+		uint16_t readback[3];
+		decode_shift_capture(&capture, readback);
+		for (int c = 0; c < 3; c++) {
+			uint8_t bits[SHIFT_BITS_PER_CHAIN];
+			word_bits(new_words[c], SHIFT_BITS_PER_CHAIN, bits);
+			CHECK(memcmp(chains[c].latched, bits, SHIFT_BITS_PER_CHAIN) == 0,
+					"chain %d latched the wrong word (sent %04x)", c,
+					new_words[c]);
+			CHECK(readback[c] == old_words[c],
+					"chain %d read back %04x, held %04x", c, readback[c],
+					old_words[c]);
+		}
+	}
+}
+
+static void test_dot_correction_frames(void) {
+	static ShiftFrame frame;
+	static ShiftCapture capture;
+	ChainModel chains[3];
+
+	for (int trial = 0; trial < 100; trial++) {
+		uint8_t old_values[3][NUM_LEDS];
+		uint8_t new_values[3][NUM_LEDS];
+		for (int c = 0; c < 3; c++) {
+			uint8_t bits[SHIFT_DOT_CORRECTION_BITS];
+			for (int led = 0; led < NUM_LEDS; led++) {
+				old_values[c][led] = rand() & DOT_CORRECTION_MAX;
+				new_values[c][led] = rand() & DOT_CORRECTION_MAX;
+			}
+			dot_correction_bits(old_values[c], bits);
+			load_chain(&chains[c], bits, SHIFT_DOT_CORRECTION_BITS);
+		}
+
+		encode_dot_correction_frame(new_values, &frame);
+		CHECK(frame.bits == SHIFT_DOT_CORRECTION_BITS, "frame.bits %u",
+				frame.bits);
+		CHECK(SHIFT_FRAME_STEPS(frame.bits) <= SHIFT_MAX_FRAME_LENGTH,
+				"dot correction frame overruns the buffers");
+		play_frame(&frame, chains, &capture, 1);
+
+		uint8_t readback[3][NUM_LEDS];
+		decode_dot_correction_capture(&capture, readback);
+		for (int c = 0; c < 3; c++) {
+			uint8_t bits[SHIFT_DOT_CORRECTION_BITS];
+			dot_correction_bits(new_values[c], bits);
+			CHECK(memcmp(chains[c].latched, bits, SHIFT_DOT_CORRECTION_BITS)
+					== 0, "chain %d latched the wrong dot correction", c);
+			CHECK(memcmp(readback[c], old_values[c], NUM_LEDS) == 0,
+					"chain %d read back the wrong dot correction", c);
+		}
+	}
+}
+
+int main(void) {
+	srand(1);
+	test_on_off_frames();
+	test_dot_correction_frames();
+	return finish_test("test_shift_frame");
+}